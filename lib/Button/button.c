@@ -0,0 +1,48 @@
+// Interrupt driven input for the blue user button (PC13)
+
+#include "button.h"
+
+// Ring of edges with one producer (the EXTI interrupt, see exti.c) and one consumer (the game).
+// head is only written by the producer and tail only by the consumer, both count
+// up forever and are masked when used, so no locking is needed: the slot is filled
+// before head moves past it, and read before tail moves past it.
+static volatile ButtonEvent queue[BUTTON_QUEUE_SIZE];
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+static volatile uint32_t dropped = 0;
+
+// Purpose: Adds an edge to the ring, or counts it as dropped if the ring is full
+void ButtonPushEdge(uint32_t time, bool pressed){
+    uint32_t h = head;
+
+    if (h - tail >= BUTTON_QUEUE_SIZE){
+        dropped++;
+        return;
+    }
+    queue[h & (BUTTON_QUEUE_SIZE - 1)].time = time;
+    queue[h & (BUTTON_QUEUE_SIZE - 1)].pressed = pressed;
+    head = h + 1; // Publishes the slot
+}
+
+// Purpose: Takes the oldest edge out of the ring. Returns false if there is none
+bool ButtonGetEvent(ButtonEvent *event){
+    uint32_t t = tail;
+
+    if (t == head){
+        return false;
+    }
+    event->time = queue[t & (BUTTON_QUEUE_SIZE - 1)].time;
+    event->pressed = queue[t & (BUTTON_QUEUE_SIZE - 1)].pressed;
+    tail = t + 1; // Hands the slot back to the interrupt
+    return true;
+}
+
+// Purpose: Throws away the edges that have not been taken yet
+void ButtonFlush(void){
+    tail = head;
+}
+
+// Purpose: Returns how many edges were lost because the game did not take them in time
+uint32_t ButtonDropped(void){
+    return dropped;
+}
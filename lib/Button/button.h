@@ -0,0 +1,34 @@
+// Interrupt driven input for the blue user button (PC13)
+
+// Every edge of the button raises EXTI line 13. The interrupt reads a
+// free-running 1 MHz counter (TIM5) and pushes the edge, with its time in
+// microseconds, into a ring buffer. The game takes the edges out of the ring
+// whenever it is ready, so presses are timed exactly even while the CPU is
+// busy drawing, and nothing has to poll the pin.
+//
+// The ring (button.c) does not touch the hardware, the timer and the
+// interrupt are in exti.c, so on a host the edges can be fed in with
+// ButtonPushEdge() instead.
+
+#ifndef __BUTTON_H
+#define __BUTTON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of edges the ring can hold, must be a power of 2
+#define BUTTON_QUEUE_SIZE 32
+
+typedef struct {
+    uint32_t time; // microseconds, from ButtonNow()
+    bool pressed;  // true for the press (falling) edge, false for the release
+} ButtonEvent;
+
+void ButtonSetup(void); // Starts the microsecond timer and the edge interrupt
+uint32_t ButtonNow(void); // Current time in microseconds, wraps after about 71 minutes
+void ButtonPushEdge(uint32_t time, bool pressed); // Adds an edge to the ring (called from the interrupt)
+bool ButtonGetEvent(ButtonEvent *event); // Takes the oldest edge out of the ring, false if it is empty
+void ButtonFlush(void); // Throws away all edges that have not been taken yet
+uint32_t ButtonDropped(void); // How many edges were lost because the ring was full
+
+#endif
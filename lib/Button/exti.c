@@ -0,0 +1,48 @@
+// Button hardware: TIM5 as the microsecond clock and the EXTI interrupt of PC13, which feed the ring in button.c
+
+#include "button.h"
+#include "stm32f4xx_hal.h"
+
+// Purpose: Starts TIM5 as a 32 bit microsecond counter and enables the EXTI interrupt on PC13
+void ButtonSetup(void){
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint32_t clock = HAL_RCC_GetPCLK1Freq();
+
+    // Timers on APB1 run at twice PCLK1 whenever APB1 is divided
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1){
+        clock *= 2;
+    }
+
+    // TIM5 is one of the two 32 bit timers, so it only wraps after 2^32 us
+    __HAL_RCC_TIM5_CLK_ENABLE();
+    TIM5->CR1 = 0;
+    TIM5->PSC = clock / 1000000 - 1;
+    TIM5->ARR = 0xFFFFFFFF;
+    TIM5->CNT = 0;
+    TIM5->EGR = TIM_EGR_UG; // Loads the prescaler
+    TIM5->CR1 = TIM_CR1_CEN;
+
+    // The board has its own pull-up on the button, pressing pulls the pin low
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_13;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+    ButtonFlush();
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+// Purpose: Returns the current time in microseconds
+uint32_t ButtonNow(void){
+    return TIM5->CNT;
+}
+
+// Purpose: Called by HAL_GPIO_EXTI_IRQHandler for every edge on an EXTI line
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin){
+    if (GPIO_Pin == GPIO_PIN_13){
+        uint32_t now = TIM5->CNT; // Timestamp first, before anything else can delay it
+        ButtonPushEdge(now, HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13) == GPIO_PIN_RESET);
+    }
+}
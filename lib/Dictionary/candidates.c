@@ -0,0 +1,76 @@
+// Sets of dictionary words, as bitmaps in RAM
+
+#include "candidates.h"
+
+// Purpose: Starts the set with every word that has this many letters
+void CandAll(Candidates *candidates, uint8_t length){
+    candidates->count = 0;
+    for (int i = 0 ; i < DICT_SETS ; i++){
+        candidates->bits[i] = 0;
+    }
+    for (int i = 0 ; i < DICT_WORDS ; i++){
+        if (DictLength(i) == length){
+            candidates->bits[i / 32] |= 1UL << (i % 32);
+            candidates->count++;
+        }
+    }
+}
+
+// Purpose: Returns a mask of the places in word index that hold letter
+uint16_t CandPositions(uint32_t index, char letter){
+    uint32_t start = DictOffsets[index];
+    uint8_t length = DictLength(index);
+    uint16_t positions = 0;
+
+    for (int i = 0 ; i < length ; i++){
+        if (DictLetter(start + i) == letter){
+            positions |= 1U << i;
+        }
+    }
+    return positions;
+}
+
+// Purpose: Keeps the words that have letter at these positions and nowhere else. No positions keeps
+//          the words without the letter, which is only a mask. Otherwise the words without it go the
+//          same way, and the ones left are checked one by one
+void CandKeep(Candidates *candidates, char letter, uint16_t positions){
+    const uint32_t *has = DictLetterSets[letter - 'A'];
+    uint32_t bits, word;
+
+    candidates->count = 0;
+    for (int i = 0 ; i < DICT_SETS ; i++){
+        if (positions == 0){
+            candidates->bits[i] &= ~has[i];
+        }
+        else{
+            candidates->bits[i] &= has[i];
+            bits = candidates->bits[i];
+            while (bits != 0){
+                word = __builtin_ctz(bits);
+                bits &= bits - 1;
+                if (CandPositions(i * 32 + word, letter) != positions){
+                    candidates->bits[i] &= ~(1UL << word);
+                }
+            }
+        }
+        candidates->count += __builtin_popcount(candidates->bits[i]);
+    }
+}
+
+// Purpose: Takes one word out of the set
+void CandRemove(Candidates *candidates, uint32_t index){
+    if (CandHas(candidates, index)){
+        candidates->bits[index / 32] &= ~(1UL << (index % 32));
+        candidates->count--;
+    }
+}
+
+// Purpose: Returns the word with the lowest index in the set
+int CandFirst(const Candidates *candidates){
+    for (int i = 0 ; i < DICT_SETS ; i++){
+        if (candidates->bits[i] != 0){
+            return i * 32 + __builtin_ctz(candidates->bits[i]);
+        }
+    }
+    return -1;
+}
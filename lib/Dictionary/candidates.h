@@ -0,0 +1,28 @@
+// Sets of dictionary words, as bitmaps in RAM
+
+// A Candidates set has bit i of bits[i / 32] set if word i is in it. It starts
+// as every word of one length and is narrowed down by what is known about the
+// word: where a letter is, or that it is not there at all. Words without the
+// letter are dropped with DictLetterSets, 32 at a time, and only the words that
+// have it are looked at letter by letter.
+
+#ifndef __CANDIDATES_H
+#define __CANDIDATES_H
+
+#include <stdint.h>
+#include "dictionary.h"
+
+typedef struct {
+    uint32_t bits[DICT_SETS];
+    uint32_t count; // How many words are in the set
+} Candidates;
+
+void CandAll(Candidates *candidates, uint8_t length); // Every word of this length
+void CandKeep(Candidates *candidates, char letter, uint16_t positions); // Only the words that have letter at exactly these positions
+void CandRemove(Candidates *candidates, uint32_t index); // Drops one word
+uint16_t CandPositions(uint32_t index, char letter); // Where a word has the letter, bit 0 is its first letter
+int CandFirst(const Candidates *candidates); // The first word in the set, -1 if it is empty
+
+#define CandHas(candidates, index) (((candidates)->bits[(index) / 32] >> ((index) % 32)) & 1)
+
+#endif
@@ -0,0 +1,53 @@
+// Word dictionary as a DAWG, built into flash by tools/dictionary.py
+
+#include "dawg.h"
+
+// Purpose: Follows the edges from the root towards word index. At every node the edges whose words all
+//          come before it are skipped, the rest of the index is carried into the edge it falls in
+uint8_t DawgWord(uint32_t index, char *word){
+    uint32_t edge = 0; // Always the first edge of a node
+    uint8_t length = 0;
+
+    if (index >= DawgTotal){
+        return 0;
+    }
+    while (true){
+        while (index >= DawgCounts[edge]){
+            index -= DawgCounts[edge];
+            edge++;
+        }
+        word[length++] = DawgLetter(DawgEdges[edge]);
+
+        // The word that ends here comes before the longer ones through the same edge
+        if (DawgEdges[edge] & DAWG_END){
+            if (index == 0){
+                return length;
+            }
+            index--;
+        }
+        edge = DawgChild(DawgEdges[edge]);
+    }
+}
+
+// Purpose: Looks for every letter among the edges of the node the ones before it lead to
+bool DawgContains(const char *word, uint8_t length){
+    uint32_t edge = 0;
+
+    for (int i = 0 ; i < length ; i++){
+        // Nothing follows the letters so far
+        if (i > 0 && edge == 0){
+            return false;
+        }
+        while (DawgLetter(DawgEdges[edge]) != (uint8_t)word[i]){
+            if (DawgEdges[edge] & DAWG_LAST){
+                return false;
+            }
+            edge++;
+        }
+        if (i == length - 1){
+            return (DawgEdges[edge] & DAWG_END) != 0;
+        }
+        edge = DawgChild(DawgEdges[edge]);
+    }
+    return false;
+}
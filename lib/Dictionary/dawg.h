@@ -0,0 +1,51 @@
+// Word dictionary as a DAWG, built into flash by tools/dictionary.py
+
+// A DAWG is a trie of the words in which nodes with the same endings below them
+// are stored once, so large word lists share most of their letters. It is walked
+// where it is, in flash, without any RAM tables.
+//
+// Every node is a run of edges, sorted by letter, and each edge is one word:
+//   bits 0-4  letter, A = 1 ... Z = 26
+//   bit 5     a word ends with this letter
+//   bit 6     last edge of the node
+//   bits 7-31 first edge of the node it leads to, 0 if nothing follows
+// The root's edges start at 0. DawgCounts[e] is how many words go through edge e,
+// which lets DawgWord() skip whole branches on its way to a word, in 16 bits
+// when the list is short enough. The words are in alphabetical order, without
+// repeats.
+//
+// The game reads the flat tables of dictionary.h and nothing in src/ calls these,
+// so the DAWG is not linked into the firmware. test/test_dictionary measures the
+// two against each other.
+
+#ifndef __DAWG_H
+#define __DAWG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dictionary_words.h"
+
+#define DAWG_MAX_LENGTH 16 // Longest word tools/dictionary.py accepts
+
+#define DAWG_END 0x20
+#define DAWG_LAST 0x40
+#define DawgLetter(edge) ('A' - 1 + ((edge) & 0x1F))
+#define DawgChild(edge) ((edge) >> 7)
+
+#if DICT_WORDS < 0x10000
+typedef uint16_t DawgTally; // A number of words
+#else
+typedef uint32_t DawgTally;
+#endif
+
+extern const uint32_t DawgTotal;    // How many words there are
+extern const uint32_t DawgEdges[];  // The nodes, see above
+extern const DawgTally DawgCounts[]; // Words below each edge, its own included
+extern const uint32_t DawgLengths[DAWG_MAX_LENGTH + 1]; // How many words have each length
+
+uint8_t DawgWord(uint32_t index, char *word); // Spells out word index (no terminator added), returns its length or 0 if there is none
+bool DawgContains(const char *word, uint8_t length); // Whether the word, in upper case, is in the dictionary
+
+#define DawgCount(length) ((length) <= DAWG_MAX_LENGTH ? DawgLengths[length] : 0)
+
+#endif
@@ -0,0 +1,71 @@
+// Word dictionary, packed into flash by tools/dictionary.py
+
+#include "dictionary.h"
+
+// Purpose: Returns the letter that starts this many bits after from. Its 5 bits are at most spread over
+//          two bytes. pack() in tools/dictionary.py adds a spare byte at the end so the second one is always there
+static char DictUnpack(const uint8_t *from, uint32_t bit){
+    uint16_t pair = from[bit >> 3] | (from[(bit >> 3) + 1] << 8);
+
+    return 'A' - 1 + ((pair >> (bit & 7)) & 0x1F);
+}
+
+// Purpose: Returns the letter at this position of all the packed letters
+char DictLetter(uint32_t position){
+    return DictUnpack(DictLetters, position * DICT_BITS);
+}
+
+// Purpose: Points a view at word index
+WordView DictView(uint32_t index){
+    uint32_t bit = DictOffsets[index] * DICT_BITS;
+    WordView word = {&DictLetters[bit >> 3], bit & 7, DictLength(index)};
+
+    return word;
+}
+
+// Purpose: Returns letter i of a word, straight from where it is stored
+char WordLetter(WordView word, uint8_t i){
+    return DictUnpack(word.letters, word.shift + i * DICT_BITS);
+}
+
+// Purpose: Copies the letters of word index into word and returns how many there are
+uint8_t DictWord(uint32_t index, char *word){
+    uint32_t start = DictOffsets[index];
+    uint8_t length = DictOffsets[index + 1] - start;
+
+    for (int i = 0 ; i < length ; i++){
+        word[i] = DictLetter(start + i);
+    }
+    return length;
+}
+
+// Purpose: FNV-1a from a start that depends on the seed, with the bits mixed at the end so the
+//          last letters also change the low bits the modulo keeps. Must match tools/dictionary.py
+uint32_t DictHash(const char *word, uint8_t length, uint32_t seed){
+    uint32_t hash = 2166136261UL ^ seed;
+
+    for (int i = 0 ; i < length ; i++){
+        hash = (hash ^ (uint8_t)word[i]) * 16777619UL;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3BUL;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Purpose: Finds the only word the letters can be, then checks that it is them
+int DictFind(const char *word, uint8_t length){
+    DictSeed seed = DictSeeds[DictHash(word, length, 0) % DictBuckets];
+    uint32_t index = seed & DICT_DIRECT ? seed & ~DICT_DIRECT : DictHash(word, length, seed) % DictCount;
+    uint32_t start = DictOffsets[index];
+
+    if (DictLength(index) != length){
+        return -1;
+    }
+    for (int i = 0 ; i < length ; i++){
+        if (DictLetter(start + i) != word[i]){
+            return -1;
+        }
+    }
+    return index;
+}
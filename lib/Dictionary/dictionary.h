@@ -0,0 +1,62 @@
+// Word dictionary, packed into flash by tools/dictionary.py
+
+// The words of src/words.txt are stored one after the other with 5 bits per
+// letter (A = 1 ... Z = 26). DictOffsets[i] is where word i starts, in letters,
+// and DictOffsets[i + 1] where it ends, so any word is found without looking
+// at the ones before it. DictMasks[i] has bit n set if word i has letter 'A' + n.
+//
+// DictFind() goes the other way, from letters to an index, with a perfect hash:
+// DictHash(word, 0) picks one of DictBuckets buckets, and the bucket's seed hashes
+// the word to its slot, or is the slot itself when DICT_DIRECT is set in it.
+// tools/dictionary.py stores the words in the order of their slots, so the slot
+// is the index of the only word that can be there. That word is compared, so
+// anything else is never taken for it.
+//
+// DictLetterSets[n] is a bitmap of the words that have letter 'A' + n, bit i of
+// entry i / 32 for word i, so whole sets of words can be narrowed down at once.
+
+#ifndef __DICTIONARY_H
+#define __DICTIONARY_H
+
+#include <stdint.h>
+#include "dictionary_words.h"
+
+#define DICT_BITS 5 // Bits per letter
+#define DICT_MAX_LENGTH 16 // Longest word tools/dictionary.py accepts, so positions fit in 16 bits
+
+// A word where it is stored in flash, nothing is copied out: the byte its first
+// letter starts in, the bit of that byte, and how many letters it has
+typedef struct {
+    const uint8_t *letters;
+    uint8_t shift;
+    uint8_t length;
+} WordView;
+
+// A seed is 16 bits as long as every slot fits in the 15 bits below DICT_DIRECT, and 32 bits on longer lists
+#if DICT_WORDS <= 0x8000
+typedef uint16_t DictSeed;
+#define DICT_DIRECT 0x8000U
+#else
+typedef uint32_t DictSeed;
+#define DICT_DIRECT 0x80000000UL
+#endif
+
+extern const uint32_t DictCount;      // How many words there are
+extern const uint32_t DictBuckets;    // How many seeds there are
+extern const uint8_t DictLetters[];   // Every letter, the first one in the lowest bits
+extern const uint32_t DictOffsets[];  // Where each word starts, and one more for where the last one ends
+extern const uint32_t DictMasks[];    // The letters each word has
+extern const DictSeed DictSeeds[];    // The seed of each bucket, or DICT_DIRECT and its one word's index
+extern const uint32_t DictLetterSets[26][DICT_SETS]; // The words each letter is in
+
+char DictLetter(uint32_t position); // The letter at this position of the packed letters
+WordView DictView(uint32_t index); // Where word index is stored
+char WordLetter(WordView word, uint8_t i); // Letter i of the word, upper case
+uint8_t DictWord(uint32_t index, char *word); // Unpacks a word (no terminator added), returns its length
+uint32_t DictHash(const char *word, uint8_t length, uint32_t seed); // The hash tools/dictionary.py placed the words with
+int DictFind(const char *word, uint8_t length); // The index of the word, in upper case, or -1 if it is not in the dictionary
+
+#define DictLength(index) (DictOffsets[(index) + 1] - DictOffsets[index])
+#define DictMask(index) (DictMasks[index])
+
+#endif
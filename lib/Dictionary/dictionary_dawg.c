@@ -0,0 +1,26 @@
+// Generated by tools/dictionary.py from src/words.txt, do not edit
+
+#include "dawg.h"
+
+// 5 words, 28 nodes, 32 edges: 264 bytes of flash
+
+const uint32_t DawgTotal = 5;
+
+const uint32_t DawgEdges[] = {
+    0x0000020B, 0x0000028C, 0x0000030E, 0x000003D0, 0x000004CE, 0x00000541,
+    0x000005D5, 0x00000608, 0x000006D2, 0x00000749, 0x000007D0, 0x00000843,
+    0x000008D9, 0x0000094F, 0x000009C6, 0x00000A54, 0x00000ACC, 0x00000B53,
+    0x00000BC6, 0x00000065, 0x00000C4F, 0x00000CC5, 0x00000D49, 0x00000DC5,
+    0x00000070, 0x0000006F, 0x00000E43, 0x00000ED3, 0x00000073, 0x00000F53,
+    0x00000FCF, 0x00000072,
+};
+
+const DawgTally DawgCounts[] = {
+    1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1,
+};
+
+const uint32_t DawgLengths[] = {
+    0, 0, 0, 0, 0, 1, 2, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+};
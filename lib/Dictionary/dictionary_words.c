@@ -0,0 +1,54 @@
+// Generated by tools/dictionary.py from src/words.txt, do not edit
+
+#include "dictionary.h"
+
+// 5 words, 33 letters: 174 bytes of flash (22 letters, 24 offsets, 20 masks, 4 hash, 104 letter sets)
+
+const uint32_t DictCount = 5;
+const uint32_t DictBuckets = 2;
+
+const uint8_t DictLetters[] = {
+    0x10, 0xE5, 0x99, 0xC6, 0x74, 0x75, 0xB0, 0xF2, 0x58, 0x80, 0xF4, 0xC1, 0xE5, 0x92, 0x29, 0x50,
+    0x3E, 0x53, 0xE6, 0x7C, 0x12, 0x00,
+};
+
+const uint32_t DictOffsets[] = {
+    0, 7, 13, 19, 24, 33,
+};
+
+const uint32_t DictMasks[] = {
+    0x1048184, 0x0106814, 0x008C801, 0x0002530, 0x006C030,
+};
+
+const DictSeed DictSeeds[] = {
+    0x1, 0x1,
+};
+
+const uint32_t DictLetterSets[26][DICT_SETS] = {
+    {0x00000004}, // A
+    {0x00000000}, // B
+    {0x00000003}, // C
+    {0x00000000}, // D
+    {0x0000001A}, // E
+    {0x00000018}, // F
+    {0x00000000}, // G
+    {0x00000001}, // H
+    {0x00000009}, // I
+    {0x00000000}, // J
+    {0x00000008}, // K
+    {0x00000006}, // L
+    {0x00000000}, // M
+    {0x0000000A}, // N
+    {0x00000016}, // O
+    {0x00000015}, // P
+    {0x00000000}, // Q
+    {0x00000010}, // R
+    {0x00000011}, // S
+    {0x00000004}, // T
+    {0x00000002}, // U
+    {0x00000000}, // V
+    {0x00000000}, // W
+    {0x00000000}, // X
+    {0x00000001}, // Y
+    {0x00000000}, // Z
+};
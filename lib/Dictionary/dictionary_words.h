@@ -0,0 +1,11 @@
+// Generated by tools/dictionary.py from src/words.txt, do not edit
+
+#ifndef __DICTIONARY_WORDS_H
+#define __DICTIONARY_WORDS_H
+
+#ifndef DICT_WORDS
+#define DICT_WORDS 5 // How many words there are
+#define DICT_SETS 1 // 32-bit words in a bitmap of all of them
+#endif
+
+#endif
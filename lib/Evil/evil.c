@@ -0,0 +1,54 @@
+// Evil hangman: the station never picks a word, it only keeps the words that fit
+
+#include "evil.h"
+
+// Purpose: Counts the words of every family and keeps the biggest one. Ties go to the family without
+//          the letter, then to the one that shows it in the fewest places, then to the lowest positions,
+//          so the same guesses always leave the same words
+uint16_t EvilGuess(Candidates *candidates, char letter){
+    static uint16_t patterns[EVIL_FAMILIES]; // The positions each family has the letter at, in a hash table
+    static uint32_t counts[EVIL_FAMILIES];   // How many words each family has, 0 for a free entry
+    const uint32_t *has = DictLetterSets[letter - 'A'];
+    uint16_t best = 0; // No positions is the family without the letter
+    uint32_t bestCount = 0;
+    uint32_t bits;
+    uint16_t pattern;
+    int slot, probes;
+
+    for (int i = 0 ; i < EVIL_FAMILIES ; i++){
+        counts[i] = 0;
+    }
+
+    for (int i = 0 ; i < DICT_SETS ; i++){
+        bestCount += __builtin_popcount(candidates->bits[i] & ~has[i]);
+        bits = candidates->bits[i] & has[i];
+        while (bits != 0){
+            pattern = CandPositions(i * 32 + __builtin_ctz(bits), letter);
+            bits &= bits - 1;
+
+            // Linear probing from the low bits of the positions
+            slot = pattern & (EVIL_FAMILIES - 1);
+            for (probes = 0 ; probes < EVIL_FAMILIES && counts[slot] != 0 && patterns[slot] != pattern ; probes++){
+                slot = (slot + 1) & (EVIL_FAMILIES - 1);
+            }
+            if (probes < EVIL_FAMILIES){
+                patterns[slot] = pattern;
+                counts[slot]++;
+            }
+        }
+    }
+
+    for (int i = 0 ; i < EVIL_FAMILIES ; i++){
+        if (counts[i] == 0 || counts[i] < bestCount){
+            continue;
+        }
+        if (counts[i] > bestCount || (best != 0 && (__builtin_popcount(patterns[i]) < __builtin_popcount(best)
+                || (__builtin_popcount(patterns[i]) == __builtin_popcount(best) && patterns[i] < best)))){
+            best = patterns[i];
+            bestCount = counts[i];
+        }
+    }
+
+    CandKeep(candidates, letter, best);
+    return best;
+}
@@ -0,0 +1,21 @@
+// Evil hangman: the station never picks a word, it only keeps the words that fit
+
+// On every guess the candidate words are split into families by where they have
+// the guessed letter, and only the biggest family is kept, so the guess reveals
+// as little as possible. The words without the letter are one family, counted
+// with the letter's bitmap 32 words at a time. Only the words that have it are
+// looked at one by one, and each guess only goes over the words still left.
+
+#ifndef __EVIL_H
+#define __EVIL_H
+
+#include <stdint.h>
+#include "candidates.h"
+
+// Families one guess can have that are told apart, a power of 2. More than this is
+// unheard of for real words, the words of any further family are never kept
+#define EVIL_FAMILIES 128
+
+uint16_t EvilGuess(Candidates *candidates, char letter); // Keeps the biggest family, returns where its words have the letter
+
+#endif
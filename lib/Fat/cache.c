@@ -0,0 +1,49 @@
+// Block cache: the last few 512 byte blocks read from a card, so reading them again is free
+
+#include <stddef.h>
+#include "cache.h"
+
+// Purpose: Starts with no blocks
+void CacheInit(Cache *cache, CacheRead read){
+    cache->read = read;
+    cache->hits = 0;
+    cache->misses = 0;
+    CacheFlush(cache);
+}
+
+// Purpose: Forgets every block
+void CacheFlush(Cache *cache){
+    for (int i = 0 ; i < CACHE_LINES ; i++){
+        cache->tag[i] = CACHE_NONE;
+        cache->used[i] = 0;
+    }
+    cache->clock = 0;
+}
+
+// Purpose: Returns the data of a block, reading it into the line used longest ago if it is not there.
+//          The pointer stays good until CACHE_LINES other blocks have been asked for
+const uint8_t *CacheGet(Cache *cache, uint32_t block){
+    int oldest = 0;
+
+    cache->clock++;
+    for (int i = 0 ; i < CACHE_LINES ; i++){
+        if (cache->tag[i] == block){
+            cache->used[i] = cache->clock;
+            cache->hits++;
+            return cache->data[i];
+        }
+        if (cache->used[i] < cache->used[oldest]){
+            oldest = i;
+        }
+    }
+
+    cache->misses++;
+    if (!cache->read(block, cache->data[oldest])){
+        cache->tag[oldest] = CACHE_NONE; // Whatever was read is not the block
+        cache->used[oldest] = 0;
+        return NULL;
+    }
+    cache->tag[oldest] = block;
+    cache->used[oldest] = cache->clock;
+    return cache->data[oldest];
+}
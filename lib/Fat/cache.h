@@ -0,0 +1,35 @@
+// Block cache: the last few 512 byte blocks read from a card, so reading them again is free
+
+// A FAT volume keeps going back to the same blocks: the FAT itself, the
+// directory, and the block a file is being read from, a few bytes at a time.
+// The cache keeps CACHE_LINES of them in RAM and throws out the one used
+// longest ago when another is needed. Blocks are read through a function, so
+// the card can just as well be a disk image on a host.
+
+#ifndef __CACHE_H
+#define __CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CACHE_BLOCK 512 // Bytes per block, what SD cards and FAT use
+#define CACHE_LINES 4   // Blocks kept, CACHE_BLOCK bytes of RAM each
+#define CACHE_NONE 0xFFFFFFFFUL // Tag of a line that holds no block
+
+typedef bool (*CacheRead)(uint32_t block, uint8_t *data); // Reads one block, false if it could not
+
+typedef struct {
+    CacheRead read;
+    uint32_t tag[CACHE_LINES];  // The block each line holds
+    uint32_t used[CACHE_LINES]; // When each line was last used, in calls to CacheGet()
+    uint32_t clock;
+    uint32_t hits;              // Blocks found in the cache, and blocks that had to be read
+    uint32_t misses;
+    uint8_t data[CACHE_LINES][CACHE_BLOCK];
+} Cache;
+
+void CacheInit(Cache *cache, CacheRead read); // Starts empty, reading blocks with read
+const uint8_t *CacheGet(Cache *cache, uint32_t block); // The block's data, NULL if it could not be read
+void CacheFlush(Cache *cache); // Forgets every block, e.g. when the card was changed
+
+#endif
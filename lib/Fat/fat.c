@@ -0,0 +1,237 @@
+// FAT reader: finds a file in the root directory of a FAT16 or FAT32 card and reads it, nothing is ever written
+
+#include <string.h>
+#include "fat.h"
+
+#define FAT_ENTRY 32 // Bytes per directory entry
+#define FAT_ATTR_LONG_NAME 0x0F
+#define FAT_ATTR_VOLUME 0x08
+#define FAT_ATTR_DIRECTORY 0x10
+
+// Purpose: Reads little endian numbers out of a block
+static uint16_t FatGet16(const uint8_t *data){
+    return data[0] | data[1] << 8;
+}
+
+static uint32_t FatGet32(const uint8_t *data){
+    return data[0] | data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+// Purpose: Returns whether a block is a FAT boot sector with 512 byte sectors. It starts with a jump
+//          instruction, which an MBR does not
+static bool FatIsBoot(const uint8_t *block){
+    return (block[0] == 0xEB || block[0] == 0xE9) && FatGet16(block + 11) == CACHE_BLOCK && block[13] != 0
+        && FatGet16(block + 510) == 0xAA55;
+}
+
+// Purpose: Reads the boot sector of the volume, where the card or its first partition starts
+bool FatMount(Fat *fat, Cache *cache){
+    const uint8_t *block = CacheGet(cache, 0);
+    uint32_t start = 0;
+
+    fat->cache = cache;
+    if (block == NULL || FatGet16(block + 510) != 0xAA55){
+        return false;
+    }
+    if (!FatIsBoot(block)){
+        start = FatGet32(block + 446 + 8); // First partition entry, its first block
+        block = CacheGet(cache, start);
+        if (block == NULL || !FatIsBoot(block)){
+            return false;
+        }
+    }
+
+    uint32_t fatBlocks = FatGet16(block + 22) != 0 ? FatGet16(block + 22) : FatGet32(block + 36);
+    uint32_t total = FatGet16(block + 19) != 0 ? FatGet16(block + 19) : FatGet32(block + 32);
+    uint16_t rootEntries = FatGet16(block + 17);
+
+    fat->clusterBlocks = block[13];
+    fat->fatStart = start + FatGet16(block + 14);
+    fat->rootBlocks = (rootEntries * FAT_ENTRY + CACHE_BLOCK - 1) / CACHE_BLOCK;
+    fat->rootStart = fat->fatStart + block[16] * fatBlocks;
+    fat->dataStart = fat->rootStart + fat->rootBlocks;
+    fat->clusters = (start + total - fat->dataStart) / fat->clusterBlocks;
+
+    // The number of clusters is what tells the FAT types apart, FAT12 is only on floppies
+    if (fat->clusters < 4085){
+        return false;
+    }
+    if (fat->clusters < 65525){
+        fat->type = 16;
+    }
+    else{
+        fat->type = 32;
+        fat->rootStart = FatGet32(block + 44);
+    }
+    return true;
+}
+
+// Purpose: Returns the cluster after this one, or 0 at the end of the chain or if the FAT could not be read
+static uint32_t FatNext(const Fat *fat, uint32_t cluster){
+    uint32_t offset = cluster * (fat->type / 8);
+    const uint8_t *block = CacheGet(fat->cache, fat->fatStart + offset / CACHE_BLOCK);
+    uint32_t next;
+
+    if (block == NULL){
+        return 0;
+    }
+    if (fat->type == 16){
+        next = FatGet16(block + offset % CACHE_BLOCK);
+    }
+    else{
+        next = FatGet32(block + offset % CACHE_BLOCK) & 0x0FFFFFFFUL; // The top 4 bits are reserved
+    }
+
+    // Free, reserved, bad and end of chain all mean there is no next cluster
+    if (next < 2 || next >= fat->clusters + 2){
+        return 0;
+    }
+    return next;
+}
+
+// Purpose: Returns the block that is this many blocks into a cluster
+static uint32_t FatBlock(const Fat *fat, uint32_t cluster, uint32_t block){
+    return fat->dataStart + (cluster - 2) * fat->clusterBlocks + block;
+}
+
+// Purpose: Turns "WORDS.TXT" into the 11 characters a directory entry has, "WORDS   TXT"
+static void FatShortName(const char *name, char shortName[11]){
+    int i = 0;
+
+    memset(shortName, ' ', 11);
+    for ( ; *name != 0 && *name != '.' && i < 8 ; name++){
+        shortName[i++] = *name >= 'a' && *name <= 'z' ? *name - ('a' - 'A') : *name;
+    }
+    while (*name != 0 && *name != '.'){
+        name++;
+    }
+    if (*name == '.'){
+        name++;
+    }
+    for (i = 8 ; *name != 0 && i < 11 ; name++){
+        shortName[i++] = *name >= 'a' && *name <= 'z' ? *name - ('a' - 'A') : *name;
+    }
+}
+
+// Purpose: Looks through one block of the root directory. Returns 1 if the file is found, -1 if the
+//          directory ends in this block, and 0 if the search goes on in the next one
+static int FatFind(const uint8_t *block, const char shortName[11], FatFile *file){
+    for (int i = 0 ; i < CACHE_BLOCK ; i += FAT_ENTRY){
+        const uint8_t *entry = block + i;
+        uint8_t attributes = entry[11];
+
+        if (entry[0] == 0){
+            return -1;
+        }
+        if (entry[0] == 0xE5 || attributes == FAT_ATTR_LONG_NAME || (attributes & (FAT_ATTR_VOLUME | FAT_ATTR_DIRECTORY))){
+            continue;
+        }
+        if (memcmp(entry, shortName, 11) == 0){
+            file->first = (uint32_t)FatGet16(entry + 20) << 16 | FatGet16(entry + 26);
+            file->size = FatGet32(entry + 28);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Purpose: Finds a file in the root directory and opens it at its start. On FAT16 the root directory
+//          is a fixed run of blocks, on FAT32 it is a chain of clusters like any file
+bool FatOpen(Fat *fat, FatFile *file, const char *name){
+    char shortName[11];
+    const uint8_t *block;
+    int found = 0;
+
+    FatShortName(name, shortName);
+    file->fat = fat;
+    if (fat->type == 16){
+        for (uint32_t i = 0 ; i < fat->rootBlocks && found == 0 ; i++){
+            block = CacheGet(fat->cache, fat->rootStart + i);
+            if (block == NULL){
+                return false;
+            }
+            found = FatFind(block, shortName, file);
+        }
+    }
+    else{
+        for (uint32_t cluster = fat->rootStart ; cluster != 0 && found == 0 ; cluster = FatNext(fat, cluster)){
+            for (uint32_t i = 0 ; i < fat->clusterBlocks && found == 0 ; i++){
+                block = CacheGet(fat->cache, FatBlock(fat, cluster, i));
+                if (block == NULL){
+                    return false;
+                }
+                found = FatFind(block, shortName, file);
+            }
+        }
+    }
+    if (found != 1){
+        return false;
+    }
+    file->position = 0;
+    file->cluster = file->first;
+    file->clusterStart = 0;
+    return true;
+}
+
+// Purpose: Moves to a byte of the file. The FAT only links forwards, so going back starts again from the first cluster
+bool FatSeek(FatFile *file, uint32_t position){
+    uint32_t clusterBytes = (uint32_t)file->fat->clusterBlocks * CACHE_BLOCK;
+
+    if (position > file->size){
+        position = file->size;
+    }
+    if (position < file->clusterStart){
+        file->cluster = file->first;
+        file->clusterStart = 0;
+    }
+
+    // A position right at the end of the last cluster has no cluster after it, it is left for FatRead() to find
+    while (position >= file->clusterStart + clusterBytes && position < file->size){
+        file->cluster = FatNext(file->fat, file->cluster);
+        if (file->cluster == 0){
+            return false;
+        }
+        file->clusterStart += clusterBytes;
+    }
+    file->position = position;
+    return true;
+}
+
+// Purpose: Moves to a byte of the file from a cluster of it that FatCluster() gave earlier, so going back
+//          does not walk the FAT from the first cluster again
+bool FatSeekFrom(FatFile *file, uint32_t position, uint32_t cluster, uint32_t clusterStart){
+    if (clusterStart > position){
+        return FatSeek(file, position);
+    }
+    file->cluster = cluster;
+    file->clusterStart = clusterStart;
+    return FatSeek(file, position);
+}
+
+// Purpose: Copies bytes of the file out of the cached blocks, from one block at a time
+int FatRead(FatFile *file, uint8_t *data, int length){
+    int done = 0;
+
+    while (done < length && file->position < file->size){
+        if (!FatSeek(file, file->position)){
+            return -1;
+        }
+        uint32_t offset = file->position - file->clusterStart;
+        const uint8_t *block = CacheGet(file->fat->cache, FatBlock(file->fat, file->cluster, offset / CACHE_BLOCK));
+        uint32_t count = CACHE_BLOCK - offset % CACHE_BLOCK;
+
+        if (block == NULL){
+            return -1;
+        }
+        if (count > (uint32_t)(length - done)){
+            count = length - done;
+        }
+        if (count > file->size - file->position){
+            count = file->size - file->position;
+        }
+        memcpy(data + done, block + offset % CACHE_BLOCK, count);
+        done += count;
+        file->position += count;
+    }
+    return done;
+}
@@ -0,0 +1,48 @@
+// FAT reader: finds a file in the root directory of a FAT16 or FAT32 card and reads it, nothing is ever written
+
+// A card is either partitioned (the first partition of the MBR is used) or
+// formatted as a whole. From the boot sector come where the FAT, the root
+// directory and the clusters start; a file is its first cluster, and the FAT
+// says which cluster follows each one. Only short (8.3) names in the root
+// directory are looked at, which is all a word pack needs. Every block goes
+// through the cache, so walking the FAT costs a read only once per block of it.
+
+#ifndef __FAT_H
+#define __FAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cache.h"
+
+typedef struct {
+    Cache *cache;
+    uint8_t type;          // 16 or 32
+    uint8_t clusterBlocks; // Blocks per cluster
+    uint32_t fatStart;     // First block of the first FAT
+    uint32_t rootStart;    // FAT16: first block of the root directory, FAT32: its first cluster
+    uint32_t rootBlocks;   // FAT16: blocks of the root directory
+    uint32_t dataStart;    // Block of cluster 2, the first one
+    uint32_t clusters;     // Clusters on the volume, from 2 on
+} Fat;
+
+typedef struct {
+    Fat *fat;
+    uint32_t first;        // First cluster, 0 for an empty file
+    uint32_t size;         // Bytes in the file
+    uint32_t position;     // The next byte FatRead() gives
+    uint32_t cluster;      // The cluster position is in
+    uint32_t clusterStart; // Where in the file that cluster starts
+} FatFile;
+
+bool FatMount(Fat *fat, Cache *cache); // Finds the volume on the card, false if it is not FAT16 or FAT32
+bool FatOpen(Fat *fat, FatFile *file, const char *name); // Opens a file of the root directory by its 8.3 name, e.g. "WORDS.TXT"
+int FatRead(FatFile *file, uint8_t *data, int length); // Reads up to length bytes, returns how many, 0 at the end and -1 if the card failed
+bool FatSeek(FatFile *file, uint32_t position); // Moves to a byte of the file, false if the chain of clusters is broken
+bool FatSeekFrom(FatFile *file, uint32_t position, uint32_t cluster, uint32_t clusterStart); // FatSeek() from a cluster known to start at or before position
+
+#define FatSize(file) ((file)->size)
+#define FatTell(file) ((file)->position)
+#define FatCluster(file) ((file)->cluster)           // Kept with a position to go back to it with FatSeekFrom()
+#define FatClusterStart(file) ((file)->clusterStart)
+
+#endif
@@ -0,0 +1,89 @@
+// Hangman game engine: the state of one game and the rules, without any display or input
+
+#include "game.h"
+
+// Purpose: Starts a game with this many lives. GameWord() gives it its first word
+void GameStart(Game *game, uint8_t lives){
+    game->word.length = 0;
+    game->letters = 0;
+    game->guessed = 0;
+    game->lives = lives;
+}
+
+// Purpose: Returns the mask of the letters in a word
+uint32_t GameMask(WordView word){
+    uint32_t letters = 0;
+
+    for (int i = 0 ; i < word.length ; i++){
+        letters |= GameBit(WordLetter(word, i));
+    }
+    return letters;
+}
+
+// Purpose: Sets the next word to guess and forgets the guesses of the last one. The lives stay.
+//          letters is the word's mask, from GameMask() or stored with the word
+void GameWord(Game *game, WordView word, uint32_t letters){
+    game->word = word;
+    game->letters = letters;
+    game->guessed = 0;
+}
+
+// Purpose: Replaces the word with one of the same length, keeping the guesses and lives. For a station that
+//          has not settled on a word, the new one must have the guessed letters in the same places
+void GameSwap(Game *game, WordView word, uint32_t letters){
+    game->word = word;
+    game->letters = letters;
+}
+
+// Purpose: Takes one guess. Lower case counts as upper case, anything else that is not a letter
+//          costs a life like a wrong letter does
+GameResult GameGuess(Game *game, char letter){
+    uint32_t bit;
+
+    if (letter >= 'a' && letter <= 'z'){
+        letter -= 'a' - 'A';
+    }
+    if (letter < 'A' || letter > 'Z'){
+        game->lives--;
+        return GAME_INVALID;
+    }
+
+    bit = GameBit(letter);
+    if (game->guessed & bit){
+        return GAME_REPEAT;
+    }
+    game->guessed |= bit;
+    if (game->letters & bit){
+        return GAME_HIT;
+    }
+    game->lives--;
+    return GAME_MISS;
+}
+
+// Purpose: Returns a mask of the places in the word that hold letter, which is upper case
+uint16_t GamePositions(const Game *game, char letter){
+    uint16_t positions = 0;
+
+    for (int i = 0 ; i < game->word.length ; i++){
+        if (WordLetter(game->word, i) == letter){
+            positions |= 1U << i;
+        }
+    }
+    return positions;
+}
+
+// Purpose: Takes a guess of the whole word. The right word reveals every letter, any other costs a life.
+//          Checking that the guess is a word at all is left to the caller
+GameResult GameGuessWord(Game *game, const char *word, uint8_t length){
+    bool same = length == game->word.length;
+
+    for (int i = 0 ; same && i < length ; i++){
+        same = word[i] == WordLetter(game->word, i);
+    }
+    if (same){
+        game->guessed |= game->letters;
+        return GAME_HIT;
+    }
+    game->lives--;
+    return GAME_MISS;
+}
@@ -0,0 +1,52 @@
+// Hangman game engine: the state of one game and the rules, without any display or input
+
+// Letters are kept as 26-bit masks (bit 0 is A), so the word and the guesses are
+// compared a whole alphabet at a time: a guess, and whether the word is won, are a
+// few bit operations however long the word is. The word's own mask is worked out
+// once when it is set, or comes precomputed with the word. The word itself is
+// not copied, the game reads it from the dictionary through a view.
+
+#ifndef __GAME_H
+#define __GAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dictionary.h"
+
+#define GAME_LIVES 7 // Lives a game starts with, unless the station was set to another number
+#define GAME_MAX_LENGTH DICT_MAX_LENGTH // Longest word there can be
+#define GAME_ALL ((1UL << 26) - 1) // Every letter
+
+// The bit of an upper case letter
+#define GameBit(letter) (1UL << ((letter) - 'A'))
+
+typedef enum {
+    GAME_INVALID, // not a letter, it costs a life
+    GAME_REPEAT,  // guessed before, nothing changes
+    GAME_HIT,     // in the word, its places are revealed
+    GAME_MISS     // not in the word, it costs a life
+} GameResult;
+
+typedef struct {
+    WordView word;    // The word being guessed, where it is stored
+    uint32_t letters; // Letters in the word
+    uint32_t guessed; // Letters guessed this word
+    uint8_t lives;    // Lives left, they carry over from word to word
+} Game;
+
+void GameStart(Game *game, uint8_t lives); // These lives and no word yet
+uint32_t GameMask(WordView word); // The letters of a word as a mask
+void GameWord(Game *game, WordView word, uint32_t letters); // Sets the next word, with its mask
+void GameSwap(Game *game, WordView word, uint32_t letters); // Changes the word for another one that fits the guesses so far
+GameResult GameGuess(Game *game, char letter); // Takes one guess, in either case
+uint16_t GamePositions(const Game *game, char letter); // Where the word has the letter, bit 0 is its first letter
+GameResult GameGuessWord(Game *game, const char *word, uint8_t length); // Takes a guess of the whole word, in upper case
+
+#define GameLength(game) ((game)->word.length)
+#define GameLetter(game, i) WordLetter((game)->word, i)
+#define GameGuessed(game, letter) (((game)->guessed & GameBit(letter)) != 0)
+#define GameRevealed(game, i) GameGuessed(game, GameLetter(game, i))
+#define GameWon(game) (((game)->letters & ~(game)->guessed) == 0)
+#define GameLost(game) ((game)->lives == 0)
+
+#endif
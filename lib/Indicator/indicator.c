@@ -0,0 +1,72 @@
+// Live press indicator: what the press being held would enter, and how close it is to the next one
+
+#include "indicator.h"
+#include "fonts.h"
+#include "st7789 drivers.h"
+
+// Purpose: Starts with no digit and no bar on screen
+void IndicatorInit(Indicator *indicator){
+    indicator->shown = PRESS_NONE;
+    indicator->bar = 0;
+}
+
+// Purpose: Shows red 0 for holding less than oneAfter, green 1 for less than redoAfter, and blue D for a redo.
+//          The digit is only drawn when it changes. Under it the bar grows towards the next threshold,
+//          and only the part that grew is drawn. Nothing is drawn while the button is released
+void IndicatorShow(Indicator *indicator, const PressDecoder *decoder, uint32_t now, uint16_t x){
+    PressBit live; // What the press would be if it was released now
+    uint32_t held, from, to; // The time held, and the thresholds on both sides of it
+    int bar; // Length of the bar towards the next threshold
+    uint16_t color;
+
+    if (!PressIsDown(decoder)){
+        return;
+    }
+    held = PressHeld(decoder, now);
+    live = PressClassify(decoder, held);
+
+    if (live != indicator->shown){
+        if (live == PRESS_ZERO){
+            ST7789_WriteChar(x, INDICATOR_Y, '0', Font_11x18, RED, BLACK);
+        }
+        else if (live == PRESS_ONE){
+            ST7789_WriteChar(x, INDICATOR_Y, '1', Font_11x18, GREEN, BLACK);
+        }
+        else{
+            ST7789_WriteChar(x, INDICATOR_Y, 'D', Font_11x18, BLUE, BLACK);
+        }
+        // The bar starts over for the next threshold
+        IndicatorClear(indicator);
+        indicator->shown = live;
+    }
+
+    // Nothing comes after a redo
+    if (live == PRESS_REDO){
+        return;
+    }
+    if (live == PRESS_ZERO){
+        from = 0;
+        to = decoder->config.oneAfter;
+        color = GREEN;
+    }
+    else{
+        from = decoder->config.oneAfter;
+        to = decoder->config.redoAfter;
+        color = BLUE;
+    }
+    bar = (uint64_t)(held - from) * INDICATOR_BAR_WIDTH / (to - from);
+    if (bar > indicator->bar){
+        ST7789_DrawFilledRectangle(INDICATOR_BAR_X + indicator->bar, INDICATOR_BAR_Y, bar - indicator->bar - 1, INDICATOR_BAR_HEIGHT - 1, color);
+        indicator->bar = bar;
+    }
+}
+
+// Purpose: Erases the bar if any of it is drawn and forgets the digit. The digit itself stays,
+//          the caller draws the digit that was decided, or erases it for a redo
+void IndicatorClear(Indicator *indicator){
+    if (indicator->bar > 0){
+        ST7789_DrawFilledRectangle(INDICATOR_BAR_X, INDICATOR_BAR_Y, INDICATOR_BAR_WIDTH - 1, INDICATOR_BAR_HEIGHT - 1, BLACK);
+    }
+    indicator->shown = PRESS_NONE;
+    indicator->bar = 0;
+}
@@ -0,0 +1,35 @@
+// Live press indicator: what the press being held would enter, and how close it is to the next one
+
+// While the button is held the digit it would give is shown, a red 0, a green
+// 1 or a blue D for a redo, and a bar under it fills up towards the next
+// threshold in the color of what the press turns into there. Only changes are
+// drawn: the digit once per threshold it crosses, and just the part of the bar
+// that grew since the last refresh. The game calls IndicatorShow() from a timer,
+// which bounds how often the bar is drawn, so a long press costs a few glyphs
+// and a few small rectangles instead of a glyph on every pass of the main loop.
+
+#ifndef __INDICATOR_H
+#define __INDICATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "press.h"
+
+// Where the digit is drawn (its x is given with every refresh, it moves along with the input),
+// and where the progress bar is, under the digits
+#define INDICATOR_Y 220
+#define INDICATOR_BAR_X 5
+#define INDICATOR_BAR_Y 242
+#define INDICATOR_BAR_WIDTH 96
+#define INDICATOR_BAR_HEIGHT 4
+
+typedef struct {
+    PressBit shown; // The digit on screen, PRESS_NONE if there is none
+    int bar;        // How many pixels of the progress bar are drawn
+} Indicator;
+
+void IndicatorInit(Indicator *indicator); // Starts with nothing shown
+void IndicatorShow(Indicator *indicator, const PressDecoder *decoder, uint32_t now, uint16_t x); // Draws what changed in the press being held
+void IndicatorClear(Indicator *indicator); // Erases the bar and forgets the digit, once the press has been decided
+
+#endif
@@ -0,0 +1,141 @@
+// Word pack: a word list read from a text file on the SD card, a word at a time
+
+#include <string.h>
+#include "pack.h"
+
+// Purpose: Returns the next byte of the file, or -1 at its end or if the card failed
+static int PackByte(WordPack *pack){
+    if (pack->used == pack->have){
+        pack->cluster = FatCluster(&pack->file);
+        pack->clusterStart = FatClusterStart(&pack->file);
+        int count = FatRead(&pack->file, pack->buffer, PACK_BUFFER);
+
+        if (count <= 0){
+            return -1;
+        }
+        pack->have = count;
+        pack->used = 0;
+    }
+    return pack->buffer[pack->used++];
+}
+
+// Purpose: Returns where in the file the next byte PackByte() gives is
+static uint32_t PackTell(const WordPack *pack){
+    return FatTell(&pack->file) - (pack->have - pack->used);
+}
+
+// Purpose: Moves to a mark and empties the buffer
+static bool PackSeek(WordPack *pack, const PackMark *mark){
+    pack->have = 0;
+    pack->used = 0;
+    return FatSeekFrom(&pack->file, mark->position, mark->cluster, mark->clusterStart);
+}
+
+// Purpose: Reads the next word of the file into word, in upper case, and sets start to a mark of where it begins.
+//          Returns its length, or 0 at the end of the file. Runs with something other than letters in them,
+//          or with too many letters, are not words and are read past
+static int PackNext(WordPack *pack, char word[DICT_MAX_LENGTH], PackMark *start){
+    int c = PackByte(pack);
+
+    while (c >= 0){
+        int length = 0;
+        bool letters = true;
+
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t'){
+            c = PackByte(pack);
+        }
+        if (c < 0){
+            break;
+        }
+        start->position = PackTell(pack) - 1;
+        start->cluster = pack->cluster;
+        start->clusterStart = pack->clusterStart;
+        for ( ; c >= 0 && c != ' ' && c != '\n' && c != '\r' && c != '\t' ; c = PackByte(pack)){
+            if (c >= 'a' && c <= 'z'){
+                c -= 'a' - 'A';
+            }
+            if (c < 'A' || c > 'Z' || length == DICT_MAX_LENGTH){
+                letters = false;
+            }
+            else{
+                word[length++] = c;
+            }
+        }
+        if (letters){
+            return length;
+        }
+    }
+    return 0;
+}
+
+// Purpose: Counts the words, marking where every stride-th one starts. When the marks run out, every other
+//          one is dropped, which leaves the marks of every word that is a multiple of the doubled stride
+bool PackOpen(WordPack *pack, Fat *fat, const char *name){
+    char word[DICT_MAX_LENGTH];
+    PackMark start;
+
+    if (!FatOpen(fat, &pack->file, name)){
+        return false;
+    }
+    pack->have = 0;
+    pack->used = 0;
+    pack->count = 0;
+    pack->stride = 1;
+    pack->markCount = 0;
+    while (PackNext(pack, word, &start) > 0){
+        if (pack->count % pack->stride == 0){
+            if (pack->markCount == PACK_MARKS){
+                for (int i = 0 ; i < PACK_MARKS / 2 ; i++){
+                    pack->marks[i] = pack->marks[2 * i];
+                }
+                pack->markCount = PACK_MARKS / 2;
+                pack->stride *= 2;
+            }
+            if (pack->count % pack->stride == 0){
+                pack->marks[pack->markCount++] = start;
+            }
+        }
+        pack->count++;
+    }
+    pack->next = pack->count; // The file is at its end
+    return pack->count > 0;
+}
+
+// Purpose: Reads word index and packs it 5 bits a letter into pack->letters, which word is then a view of.
+//          Reading goes on from where the last word was when index is ahead of it, before its next mark
+bool PackWord(WordPack *pack, uint32_t index, WordView *word){
+    char letters[DICT_MAX_LENGTH];
+    uint32_t mark = index / pack->stride;
+    PackMark start;
+    int length = 0;
+
+    if (index >= pack->count){
+        return false;
+    }
+    if (index < pack->next || mark * pack->stride > pack->next){
+        if (!PackSeek(pack, &pack->marks[mark])){
+            return false;
+        }
+        pack->next = mark * pack->stride;
+    }
+    while (pack->next <= index){
+        length = PackNext(pack, letters, &start);
+        if (length == 0){
+            return false; // The file changed, or the card failed
+        }
+        pack->next++;
+    }
+
+    memset(pack->letters, 0, sizeof(pack->letters));
+    for (int i = 0 ; i < length ; i++){
+        uint32_t bit = i * DICT_BITS;
+        uint16_t value = (letters[i] - 'A' + 1) << (bit & 7);
+
+        pack->letters[bit >> 3] |= value & 0xFF;
+        pack->letters[(bit >> 3) + 1] |= value >> 8;
+    }
+    word->letters = pack->letters;
+    word->shift = 0;
+    word->length = length;
+    return true;
+}
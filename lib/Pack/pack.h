@@ -0,0 +1,53 @@
+// Word pack: a word list read from a text file on the SD card, a word at a time
+
+// A pack is a text file of words, e.g. WORDS.TXT, written like src/words.txt:
+// words of letters only, up to DICT_MAX_LENGTH of them, separated by spaces or
+// new lines. Anything else in the file is skipped. The pack can be far bigger
+// than RAM, so it is never copied: PackOpen() reads it through once to count
+// the words and to mark where every stride-th word starts, and PackWord() seeks
+// to the mark before a word and reads on from there. A mark keeps the cluster
+// it is in too, so going back to it never walks the FAT.
+//
+// The marks are a fixed table: when it fills up, every other mark is dropped
+// and the stride doubles, so any size of pack fits and a word is never more
+// than a stride of words after its mark. A word comes back packed like the
+// ones in flash, so the game plays it the same way.
+
+#ifndef __PACK_H
+#define __PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dictionary.h"
+#include "fat.h"
+
+#define PACK_MARKS 64  // Places in the file a word can be read from, 12 bytes of RAM each
+#define PACK_BUFFER 64 // Bytes read from the file at a time
+
+typedef struct {
+    uint32_t position;     // Where the word starts in the file
+    uint32_t cluster;      // A cluster of the file at or before it
+    uint32_t clusterStart; // Where that cluster starts
+} PackMark;
+
+typedef struct {
+    FatFile file;
+    uint32_t count;             // Words in the pack
+    uint32_t stride;            // Words from one mark to the next
+    PackMark marks[PACK_MARKS]; // Mark i is word i * stride
+    uint8_t markCount;
+    uint32_t next;              // The word the file is read up to
+    uint8_t buffer[PACK_BUFFER];
+    uint8_t have;               // Bytes in the buffer
+    uint8_t used;               // Bytes of them taken
+    uint32_t cluster;           // The cluster the file was in when the buffer was read, at or before all of it
+    uint32_t clusterStart;
+    uint8_t letters[DICT_MAX_LENGTH * DICT_BITS / 8 + 1]; // The last word PackWord() gave, with the spare byte DictUnpack() reads
+} WordPack;
+
+bool PackOpen(WordPack *pack, Fat *fat, const char *name); // Opens a pack and counts its words, false if it has none
+bool PackWord(WordPack *pack, uint32_t index, WordView *word); // Reads word index, false if the card failed
+
+#define PackCount(pack) ((pack)->count)
+
+#endif
@@ -0,0 +1,83 @@
+// Prefix code for entering letters with fewer presses
+
+#include <stdbool.h>
+#include "prefix.h"
+
+#define NODES (2 * PREFIX_SYMBOLS - 1)
+
+const uint16_t PrefixEnglish[PREFIX_SYMBOLS] = {
+    817, 129, 278, 425, 1270, 223, 202, 609, 697, 15, 77, 403, 241, // A - M
+    675, 751, 193, 10, 599, 633, 906, 276, 98, 236, 15, 197, 7,     // N - Z
+    100, 100, 100                                                   // exit, whole word and hint, about once per game
+};
+
+// Purpose: Builds the Huffman code: the two lightest nodes are joined under a new node until only
+//          the root is left, then every symbol's code is the path from the root down to it
+void PrefixBuild(PrefixCode *code, const uint16_t weight[PREFIX_SYMBOLS]){
+    uint32_t total[NODES]; // Weight of every node, symbols first
+    bool joined[NODES] = {false}; // The node already has a parent
+    uint32_t bits[NODES];
+    uint8_t length[NODES];
+    int node, lightest, second;
+
+    for (node = 0 ; node < PREFIX_SYMBOLS ; node++){
+        total[node] = weight[node];
+    }
+
+    for (node = PREFIX_SYMBOLS ; node < NODES ; node++){
+        lightest = second = -1;
+        for (int i = 0 ; i < node ; i++){
+            if (joined[i]){
+                continue;
+            }
+            if (lightest < 0 || total[i] < total[lightest]){
+                second = lightest;
+                lightest = i;
+            }
+            else if (second < 0 || total[i] < total[second]){
+                second = i;
+            }
+        }
+        code->child[node - PREFIX_SYMBOLS][0] = lightest;
+        code->child[node - PREFIX_SYMBOLS][1] = second;
+        total[node] = total[lightest] + total[second];
+        joined[lightest] = joined[second] = true;
+    }
+
+    // Parents always come after their children, so going down from the root every parent
+    // has its code before its children need it
+    bits[PREFIX_ROOT] = 0;
+    length[PREFIX_ROOT] = 0;
+    for (node = PREFIX_ROOT ; node >= PREFIX_SYMBOLS ; node--){
+        for (int digit = 0 ; digit < 2 ; digit++){
+            int child = code->child[node - PREFIX_SYMBOLS][digit];
+            bits[child] = bits[node] | ((uint32_t)digit << length[node]);
+            length[child] = length[node] + 1;
+        }
+    }
+    for (node = 0 ; node < PREFIX_SYMBOLS ; node++){
+        code->bits[node] = bits[node];
+        code->length[node] = length[node];
+    }
+}
+
+// Purpose: Moves one digit down the code from node (start at PREFIX_ROOT). Returns the symbol
+//          once its last digit was entered, and -1 while more digits are needed
+int PrefixStep(const PrefixCode *code, uint8_t *node, int digit){
+    *node = code->child[*node - PREFIX_SYMBOLS][digit != 0];
+    if (*node < PREFIX_SYMBOLS){
+        return *node;
+    }
+    return -1;
+}
+
+// Purpose: Returns how many digits a symbol takes on average with these weights, times 100
+uint32_t PrefixAverage(const PrefixCode *code, const uint16_t weight[PREFIX_SYMBOLS]){
+    uint32_t digits = 0, count = 0;
+
+    for (int i = 0 ; i < PREFIX_SYMBOLS ; i++){
+        digits += (uint32_t)weight[i] * code->length[i];
+        count += weight[i];
+    }
+    return count == 0 ? 0 : digits * 100 / count;
+}
@@ -0,0 +1,33 @@
+// Prefix code for entering letters with fewer presses
+
+// Instead of 8 digits per letter, every letter gets a Huffman code built from
+// how often it is used: common letters get short codes, rare ones long codes,
+// and no code is the start of another, so a letter is known as soon as its
+// last digit is entered. Symbol 26 is an extra "exit" code, symbol 27 starts
+// a guess of the whole word and symbol 28 asks for a hint.
+
+#ifndef __PREFIX_H
+#define __PREFIX_H
+
+#include <stdint.h>
+
+#define PREFIX_SYMBOLS 29 // 'A' to 'Z', then exit, whole word and hint
+#define PREFIX_EXIT 26
+#define PREFIX_WORD 27
+#define PREFIX_HINT 28
+#define PREFIX_ROOT (2 * PREFIX_SYMBOLS - 2) // Node the walk of every code starts at
+
+typedef struct {
+    uint8_t child[PREFIX_SYMBOLS - 1][2]; // Children of node PREFIX_SYMBOLS + i, nodes below PREFIX_SYMBOLS are symbols
+    uint32_t bits[PREFIX_SYMBOLS];        // The code of each symbol, the first digit is the least significant bit
+    uint8_t length[PREFIX_SYMBOLS];       // How many digits each code has
+} PrefixCode;
+
+// How often each letter is used in English text (per 10000 letters), and how often exit, whole word and hint are chosen
+extern const uint16_t PrefixEnglish[PREFIX_SYMBOLS];
+
+void PrefixBuild(PrefixCode *code, const uint16_t weight[PREFIX_SYMBOLS]); // Builds the Huffman code for these weights
+int PrefixStep(const PrefixCode *code, uint8_t *node, int digit); // Follows one digit from node, returns the symbol once it is reached, else -1
+uint32_t PrefixAverage(const PrefixCode *code, const uint16_t weight[PREFIX_SYMBOLS]); // Average digits per symbol, times 100
+
+#endif
@@ -0,0 +1,146 @@
+// Press decoder: turns timestamped button edges into binary digits
+
+#include "press.h"
+
+// Purpose: Sets the thresholds and starts from a released button with no digits
+void PressInit(PressDecoder *decoder, const PressConfig *config){
+    decoder->config = *config;
+    decoder->raw = false;
+    decoder->rawTime = 0;
+    decoder->down = false;
+    decoder->downTime = 0;
+    PressClear(decoder);
+}
+
+// Purpose: Forgets the decoded digits. The button state is kept, so a press that is
+//          still held when the next input starts is decoded normally
+void PressClear(PressDecoder *decoder){
+    decoder->count = 0;
+    decoder->value = 0;
+}
+
+// Purpose: Returns which digit a press held for this long (in microseconds) stands for
+PressBit PressClassify(const PressDecoder *decoder, uint32_t held){
+    if (held < decoder->config.oneAfter){
+        return PRESS_ZERO;
+    }
+    else if (held < decoder->config.redoAfter){
+        return PRESS_ONE;
+    }
+    return PRESS_REDO;
+}
+
+// Purpose: Accepts the latest edge if its level has been stable for the debounce time by now.
+//          A release completes a press, which is classified and added to the digits
+PressBit PressPoll(PressDecoder *decoder, uint32_t now){
+    PressBit bit;
+
+    // Unsigned differences stay right when the microsecond clock wraps
+    if (decoder->raw == decoder->down || now - decoder->rawTime < decoder->config.debounce){
+        return PRESS_NONE;
+    }
+
+    // The press starts and ends where the level last changed, i.e. after the bouncing
+    decoder->down = decoder->raw;
+    if (decoder->down){
+        decoder->downTime = decoder->rawTime;
+        return PRESS_NONE;
+    }
+
+    bit = PressClassify(decoder, decoder->rawTime - decoder->downTime);
+    if (bit != PRESS_REDO && decoder->count < PRESS_MAX_BITS){
+        if (bit == PRESS_ONE){
+            decoder->value |= 1UL << decoder->count;
+        }
+        decoder->count++;
+    }
+    return bit;
+}
+
+// Purpose: Takes one edge. The previous edge is settled first, since it is now known
+//          how long its level lasted. Every edge restarts the debounce time
+PressBit PressFeed(PressDecoder *decoder, uint32_t time, bool pressed){
+    PressBit bit = PressPoll(decoder, time);
+
+    decoder->raw = pressed;
+    decoder->rawTime = time;
+    return bit;
+}
+
+// Purpose: Returns how long the debounced press has been held, or 0 while released
+uint32_t PressHeld(const PressDecoder *decoder, uint32_t now){
+    if (!decoder->down){
+        return 0;
+    }
+    return now - decoder->downTime;
+}
+
+// Purpose: Returns how long the last decided press lasted, between its settled edges
+uint32_t PressLastHeld(const PressDecoder *decoder){
+    return decoder->rawTime - decoder->downTime;
+}
+
+// Purpose: Keeps a value inside a range
+static uint32_t PressClamp(uint32_t value, uint32_t min, uint32_t max){
+    if (value < min){
+        return min;
+    }
+    if (value > max){
+        return max;
+    }
+    return value;
+}
+
+// Purpose: Moves the decoder's thresholds to where the averages put them, inside the safety bounds
+static void PressApply(const PressLearner *learner, PressDecoder *decoder){
+    uint32_t oneAfter = learner->shortMean / 2 + learner->longMean / 2;
+
+    // A 0 that is on average longer than a 1 says nothing useful, keep the boundary where it is
+    if (learner->shortMean >= learner->longMean){
+        return;
+    }
+    oneAfter = PressClamp(oneAfter, PRESS_MIN_ONE_AFTER, PRESS_MAX_ONE_AFTER);
+    decoder->config.oneAfter = oneAfter;
+    decoder->config.redoAfter = PressClamp(oneAfter / 16 * learner->redoRatio, PRESS_MIN_REDO_AFTER, PRESS_MAX_REDO_AFTER);
+}
+
+// Purpose: Starts with averages a quarter either side of oneAfter, which is where they put the boundary,
+//          and remembers how far the redo threshold is from it
+void PressLearnInit(PressLearner *learner, const PressConfig *config){
+    learner->shortMean = config->oneAfter / 2;
+    learner->longMean = config->oneAfter / 2 * 3;
+    learner->redoRatio = config->redoAfter / (config->oneAfter / 16);
+}
+
+// Purpose: Replaces the averages with measured ones and moves the thresholds to them
+void PressLearnSet(PressLearner *learner, PressDecoder *decoder, uint32_t shortMean, uint32_t longMean){
+    learner->shortMean = shortMean;
+    learner->longMean = longMean;
+    PressApply(learner, decoder);
+}
+
+// Purpose: Moves the average of the kind of press that was just decided towards its length,
+//          then the thresholds with it. Redos are left out, they are not aimed at a length
+void PressLearn(PressLearner *learner, PressDecoder *decoder, PressBit bit){
+    uint32_t held = PressLastHeld(decoder);
+    uint32_t *mean;
+
+    if (bit == PRESS_ZERO){
+        mean = &learner->shortMean;
+    }
+    else if (bit == PRESS_ONE){
+        mean = &learner->longMean;
+    }
+    else{
+        return;
+    }
+
+    // Exponentially weighted, in whole microseconds, without signed shifts
+    if (held > *mean){
+        *mean += (held - *mean) >> PRESS_LEARN_SHIFT;
+    }
+    else{
+        *mean -= (*mean - held) >> PRESS_LEARN_SHIFT;
+    }
+    PressApply(learner, decoder);
+}
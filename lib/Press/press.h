@@ -0,0 +1,78 @@
+// Press decoder: turns timestamped button edges into binary digits
+
+// A press shorter than oneAfter is a 0, one up to redoAfter is a 1, and a
+// longer one is thrown away so the user can take the digit back. Edges are
+// debounced by only accepting a level once it has been stable for debounce
+// microseconds, so contact bounce cannot add phantom 0 bits. The decoder has
+// no hardware or display code in it: it is fed (time, level) pairs, e.g. from
+// the button interrupt, and can just as well be fed a recorded trace.
+
+#ifndef __PRESS_H
+#define __PRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest number of digits one input can have
+#define PRESS_MAX_BITS 32
+
+typedef enum {
+    PRESS_NONE, // nothing was decided
+    PRESS_ZERO, // short press
+    PRESS_ONE,  // medium press
+    PRESS_REDO  // long press, no digit
+} PressBit;
+
+typedef struct {
+    uint32_t debounce;  // microseconds a level must stay before it is accepted
+    uint32_t oneAfter;  // microseconds, shortest press that is a 1
+    uint32_t redoAfter; // microseconds, shortest press that is thrown away
+} PressConfig;
+
+// The thresholds the game has always used: 0 under 500 ms, 1 under 2500 ms
+#define PRESS_DEFAULT_CONFIG {20000, 500000, 2500000}
+
+typedef struct {
+    PressConfig config;
+    bool raw;          // level of the latest edge (true = pressed)
+    uint32_t rawTime;  // time of the latest edge
+    bool down;         // debounced level
+    uint32_t downTime; // when the debounced press started
+    uint8_t count;     // digits decoded since PressClear
+    uint32_t value;    // the digits, the first one is the least significant bit
+} PressDecoder;
+
+void PressInit(PressDecoder *decoder, const PressConfig *config); // Starts released with no digits
+void PressClear(PressDecoder *decoder); // Forgets the digits, a press in progress is kept
+PressBit PressFeed(PressDecoder *decoder, uint32_t time, bool pressed); // Takes one edge, returns the digit it completed
+PressBit PressPoll(PressDecoder *decoder, uint32_t now); // Settles the latest edge once it is stable, returns the digit it completed
+PressBit PressClassify(const PressDecoder *decoder, uint32_t held); // What a press held this long would be
+uint32_t PressHeld(const PressDecoder *decoder, uint32_t now); // How long the current press has lasted, 0 if released
+
+// Learns how long this player's 0 and 1 presses are, and moves the thresholds to suit them:
+// the 0/1 boundary goes halfway between the two average lengths, and the redo threshold
+// keeps its ratio to it. Both stay inside the bounds below whatever the presses are like.
+// Everything is integer and only depends on the presses fed in, so a recorded trace always
+// gives the same thresholds.
+#define PRESS_MIN_ONE_AFTER 200000   // microseconds
+#define PRESS_MAX_ONE_AFTER 1000000
+#define PRESS_MIN_REDO_AFTER 1500000
+#define PRESS_MAX_REDO_AFTER 5000000
+#define PRESS_LEARN_SHIFT 3          // every press moves its average 1/8 of the way towards it
+
+typedef struct {
+    uint32_t shortMean; // microseconds, average length of the presses decoded as 0
+    uint32_t longMean;  // and of the ones decoded as 1
+    uint32_t redoRatio; // redoAfter / oneAfter, times 16
+} PressLearner;
+
+void PressLearnInit(PressLearner *learner, const PressConfig *config); // Starts from averages that give these thresholds
+void PressLearnSet(PressLearner *learner, PressDecoder *decoder, uint32_t shortMean, uint32_t longMean); // Uses measured averages, e.g. from calibration
+void PressLearn(PressLearner *learner, PressDecoder *decoder, PressBit bit); // Learns from the press that just gave bit
+uint32_t PressLastHeld(const PressDecoder *decoder); // How long the press that was just decided lasted
+
+#define PressIsDown(decoder) ((decoder)->down)
+#define PressBits(decoder) ((decoder)->count)
+#define PressValue(decoder) ((decoder)->value)
+
+#endif
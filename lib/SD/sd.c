@@ -0,0 +1,169 @@
+// SD card over SPI1, next to the display on the same bus, with its own chip select on PB6
+
+#include <string.h>
+#include "sd.h"
+#include "spi.h"
+#include "pinmappings.h"
+#include "st7789 drivers.h"
+
+#define SD_CMD0 0    // GO_IDLE_STATE, into SPI mode
+#define SD_CMD8 8    // SEND_IF_COND, only cards of version 2 and later know it
+#define SD_CMD16 16  // SET_BLOCKLEN
+#define SD_CMD17 17  // READ_SINGLE_BLOCK
+#define SD_CMD55 55  // APP_CMD, the next command is an ACMD
+#define SD_CMD58 58  // READ_OCR
+#define SD_ACMD41 41 // SD_SEND_OP_COND, starts the card's initialization
+
+#define SD_IDLE 0x01        // R1: the card is still initializing
+#define SD_ILLEGAL 0x04     // R1: the card does not know the command
+#define SD_DATA_TOKEN 0xFE  // Comes before the data of a block
+#define SD_SLOW SPI_BAUDRATEPRESCALER_256 // 84 MHz / 256 = 328 kHz, for waking the card up
+#define SD_FAST SPI_BAUDRATEPRESCALER_4   // 21 MHz
+
+static bool blockAddressed = false; // SDHC and SDXC cards take block numbers, older ones byte addresses
+static uint32_t speed = SD_FAST;
+
+// Purpose: Sends a byte and returns the one that came back at the same time
+static uint8_t SdExchange(uint8_t out){
+    uint8_t in = 0xFF;
+
+    HAL_SPI_TransmitReceive(&hspi1, &out, &in, 1, HAL_MAX_DELAY);
+    return in;
+}
+
+// Purpose: Sets the bus clock. The baud rate can only change while the SPI is off, it is turned on again by the next transfer
+static void SdSpeed(uint32_t prescaler){
+    __HAL_SPI_DISABLE(&hspi1);
+    MODIFY_REG(hspi1.Instance->CR1, SPI_CR1_BR, prescaler);
+}
+
+// Purpose: Takes the bus from the display and selects the card
+static void SdSelect(void){
+    ST7789_FB_Release();
+    SdSpeed(speed);
+    __HAL_SPI_CLEAR_OVRFLAG(&hspi1); // The display only sends, whatever it left in the receive register is stale
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_RESET);
+}
+
+// Purpose: Deselects the card and gives the bus back. One more byte lets the card let go of MISO
+static void SdDeselect(void){
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_SET);
+    SdExchange(0xFF);
+    SdSpeed(hspi1.Init.BaudRatePrescaler);
+}
+
+// Purpose: Sends a command and returns its R1 response, 0xFF if the card never answered. The CRC is only
+//          checked for CMD0 and CMD8, before the card is in SPI mode, so only theirs are right
+static uint8_t SdCommand(uint8_t command, uint32_t argument){
+    uint8_t response = 0xFF;
+
+    SdExchange(0x40 | command);
+    SdExchange(argument >> 24);
+    SdExchange(argument >> 16);
+    SdExchange(argument >> 8);
+    SdExchange(argument);
+    SdExchange(command == SD_CMD0 ? 0x95 : command == SD_CMD8 ? 0x87 : 0x01);
+
+    // The response comes within 8 bytes, its top bit is always 0
+    for (int i = 0 ; i < 8 && (response & 0x80) ; i++){
+        response = SdExchange(0xFF);
+    }
+    return response;
+}
+
+// Purpose: Wakes the card up and finds out how it is addressed:
+//          CMD0 into SPI mode, CMD8 for the version, ACMD41 until it is ready, then CMD58 for SDHC.
+//          An SDSC card is also told to use 512 byte blocks
+bool SdInit(void){
+    uint8_t response;
+    bool version2;
+    uint32_t start;
+
+    speed = SD_SLOW;
+    SdSelect();
+
+    // The card wants 74 clocks with CS high before anything else
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_SET);
+    for (int i = 0 ; i < 10 ; i++){
+        SdExchange(0xFF);
+    }
+    HAL_GPIO_WritePin(SD_CS_GPIO_Port, SD_CS_Pin, GPIO_PIN_RESET);
+
+    response = SdCommand(SD_CMD0, 0);
+    for (int i = 0 ; i < 10 && response != SD_IDLE ; i++){
+        response = SdCommand(SD_CMD0, 0);
+    }
+    if (response != SD_IDLE){
+        SdDeselect();
+        return false;
+    }
+
+    // Version 2 cards echo the check pattern back and say if they take 2.7 to 3.6 V
+    version2 = SdCommand(SD_CMD8, 0x1AA) == SD_IDLE;
+    if (version2){
+        uint8_t echo[4];
+
+        for (int i = 0 ; i < 4 ; i++){
+            echo[i] = SdExchange(0xFF);
+        }
+        if ((echo[2] & 0x0F) != 0x01 || echo[3] != 0xAA){
+            SdDeselect();
+            return false;
+        }
+    }
+
+    // Initialization takes up to a second, HCS tells the card SDHC is understood
+    start = HAL_GetTick();
+    do{
+        SdCommand(SD_CMD55, 0);
+        response = SdCommand(SD_ACMD41, version2 ? 0x40000000UL : 0);
+    } while (response == SD_IDLE && HAL_GetTick() - start < 1000);
+    if (response != 0){
+        SdDeselect();
+        return false;
+    }
+
+    blockAddressed = false;
+    if (version2 && SdCommand(SD_CMD58, 0) == 0){
+        blockAddressed = (SdExchange(0xFF) & 0x40) != 0; // CCS, the OCR's bit 30
+        for (int i = 0 ; i < 3 ; i++){
+            SdExchange(0xFF);
+        }
+    }
+    if (!blockAddressed && SdCommand(SD_CMD16, SD_BLOCK) != 0){
+        SdDeselect();
+        return false;
+    }
+    SdDeselect();
+    speed = SD_FAST;
+    return true;
+}
+
+// Purpose: Reads one block: CMD17, then the data token, the 512 bytes and a CRC that is not checked.
+//          The card is given 0xFF to send back in, which is also what the buffer is filled with
+bool SdRead(uint32_t block, uint8_t *data){
+    uint8_t token = 0xFF;
+    uint32_t start;
+
+    SdSelect();
+    if (SdCommand(SD_CMD17, blockAddressed ? block : block * SD_BLOCK) != 0){
+        SdDeselect();
+        return false;
+    }
+
+    // Reading a block takes up to 100 ms
+    start = HAL_GetTick();
+    while (token == 0xFF && HAL_GetTick() - start < 100){
+        token = SdExchange(0xFF);
+    }
+    if (token != SD_DATA_TOKEN){
+        SdDeselect();
+        return false;
+    }
+    memset(data, 0xFF, SD_BLOCK);
+    HAL_SPI_TransmitReceive(&hspi1, data, data, SD_BLOCK, HAL_MAX_DELAY);
+    SdExchange(0xFF);
+    SdExchange(0xFF);
+    SdDeselect();
+    return true;
+}
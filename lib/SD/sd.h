@@ -0,0 +1,25 @@
+// SD card over SPI1, next to the display on the same bus, with its own chip select on PB6
+
+// The card is wired like the Arduino SD shields: SCK PA5 (D13), MOSI PA7 (D11)
+// and MISO PA6 (D12), shared with the display, and CS on PB6 (D10). Only one
+// of the two chip selects is ever low: the card waits for the display to
+// finish the row it is sending (see ST7789_FB_Release), and the display goes
+// on with its flush once the card is done.
+//
+// A card has to be woken up at 400 kHz or less, so SdInit() slows the bus
+// down and every later transfer runs the bus at 21 MHz, which every card
+// takes in SPI mode. The display's own speed is put back after each block.
+// Blocks are 512 bytes, on old (SDSC) cards as on SDHC/SDXC ones.
+
+#ifndef __SD_H
+#define __SD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SD_BLOCK 512
+
+bool SdInit(void); // Wakes the card up, false if there is none or it did not answer
+bool SdRead(uint32_t block, uint8_t *data); // Reads one block, false if the card failed
+
+#endif
@@ -73,6 +73,8 @@ void Error_Handler(void);
 #define ST7789_RST_GPIO_Port GPIOA
 #define ST7789_CS_Pin GPIO_PIN_4
 #define ST7789_CS_GPIO_Port GPIOA
+#define SD_CS_Pin GPIO_PIN_6
+#define SD_CS_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
 
@@ -2,6 +2,8 @@
 // We have made any modifications necessary for our project.
 // It is made for the ST7789 LCD controller.
 
+#include <stdbool.h>
+#include <string.h>
 #include "st7789 drivers.h"
 
 /**
@@ -32,6 +34,14 @@ static void ST7789_WriteData(uint8_t *buff, size_t buff_size)
 
 	while (buff_size > 0) {
 		uint16_t chunk_size = buff_size > 65535 ? 65535 : buff_size;
+#ifdef USE_DMA
+		if (DMA_MIN_SIZE <= buff_size) {
+			HAL_SPI_Transmit_DMA(&ST7789_SPI_PORT, buff, chunk_size);
+			while (HAL_SPI_GetState(&ST7789_SPI_PORT) != HAL_SPI_STATE_READY)
+				;
+		}
+		else
+#endif
 		HAL_SPI_Transmit(&ST7789_SPI_PORT, buff, chunk_size, HAL_MAX_DELAY);
 		buff += chunk_size;
 		buff_size -= chunk_size;
@@ -39,6 +49,49 @@ static void ST7789_WriteData(uint8_t *buff, size_t buff_size)
 
 	ST7789_UnSelect();
 }
+
+/**
+ * @brief Start sending data to ST7789 controller without waiting for it (with DMA)
+ * The caller selects the chip and sets DC, and must call ST7789_WaitData
+ * before reusing the buffer or touching the bus again.
+ * @param buff -> pointer of data buffer
+ * @param buff_size -> size of the data buffer
+ * @return none
+ */
+static void ST7789_StartData(uint8_t *buff, uint16_t buff_size)
+{
+#ifdef USE_DMA
+	HAL_SPI_Transmit_DMA(&ST7789_SPI_PORT, buff, buff_size);
+#else
+	HAL_SPI_Transmit(&ST7789_SPI_PORT, buff, buff_size, HAL_MAX_DELAY);
+#endif
+}
+
+/**
+ * @brief Check whether the transfer started by ST7789_StartData is still running
+ * @param none
+ * @return true until it has finished
+ */
+static bool ST7789_DataBusy(void)
+{
+#ifdef USE_DMA
+	return HAL_SPI_GetState(&ST7789_SPI_PORT) != HAL_SPI_STATE_READY;
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Wait for the transfer started by ST7789_StartData to finish
+ * @param none
+ * @return none
+ */
+static void ST7789_WaitData(void)
+{
+	while (ST7789_DataBusy())
+		;
+}
+
 /**
  * @brief Write data to ST7789 controller, simplify for 8bit data.
  * data -> data to write
@@ -107,6 +160,740 @@ static void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint1
 	ST7789_UnSelect();
 }
 
+/* Two line buffers, so one row can be generated while the other is sent */
+static uint16_t line_buf[2][ST7789_WIDTH];
+
+/**
+ * Quarter turns between the frame primitives currently draw in and the
+ * ST7789_ROTATION frame (see ST7789_WriteStringRotated): 0, 1 (clockwise)
+ * or 3 (counter-clockwise).
+ */
+static uint8_t frame_turn = 0;
+
+#ifdef ST7789_USE_FRAMEBUFFER
+
+/**
+ * 2bpp palettized framebuffer. Every row has its own 4 entry palette, so a
+ * line of text can mix its own colors with the background, and a dirty bit
+ * that is only set when a pixel really changes. Flushing expands the dirty
+ * rows through their palette and sends runs of them as single windows.
+ */
+#define FB_STRIDE (ST7789_WIDTH / 4)
+
+static uint8_t fb[ST7789_HEIGHT][FB_STRIDE];
+static uint16_t fb_palette[ST7789_HEIGHT][4];
+static uint8_t fb_used[ST7789_HEIGHT];
+static uint32_t fb_dirty[(ST7789_HEIGHT + 31) / 32];
+static bool fb_active = false;
+
+/* Window and write position of the pixel stream while drawing into RAM */
+static struct {
+	int16_t x0, y0, x1, y1;
+	int16_t x, y;
+} fb_win;
+
+#define FB_ACTIVE() (fb_active)
+#define FB_MARK_DIRTY(y) (fb_dirty[(y) >> 5] |= 1UL << ((y) & 31))
+
+/**
+ * @brief Find (or make room for) a color in the palette of a row
+ * When all 4 entries are taken, entries no pixel of the row uses any more
+ * are recycled. If all of them are still in use, the closest color wins.
+ * @param y -> row
+ * @param color -> RGB565 color
+ * @return palette index
+ */
+static uint8_t ST7789_FB_ColorIndex(int32_t y, uint16_t color)
+{
+	uint8_t i, seen = 0, best = 0;
+	uint32_t d, best_d = 0xFFFFFFFF;
+	int32_t dr, dg, db;
+
+	for (i = 0; i < fb_used[y]; i++)
+		if (fb_palette[y][i] == color)
+			return i;
+	if (fb_used[y] < 4) {
+		fb_palette[y][fb_used[y]] = color;
+		return fb_used[y]++;
+	}
+
+	for (i = 0; i < FB_STRIDE; i++) {
+		uint8_t b = fb[y][i];
+		seen |= (1 << (b >> 6)) | (1 << ((b >> 4) & 3)) | (1 << ((b >> 2) & 3)) | (1 << (b & 3));
+	}
+	for (i = 0; i < 4; i++) {
+		if (!(seen & (1 << i))) {
+			fb_palette[y][i] = color;
+			return i;
+		}
+	}
+
+	for (i = 0; i < 4; i++) {
+		dr = (int32_t)(fb_palette[y][i] >> 11) - (color >> 11);
+		dg = (int32_t)((fb_palette[y][i] >> 5) & 0x3F) - ((color >> 5) & 0x3F);
+		db = (int32_t)(fb_palette[y][i] & 0x1F) - (color & 0x1F);
+		d = dr * dr * 4 + dg * dg + db * db * 4;
+		if (d < best_d) {
+			best_d = d;
+			best = i;
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief Write one pixel of the stream into the framebuffer and advance
+ * @param color -> RGB565 color
+ * @return none
+ */
+static void ST7789_FB_Push(uint16_t color)
+{
+	int32_t x = fb_win.x, y = fb_win.y;
+	uint8_t *p, shift, v;
+
+	/* Map a turned frame back onto the framebuffer, like MADCTL does on the panel */
+	if (frame_turn == 1) {
+		x = ST7789_WIDTH - 1 - fb_win.y;
+		y = fb_win.x;
+	}
+	else if (frame_turn == 3) {
+		x = fb_win.y;
+		y = ST7789_HEIGHT - 1 - fb_win.x;
+	}
+
+	p = &fb[y][x >> 2];
+	shift = 6 - ((x & 3) << 1);
+	v = (*p & ~(3 << shift)) | (ST7789_FB_ColorIndex(y, color) << shift);
+
+	if (v != *p) {
+		*p = v;
+		FB_MARK_DIRTY(y);
+	}
+
+	/* Same wrapping as the panel's address counter */
+	if (++fb_win.x > fb_win.x1) {
+		fb_win.x = fb_win.x0;
+		if (++fb_win.y > fb_win.y1)
+			fb_win.y = fb_win.y0;
+	}
+}
+
+/**
+ * @brief Write count pixels of one color into the framebuffer
+ * Whole rows are reset to a single palette entry instead of being written
+ * pixel by pixel, so clearing the screen stays cheap.
+ * @param color -> RGB565 color
+ * @param count -> number of pixels
+ * @return none
+ */
+static void ST7789_FB_PushColor(uint16_t color, uint32_t count)
+{
+	int32_t y, i;
+
+	while (count > 0) {
+		if (frame_turn == 0 && fb_win.x0 == 0 && fb_win.x1 == ST7789_WIDTH - 1 && fb_win.x == 0 && count >= ST7789_WIDTH) {
+			y = fb_win.y;
+			if (!(fb_used[y] == 1 && fb_palette[y][0] == color)) {
+				fb_palette[y][0] = color;
+				fb_used[y] = 1;
+				FB_MARK_DIRTY(y);
+			}
+			for (i = 0; i < FB_STRIDE; i++) {
+				if (fb[y][i] != 0) {
+					fb[y][i] = 0;
+					FB_MARK_DIRTY(y);
+				}
+			}
+			if (++fb_win.y > fb_win.y1)
+				fb_win.y = fb_win.y0;
+			count -= ST7789_WIDTH;
+		}
+		else {
+			ST7789_FB_Push(color);
+			count--;
+		}
+	}
+}
+
+/**
+ * @brief Redirect all drawing into the framebuffer
+ * The framebuffer is cleared to one color and marked dirty, so the first
+ * flush also brings the panel to a known state.
+ * @param color -> color to clear the framebuffer to
+ * @return none
+ */
+void ST7789_FB_Begin(uint16_t color)
+{
+	int32_t y;
+
+	for (y = 0; y < ST7789_HEIGHT; y++) {
+		fb_palette[y][0] = color;
+		fb_used[y] = 1;
+		FB_MARK_DIRTY(y);
+	}
+	memset(fb, 0, sizeof(fb));
+	fb_active = true;
+}
+
+/* Line buffers of the flush, separate from line_buf so drawing can go on while a flush is sent */
+static uint16_t fb_line[2][ST7789_WIDTH];
+
+/* Progress of a flush done in steps, see ST7789_FB_FlushStep */
+static struct {
+	bool open;	/* an address window is open and its rows are streaming */
+	int16_t y;	/* row waiting in fb_line[cur], past last once all are sent */
+	int16_t last;	/* last row of the open window */
+	uint8_t cur;
+} fb_flush;
+
+/**
+ * @brief Expand a framebuffer row through its palette, in panel byte order
+ * The row is clean from here on: drawing into it again marks it dirty for
+ * the next flush, even if this copy has not been sent yet.
+ * @param y -> row
+ * @param line -> line buffer of ST7789_WIDTH pixels
+ * @return none
+ */
+static void ST7789_FB_ExpandRow(int32_t y, uint16_t *line)
+{
+	uint16_t lut[4];
+	uint8_t b;
+
+	lut[0] = (fb_palette[y][0] >> 8) | (fb_palette[y][0] << 8);
+	lut[1] = (fb_palette[y][1] >> 8) | (fb_palette[y][1] << 8);
+	lut[2] = (fb_palette[y][2] >> 8) | (fb_palette[y][2] << 8);
+	lut[3] = (fb_palette[y][3] >> 8) | (fb_palette[y][3] << 8);
+	for (b = 0; b < FB_STRIDE; b++) {
+		line[0] = lut[fb[y][b] >> 6];
+		line[1] = lut[(fb[y][b] >> 4) & 3];
+		line[2] = lut[(fb[y][b] >> 2) & 3];
+		line[3] = lut[fb[y][b] & 3];
+		line += 4;
+	}
+	fb_dirty[y >> 5] &= ~(1UL << (y & 31));
+}
+
+/**
+ * @brief Find the next run of consecutive dirty rows
+ * @param first -> set to the first row of the run
+ * @param last -> set to the last row of the run
+ * @return false if no row is dirty
+ */
+static bool ST7789_FB_NextRun(int16_t *first, int16_t *last)
+{
+	int32_t y;
+
+	for (y = 0; y < ST7789_HEIGHT; y++) {
+		if (!(fb_dirty[y >> 5] & (1UL << (y & 31)))) {
+			if ((y & 31) == 0 && fb_dirty[y >> 5] == 0)
+				y += 31;
+			continue;
+		}
+		*first = y;
+		while (y + 1 < ST7789_HEIGHT && (fb_dirty[(y + 1) >> 5] & (1UL << ((y + 1) & 31))))
+			y++;
+		*last = y;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Do the next bit of sending the dirty rows, without waiting
+ * While the transfer of one row is still running this returns at once.
+ * Otherwise the row that is ready is started and the next one is expanded
+ * while it goes out. Consecutive dirty rows share one address window.
+ * Call it until it returns false, e.g. from a main loop; all drawing goes
+ * to RAM meanwhile, and rows changed after they were sent are sent again.
+ * @param none
+ * @return true while the flush is still in progress
+ */
+bool ST7789_FB_FlushStep(void)
+{
+	int16_t first, last;
+
+	if (ST7789_DataBusy())
+		return true;
+
+	if (fb_flush.open && fb_flush.y > fb_flush.last) {
+		/* The last row of the window has gone out */
+		ST7789_UnSelect();
+		fb_flush.open = false;
+	}
+	if (!fb_flush.open) {
+		if (!ST7789_FB_NextRun(&first, &last))
+			return false;
+		ST7789_SetAddressWindow(0, first, ST7789_WIDTH - 1, last);
+		ST7789_Select();
+		ST7789_DC_Set();
+		fb_flush.open = true;
+		fb_flush.y = first;
+		fb_flush.last = last;
+		ST7789_FB_ExpandRow(first, fb_line[fb_flush.cur]);
+	}
+
+	ST7789_StartData((uint8_t *)fb_line[fb_flush.cur], sizeof(fb_line[0]));
+	fb_flush.cur ^= 1;
+	if (++fb_flush.y <= fb_flush.last)
+		ST7789_FB_ExpandRow(fb_flush.y, fb_line[fb_flush.cur]);
+	return true;
+}
+
+/**
+ * @brief Send the dirty rows of the framebuffer to the panel, and wait for them
+ * @param none
+ * @return none
+ */
+void ST7789_FB_Flush(void)
+{
+	while (ST7789_FB_FlushStep())
+		;
+}
+
+/**
+ * @brief Let another device on the SPI bus use it, in the middle of a flush
+ * Waits for the row being sent, then closes the address window and lets go
+ * of CS. The row that was expanded for the next transfer is marked dirty
+ * again, so the next ST7789_FB_FlushStep picks up from it in a new window.
+ * @param none
+ * @return none
+ */
+void ST7789_FB_Release(void)
+{
+	while (ST7789_DataBusy())
+		;
+	if (!fb_flush.open)
+		return;
+	ST7789_UnSelect();
+	fb_flush.open = false;
+	if (fb_flush.y <= fb_flush.last)
+		FB_MARK_DIRTY(fb_flush.y);
+}
+
+/**
+ * Screen snapshots are stored as a stream of row commands in a static pool:
+ *   SNAP_FILL  count(2) color(2)               -> count rows of one color
+ *   SNAP_ROW   used(1) colors(2 * used) bits   -> a row with its own palette
+ *   SNAP_SAME  bits                            -> a row reusing the last palette
+ * where bits is the packed row run-length coded PackBits style: a header
+ * n < 128 is followed by n + 1 literal bytes, n >= 128 repeats the next
+ * byte 257 - n times.
+ */
+#define SNAP_FILL 0x01
+#define SNAP_ROW 0x02
+#define SNAP_SAME 0x03
+
+static uint8_t snap_pool[ST7789_SNAPSHOT_POOL];
+static uint16_t snap_used = 0;
+
+/**
+ * @brief Check whether a framebuffer row is a single color
+ * @param y -> row
+ * @param color -> set to the row's color when it is uniform
+ * @return true if every pixel of the row has the same color
+ */
+static bool ST7789_FB_RowColor(int32_t y, uint16_t *color)
+{
+	uint8_t b = fb[y][0], i;
+
+	if (b != 0x00 && b != 0x55 && b != 0xAA && b != 0xFF)
+		return false;
+	for (i = 1; i < FB_STRIDE; i++)
+		if (fb[y][i] != b)
+			return false;
+	*color = fb_palette[y][b & 3];
+	return true;
+}
+
+/**
+ * @brief Append bytes to the snapshot being captured
+ * @return false when the pool is full
+ */
+static bool ST7789_SnapPut(const uint8_t *data, uint16_t size)
+{
+	if (snap_used + size > sizeof(snap_pool))
+		return false;
+	memcpy(&snap_pool[snap_used], data, size);
+	snap_used += size;
+	return true;
+}
+
+/**
+ * @brief Run-length code one framebuffer row into the snapshot pool
+ * @return false when the pool is full
+ */
+static bool ST7789_SnapPackRow(const uint8_t *row)
+{
+	uint8_t n, run, out[1 + 128];
+	uint16_t i = 0, lit;
+
+	while (i < FB_STRIDE) {
+		/* Length of the run starting here */
+		for (run = 1; i + run < FB_STRIDE && run < 128 && row[i + run] == row[i]; run++)
+			;
+		if (run >= 3) {
+			out[0] = 257 - run;
+			out[1] = row[i];
+			if (!ST7789_SnapPut(out, 2))
+				return false;
+			i += run;
+			continue;
+		}
+		/* Literal bytes up to the next run of 3 */
+		for (lit = i, n = 0; lit < FB_STRIDE && n < 128; lit++, n++)
+			if (lit + 2 < FB_STRIDE && row[lit] == row[lit + 1] && row[lit] == row[lit + 2])
+				break;
+		out[0] = n - 1;
+		memcpy(&out[1], &row[i], n);
+		if (!ST7789_SnapPut(out, n + 1))
+			return false;
+		i += n;
+	}
+	return true;
+}
+
+/**
+ * @brief Capture the framebuffer into a compressed snapshot
+ * Rows of one color are merged into fills, other rows are run-length
+ * coded. Snapshots live in a static pool and are never freed, they are
+ * meant for screens that never change.
+ * @param snap -> receives the snapshot
+ * @return false if the pool is too full to hold it (snap is left empty)
+ */
+bool ST7789_FB_Capture(ST7789_Snapshot *snap)
+{
+	uint16_t start = snap_used, color, next, count;
+	int32_t y = 0, prev = -1;
+	uint8_t hdr[1 + 1 + 2 * 4], i;
+
+	snap->data = NULL;
+	snap->size = 0;
+	while (y < ST7789_HEIGHT) {
+		if (ST7789_FB_RowColor(y, &color)) {
+			for (count = 1; y + count < ST7789_HEIGHT && ST7789_FB_RowColor(y + count, &next) && next == color; count++)
+				;
+			hdr[0] = SNAP_FILL;
+			hdr[1] = count >> 8;
+			hdr[2] = count & 0xFF;
+			hdr[3] = color >> 8;
+			hdr[4] = color & 0xFF;
+			if (!ST7789_SnapPut(hdr, 5))
+				goto full;
+			y += count;
+			prev = -1;
+			continue;
+		}
+
+		if (prev >= 0 && fb_used[prev] == fb_used[y] &&
+			memcmp(fb_palette[prev], fb_palette[y], sizeof(uint16_t) * fb_used[y]) == 0) {
+			hdr[0] = SNAP_SAME;
+			if (!ST7789_SnapPut(hdr, 1))
+				goto full;
+		}
+		else {
+			hdr[0] = SNAP_ROW;
+			hdr[1] = fb_used[y];
+			for (i = 0; i < fb_used[y]; i++) {
+				hdr[2 + 2 * i] = fb_palette[y][i] >> 8;
+				hdr[3 + 2 * i] = fb_palette[y][i] & 0xFF;
+			}
+			if (!ST7789_SnapPut(hdr, 2 + 2 * fb_used[y]))
+				goto full;
+		}
+		if (!ST7789_SnapPackRow(fb[y]))
+			goto full;
+		prev = y;
+		y++;
+	}
+
+	snap->data = &snap_pool[start];
+	snap->size = snap_used - start;
+	return true;
+
+full:
+	snap_used = start;
+	return false;
+}
+
+/**
+ * @brief Draw a snapshot back into the framebuffer
+ * Only rows that differ from what the framebuffer holds are marked dirty,
+ * so the next flush sends just the rows that changed on the panel.
+ * @param snap -> snapshot made by ST7789_FB_Capture
+ * @return none
+ */
+void ST7789_FB_Restore(const ST7789_Snapshot *snap)
+{
+	const uint8_t *p = snap->data, *end = snap->data + snap->size;
+	uint16_t palette[4] = {0}, count, color;
+	uint8_t used = 1, row[FB_STRIDE], n, i;
+	int32_t y = 0, x;
+
+	while (p < end && y < ST7789_HEIGHT) {
+		if (*p == SNAP_FILL) {
+			count = (p[1] << 8) | p[2];
+			color = (p[3] << 8) | p[4];
+			p += 5;
+			fb_win.x0 = fb_win.x = 0;
+			fb_win.x1 = ST7789_WIDTH - 1;
+			fb_win.y0 = fb_win.y = y;
+			fb_win.y1 = y + count - 1;
+			ST7789_FB_PushColor(color, (uint32_t)count * ST7789_WIDTH);
+			y += count;
+			continue;
+		}
+
+		if (*p++ == SNAP_ROW) {
+			used = *p++;
+			for (i = 0; i < used; i++, p += 2)
+				palette[i] = (p[0] << 8) | p[1];
+		}
+		for (x = 0; x < FB_STRIDE; x += n) {
+			if (*p < 128) {
+				n = *p + 1;
+				memcpy(&row[x], p + 1, n);
+				p += n + 1;
+			}
+			else {
+				n = 257 - *p;
+				memset(&row[x], p[1], n);
+				p += 2;
+			}
+		}
+		if (fb_used[y] != used || memcmp(fb_palette[y], palette, sizeof(uint16_t) * used) != 0 ||
+			memcmp(fb[y], row, FB_STRIDE) != 0) {
+			fb_used[y] = used;
+			memcpy(fb_palette[y], palette, sizeof(palette));
+			memcpy(fb[y], row, FB_STRIDE);
+			FB_MARK_DIRTY(y);
+		}
+		y++;
+	}
+}
+
+/**
+ * @brief Flush the framebuffer and draw directly to the panel again
+ * @param none
+ * @return none
+ */
+void ST7789_FB_End(void)
+{
+	ST7789_FB_Flush();
+	fb_active = false;
+}
+
+#else
+
+#define FB_ACTIVE() (false)
+
+#endif
+
+/**
+ * @brief Open a window for pixel data, on the panel or in the framebuffer
+ * @param x0&y0&x1&y1 -> corners of the window, already clipped
+ * @return none
+ */
+static void ST7789_SetWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+#ifdef ST7789_USE_FRAMEBUFFER
+	if (FB_ACTIVE()) {
+		fb_win.x0 = fb_win.x = x0;
+		fb_win.y0 = fb_win.y = y0;
+		fb_win.x1 = x1;
+		fb_win.y1 = y1;
+		return;
+	}
+#endif
+	ST7789_SetAddressWindow(x0, y0, x1, y1);
+}
+
+/**
+ * @brief Write pixel data (RGB565, panel byte order) into the current window
+ * @param buff -> pointer of data buffer
+ * @param buff_size -> size of the data buffer in bytes
+ * @return none
+ */
+static void ST7789_WritePixelData(uint8_t *buff, size_t buff_size)
+{
+#ifdef ST7789_USE_FRAMEBUFFER
+	if (FB_ACTIVE()) {
+		for (; buff_size >= 2; buff_size -= 2, buff += 2)
+			ST7789_FB_Push((buff[0] << 8) | buff[1]);
+		return;
+	}
+#endif
+	ST7789_WriteData(buff, buff_size);
+}
+
+/* Clip rectangle stack (inclusive corners), entry 0 is the whole screen */
+typedef struct {
+	int16_t x0, y0, x1, y1;
+} ST7789_Rect;
+
+static ST7789_Rect clip_stack[ST7789_CLIP_DEPTH + 1] = {
+	{0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1}
+};
+static uint8_t clip_top = 0;
+static uint8_t clip_overflow = 0;
+#define CLIP (clip_stack[clip_top]) /* The clip rectangle in use */
+
+typedef void (*ST7789_Plot)(int32_t x, int32_t y, uint16_t color);
+
+/**
+ * @brief Clip a box against the current clip rectangle
+ * @param x0&y0&x1&y1 -> corners of the box, may be in any order, clipped in place
+ * @return true if anything is left to draw
+ */
+static bool ST7789_ClipBox(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1)
+{
+	int32_t swap;
+
+	if (*x0 > *x1) {
+		swap = *x0;
+		*x0 = *x1;
+		*x1 = swap;
+	}
+	if (*y0 > *y1) {
+		swap = *y0;
+		*y0 = *y1;
+		*y1 = swap;
+	}
+	if (*x0 < CLIP.x0)
+		*x0 = CLIP.x0;
+	if (*y0 < CLIP.y0)
+		*y0 = CLIP.y0;
+	if (*x1 > CLIP.x1)
+		*x1 = CLIP.x1;
+	if (*y1 > CLIP.y1)
+		*y1 = CLIP.y1;
+	return *x0 <= *x1 && *y0 <= *y1;
+}
+
+/**
+ * @brief Check whether a point lies inside the current clip rectangle
+ */
+static bool ST7789_Inside(int32_t x, int32_t y)
+{
+	return x >= CLIP.x0 && x <= CLIP.x1 && y >= CLIP.y0 && y <= CLIP.y1;
+}
+
+/**
+ * @brief Send the same color count times into the current window
+ * @param color -> color to send
+ * @param count -> number of pixels
+ * @return none
+ */
+static void ST7789_WriteColor(uint16_t color, uint32_t count)
+{
+	uint8_t data[64];
+	uint32_t i, chunk;
+
+#ifdef ST7789_USE_FRAMEBUFFER
+	if (FB_ACTIVE()) {
+		ST7789_FB_PushColor(color, count);
+		return;
+	}
+#endif
+	for (i = 0; i < sizeof(data); i += 2) {
+		data[i] = color >> 8;
+		data[i + 1] = color & 0xFF;
+	}
+	while (count > 0) {
+		chunk = count > sizeof(data) / 2 ? sizeof(data) / 2 : count;
+		ST7789_WriteData(data, chunk * 2);
+		count -= chunk;
+	}
+}
+
+/**
+ * @brief Fill a box with single color, clipped once up front
+ * @param x0&y0&x1&y1 -> corners of the box (inclusive, any order, may be off-screen)
+ * @param color -> color to Fill with
+ * @return none
+ */
+static void ST7789_FillRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+	if (!ST7789_ClipBox(&x0, &y0, &x1, &y1))
+		return;
+	ST7789_Select();
+	ST7789_SetWindow(x0, y0, x1, y1);
+	ST7789_WriteColor(color, (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1));
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a Pixel the caller has already clipped
+ */
+static void ST7789_PutPixel(int32_t x, int32_t y, uint16_t color)
+{
+	uint8_t data[] = {color >> 8, color & 0xFF};
+	ST7789_SetWindow(x, y, x, y);
+	ST7789_WritePixelData(data, sizeof(data));
+}
+
+/**
+ * @brief Draw a Pixel if it lies inside the clip rectangle
+ */
+static void ST7789_PlotClipped(int32_t x, int32_t y, uint16_t color)
+{
+	if (ST7789_Inside(x, y))
+		ST7789_PutPixel(x, y, color);
+}
+
+/**
+ * @brief Restrict drawing to a rectangle, intersected with the current one
+ * Every primitive clips its geometry against the innermost rectangle.
+ * @param x&y -> top-left corner of the rectangle
+ * @param w&h -> width & height of the rectangle
+ * @return none
+ */
+void ST7789_PushClip(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	int32_t x0 = x, y0 = y, x1 = (int32_t)x + w - 1, y1 = (int32_t)y + h - 1;
+
+	if (clip_top == ST7789_CLIP_DEPTH) {
+		/* Too deep, keep the current rectangle but stay balanced */
+		clip_overflow++;
+		return;
+	}
+	if (w == 0 || h == 0 || !ST7789_ClipBox(&x0, &y0, &x1, &y1)) {
+		/* Empty rectangle, nothing will be drawn until it is popped */
+		x0 = 1;
+		x1 = 0;
+		y0 = 1;
+		y1 = 0;
+	}
+	clip_top++;
+	CLIP.x0 = x0;
+	CLIP.y0 = y0;
+	CLIP.x1 = x1;
+	CLIP.y1 = y1;
+}
+
+/**
+ * @brief Restore the clip rectangle active before the last ST7789_PushClip
+ * @param none
+ * @return none
+ */
+void ST7789_PopClip(void)
+{
+	if (clip_overflow > 0)
+		clip_overflow--;
+	else if (clip_top > 0)
+		clip_top--;
+}
+
+/**
+ * @brief Drop all pushed clip rectangles, drawing to the whole screen again
+ * @param none
+ * @return none
+ */
+void ST7789_ResetClip(void)
+{
+	clip_top = 0;
+	clip_overflow = 0;
+}
+
 /**
  * @brief Initialize ST7789 controller
  * @param none
@@ -176,22 +963,14 @@ void ST7789_Init(void)
 }
 
 /**
- * @brief Fill the DisplayWindow with single color
+ * @brief Fill the current clip rectangle with single color
+ * (the whole DisplayWindow unless a clip rectangle has been pushed)
  * @param color -> color to Fill with
  * @return none
  */
 void ST7789_Fill_Color(uint16_t color)
 {
-
-	uint16_t i, j;
-	ST7789_SetAddressWindow(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1);
-	ST7789_Select();
-	for (i = 0; i < ST7789_WIDTH; i++)
-		for (j = 0; j < ST7789_HEIGHT; j++) {
-			uint8_t data[] = {color >> 8, color & 0xFF};
-			ST7789_WriteData(data, sizeof(data));
-		}
-	ST7789_UnSelect();
+	ST7789_FillRect(CLIP.x0, CLIP.y0, CLIP.x1, CLIP.y1, color);
 }
 
 /**
@@ -202,14 +981,7 @@ void ST7789_Fill_Color(uint16_t color)
  */
 void ST7789_DrawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
-	if ((x < 0) || (x >= ST7789_WIDTH) ||
-		 (y < 0) || (y >= ST7789_HEIGHT))	return;
-	
-	ST7789_SetAddressWindow(x, y, x, y);
-	uint8_t data[] = {color >> 8, color & 0xFF};
-	ST7789_Select();
-	ST7789_WriteData(data, sizeof(data));
-	ST7789_UnSelect();
+	ST7789_PlotClipped(x, y, color);
 }
 
 /**
@@ -221,17 +993,7 @@ void ST7789_DrawPixel(uint16_t x, uint16_t y, uint16_t color)
  */
 void ST7789_Fill(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color)
 {
-	if ((xEnd < 0) || (xEnd >= ST7789_WIDTH) ||
-		 (yEnd < 0) || (yEnd >= ST7789_HEIGHT))	return;
-	ST7789_Select();
-	uint16_t i, j;
-	ST7789_SetAddressWindow(xSta, ySta, xEnd, yEnd);
-	for (i = ySta; i <= yEnd; i++)
-		for (j = xSta; j <= xEnd; j++) {
-			uint8_t data[] = {color >> 8, color & 0xFF};
-			ST7789_WriteData(data, sizeof(data));
-		}
-	ST7789_UnSelect();
+	ST7789_FillRect(xSta, ySta, xEnd, yEnd, color);
 }
 
 /**
@@ -242,25 +1004,37 @@ void ST7789_Fill(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uin
  */
 void ST7789_DrawPixel_4px(uint16_t x, uint16_t y, uint16_t color)
 {
-	if ((x <= 0) || (x > ST7789_WIDTH) ||
-		 (y <= 0) || (y > ST7789_HEIGHT))	return;
-	ST7789_Select();
-	ST7789_Fill(x - 1, y - 1, x + 1, y + 1, color);
-	ST7789_UnSelect();
+	ST7789_FillRect((int32_t)x - 1, (int32_t)y - 1, (int32_t)x + 1, (int32_t)y + 1, color);
 }
 
 /**
- * @brief Draw a line with single color
- * @param x1&y1 -> coordinate of the start point
- * @param x2&y2 -> coordinate of the end point
+ * @brief Draw a line with single color, using signed coordinates
+ * Horizontal and vertical lines become clipped fills. Other lines are
+ * tested against the clip rectangle once: lines entirely inside skip the
+ * per-pixel test, lines entirely on one side of it are dropped.
+ * @param x0&y0 -> coordinate of the start point
+ * @param x1&y1 -> coordinate of the end point
  * @param color -> color of the line to Draw
  * @return none
  */
-void ST7789_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
-        uint16_t color) {
-	uint16_t swap;
-    uint16_t steep = ABS(y1 - y0) > ABS(x1 - x0);
-    if (steep) {
+static void ST7789_Line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+	int32_t swap, dx, dy, err, ystep;
+	int32_t steep;
+	ST7789_Plot plot;
+
+	if (y0 == y1 || x0 == x1) {
+		ST7789_FillRect(x0, y0, x1, y1, color);
+		return;
+	}
+
+	if ((x0 < CLIP.x0 && x1 < CLIP.x0) || (x0 > CLIP.x1 && x1 > CLIP.x1) ||
+		(y0 < CLIP.y0 && y1 < CLIP.y0) || (y0 > CLIP.y1 && y1 > CLIP.y1))
+		return;
+	plot = ST7789_Inside(x0, y0) && ST7789_Inside(x1, y1) ? ST7789_PutPixel : ST7789_PlotClipped;
+
+	steep = ABS(y1 - y0) > ABS(x1 - x0);
+	if (steep) {
 		swap = x0;
 		x0 = y0;
 		y0 = swap;
@@ -268,11 +1042,9 @@ void ST7789_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
 		swap = x1;
 		x1 = y1;
 		y1 = swap;
-        //_swap_int16_t(x0, y0);
-        //_swap_int16_t(x1, y1);
-    }
+	}
 
-    if (x0 > x1) {
+	if (x0 > x1) {
 		swap = x0;
 		x0 = x1;
 		x1 = swap;
@@ -280,35 +1052,39 @@ void ST7789_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
 		swap = y0;
 		y0 = y1;
 		y1 = swap;
-        //_swap_int16_t(x0, x1);
-        //_swap_int16_t(y0, y1);
-    }
-
-    int16_t dx, dy;
-    dx = x1 - x0;
-    dy = ABS(y1 - y0);
-
-    int16_t err = dx / 2;
-    int16_t ystep;
-
-    if (y0 < y1) {
-        ystep = 1;
-    } else {
-        ystep = -1;
-    }
-
-    for (; x0<=x1; x0++) {
-        if (steep) {
-            ST7789_DrawPixel(y0, x0, color);
-        } else {
-            ST7789_DrawPixel(x0, y0, color);
-        }
-        err -= dy;
-        if (err < 0) {
-            y0 += ystep;
-            err += dx;
-        }
-    }
+	}
+
+	dx = x1 - x0;
+	dy = ABS(y1 - y0);
+	err = dx / 2;
+	ystep = y0 < y1 ? 1 : -1;
+
+	for (; x0 <= x1; x0++) {
+		if (steep) {
+			plot(y0, x0, color);
+		} else {
+			plot(x0, y0, color);
+		}
+		err -= dy;
+		if (err < 0) {
+			y0 += ystep;
+			err += dx;
+		}
+	}
+}
+
+/**
+ * @brief Draw a line with single color
+ * @param x1&y1 -> coordinate of the start point
+ * @param x2&y2 -> coordinate of the end point
+ * @param color -> color of the line to Draw
+ * @return none
+ */
+void ST7789_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
+        uint16_t color) {
+	ST7789_Select();
+	ST7789_Line(x0, y0, x1, y1, color);
+	ST7789_UnSelect();
 }
 
 /**
@@ -320,10 +1096,10 @@ void ST7789_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
 void ST7789_DrawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
 {
 	ST7789_Select();
-	ST7789_DrawLine(x1, y1, x2, y1, color);
-	ST7789_DrawLine(x1, y1, x1, y2, color);
-	ST7789_DrawLine(x1, y2, x2, y2, color);
-	ST7789_DrawLine(x2, y1, x2, y2, color);
+	ST7789_FillRect(x1, y1, x2, y1, color);
+	ST7789_FillRect(x1, y1, x1, y2, color);
+	ST7789_FillRect(x1, y2, x2, y2, color);
+	ST7789_FillRect(x2, y1, x2, y2, color);
 	ST7789_UnSelect();
 }
 
@@ -341,12 +1117,20 @@ void ST7789_DrawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color)
 	int16_t ddF_y = -2 * r;
 	int16_t x = 0;
 	int16_t y = r;
+	ST7789_Plot plot;
+
+	/* Test the bounding box once instead of every pixel */
+	if ((int32_t)x0 + r < CLIP.x0 || (int32_t)x0 - r > CLIP.x1 ||
+		(int32_t)y0 + r < CLIP.y0 || (int32_t)y0 - r > CLIP.y1)
+		return;
+	plot = ST7789_Inside((int32_t)x0 - r, (int32_t)y0 - r) && ST7789_Inside((int32_t)x0 + r, (int32_t)y0 + r) ?
+		ST7789_PutPixel : ST7789_PlotClipped;
 
 	ST7789_Select();
-	ST7789_DrawPixel(x0, y0 + r, color);
-	ST7789_DrawPixel(x0, y0 - r, color);
-	ST7789_DrawPixel(x0 + r, y0, color);
-	ST7789_DrawPixel(x0 - r, y0, color);
+	plot(x0, y0 + r, color);
+	plot(x0, y0 - r, color);
+	plot(x0 + r, y0, color);
+	plot(x0 - r, y0, color);
 
 	while (x < y) {
 		if (f >= 0) {
@@ -358,22 +1142,23 @@ void ST7789_DrawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color)
 		ddF_x += 2;
 		f += ddF_x;
 
-		ST7789_DrawPixel(x0 + x, y0 + y, color);
-		ST7789_DrawPixel(x0 - x, y0 + y, color);
-		ST7789_DrawPixel(x0 + x, y0 - y, color);
-		ST7789_DrawPixel(x0 - x, y0 - y, color);
+		plot(x0 + x, y0 + y, color);
+		plot(x0 - x, y0 + y, color);
+		plot(x0 + x, y0 - y, color);
+		plot(x0 - x, y0 - y, color);
 
 		
-		ST7789_DrawPixel(x0 + y, y0 + x, color);
-		ST7789_DrawPixel(x0 - y, y0 + x, color);
-		ST7789_DrawPixel(x0 + y, y0 - x, color);
-		ST7789_DrawPixel(x0 - y, y0 - x, color);
+		plot(x0 + y, y0 + x, color);
+		plot(x0 - y, y0 + x, color);
+		plot(x0 + y, y0 - x, color);
+		plot(x0 - y, y0 - x, color);
 	}
 	ST7789_UnSelect();
 }
 
 /**
  * @brief Draw an Image on the screen
+ * Parts of the image outside the clip rectangle are skipped.
  * @param x&y -> start point of the Image
  * @param w&h -> width & height of the Image to Draw
  * @param data -> pointer of the Image array
@@ -381,16 +1166,145 @@ void ST7789_DrawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color)
  */
 void ST7789_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data)
 {
-	if ((x >= ST7789_WIDTH) || (y >= ST7789_HEIGHT))
+	int32_t x0 = x, y0 = y, x1 = (int32_t)x + w - 1, y1 = (int32_t)y + h - 1;
+	int32_t row;
+
+	if (!ST7789_ClipBox(&x0, &y0, &x1, &y1))
+		return;
+
+	ST7789_Select();
+	ST7789_SetWindow(x0, y0, x1, y1);
+	if (x1 - x0 + 1 == w) {
+		/* Full rows are contiguous in the source */
+		ST7789_WritePixelData((uint8_t *)(data + (uint32_t)(y0 - y) * w), sizeof(uint16_t) * w * (y1 - y0 + 1));
+	}
+	else {
+		/* The window wraps by itself, only send the visible part of each row */
+		for (row = y0 - y; row <= y1 - y; row++)
+			ST7789_WritePixelData((uint8_t *)(data + (uint32_t)row * w + (x0 - x)), sizeof(uint16_t) * (x1 - x0 + 1));
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Draw a sprite, leaving pixels of the key color untouched
+ * @param x&y -> start point of the sprite, may be partially off-screen
+ * @param sprite -> the sprite to draw
+ * @param key -> transparent color (RGB565)
+ * @return none
+ */
+void ST7789_DrawSprite(int16_t x, int16_t y, SpriteDef sprite, uint16_t key)
+{
+	ST7789_DrawSpriteRegion(x, y, sprite, 0, 0, sprite.width, sprite.height, key);
+}
+
+/**
+ * @brief Draw a sub-rectangle of a sprite with a transparent color key
+ * Only opaque runs are sent, each one as its own single-row window,
+ * so transparent pixels cost no SPI bandwidth.
+ * @param x&y -> screen position of the sub-rectangle, may be partially off-screen
+ * @param sprite -> the sprite to draw from
+ * @param sx&sy -> top-left corner of the sub-rectangle inside the sprite
+ * @param sw&sh -> width & height of the sub-rectangle
+ * @param key -> transparent color (RGB565)
+ * @return none
+ */
+void ST7789_DrawSpriteRegion(int16_t x, int16_t y, SpriteDef sprite, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh, uint16_t key)
+{
+	int32_t x0, y0, x1, y1, row, col, run;
+	const uint16_t *src;
+
+	/* sprite data is stored in panel byte order */
+	uint16_t raw_key = (key >> 8) | (key << 8);
+
+	/* Keep the sub-rectangle inside the sprite */
+	if (sx >= sprite.width || sy >= sprite.height)
+		return;
+	if (sw > sprite.width - sx)
+		sw = sprite.width - sx;
+	if (sh > sprite.height - sy)
+		sh = sprite.height - sy;
+
+	/* Clip the destination against the clip rectangle */
+	x0 = x;
+	y0 = y;
+	x1 = x0 + sw - 1;
+	y1 = y0 + sh - 1;
+	if (sw == 0 || sh == 0 || !ST7789_ClipBox(&x0, &y0, &x1, &y1))
 		return;
-	if ((x + w - 1) >= ST7789_WIDTH)
+	sx += x0 - x;
+	sy += y0 - y;
+
+	ST7789_Select();
+	for (row = 0; row <= y1 - y0; row++) {
+		src = sprite.data + (uint32_t)(sy + row) * sprite.width + sx;
+		col = 0;
+		while (col <= x1 - x0) {
+			/* Skip the transparent pixels */
+			while (col <= x1 - x0 && src[col] == raw_key)
+				col++;
+			/* Send the following opaque run as one span */
+			run = col;
+			while (col <= x1 - x0 && src[col] != raw_key)
+				col++;
+			if (col > run) {
+				ST7789_SetWindow(x0 + run, y0 + row, x0 + col - 1, y0 + row);
+				ST7789_WritePixelData((uint8_t *)&src[run], sizeof(uint16_t) * (col - run));
+			}
+		}
+	}
+	ST7789_UnSelect();
+}
+
+/**
+ * @brief Stream generated pixels into a block without a framebuffer
+ * One address window is opened for the whole block, then the generator
+ * fills one line buffer while the previous row is still being sent.
+ * @param x&y -> start point of the block, may be partially clipped
+ * @param w&h -> width & height of the block (w up to ST7789_WIDTH)
+ * @param gen -> called once per visible row to produce a full row of w pixels
+ * @param ctx -> passed through to the generator
+ * @return none
+ */
+void ST7789_WritePixels(int16_t x, int16_t y, uint16_t w, uint16_t h, ST7789_PixelGenerator gen, void *ctx)
+{
+	int32_t x0 = x, y0 = y, x1 = (int32_t)x + w - 1, y1 = (int32_t)y + h - 1;
+	int32_t row, i, n;
+	uint16_t *line;
+	uint8_t cur = 0;
+
+	if (w == 0 || h == 0 || w > ST7789_WIDTH || !ST7789_ClipBox(&x0, &y0, &x1, &y1))
 		return;
-	if ((y + h - 1) >= ST7789_HEIGHT)
+	n = x1 - x0 + 1;
+
+#ifdef ST7789_USE_FRAMEBUFFER
+	if (FB_ACTIVE()) {
+		ST7789_SetWindow(x0, y0, x1, y1);
+		for (row = y0 - y; row <= y1 - y; row++) {
+			gen(row, line_buf[0], w, ctx);
+			for (i = 0; i < n; i++)
+				ST7789_FB_Push(line_buf[0][x0 - x + i]);
+		}
 		return;
+	}
+#endif
 
+	ST7789_SetAddressWindow(x0, y0, x1, y1);
 	ST7789_Select();
-	ST7789_SetAddressWindow(x, y, x + w - 1, y + h - 1);
-	ST7789_WriteData((uint8_t *)data, sizeof(uint16_t) * w * h);
+	ST7789_DC_Set();
+	for (row = y0 - y; row <= y1 - y; row++) {
+		gen(row, line_buf[cur], w, ctx);
+
+		/* Only the visible part is sent, in panel byte order */
+		line = line_buf[cur] + (x0 - x);
+		for (i = 0; i < n; i++)
+			line[i] = (line[i] >> 8) | (line[i] << 8);
+
+		ST7789_WaitData();
+		ST7789_StartData((uint8_t *)line, n * sizeof(uint16_t));
+		cur ^= 1;
+	}
+	ST7789_WaitData();
 	ST7789_UnSelect();
 }
 
@@ -406,6 +1320,35 @@ void ST7789_InvertColors(uint8_t invert)
 	ST7789_UnSelect();
 }
 
+/**
+ * @brief Write a char at signed coordinates, clipped once up front
+ */
+static void ST7789_Char(int32_t x, int32_t y, char ch, FontDef font, uint16_t color, uint16_t bgcolor)
+{
+	int32_t x0 = x, y0 = y, x1 = x + font.width - 1, y1 = y + font.height - 1;
+	uint32_t i, b, j, n;
+	uint8_t data[2 * 16];
+
+	/* Clip the glyph box once, then only walk its visible rows and columns */
+	if (!ST7789_ClipBox(&x0, &y0, &x1, &y1))
+		return;
+
+	ST7789_Select();
+	ST7789_SetWindow(x0, y0, x1, y1);
+
+	for (i = y0 - y; i <= (uint32_t)(y1 - y); i++) {
+		b = font.data[(ch - 32) * font.height + i];
+		n = 0;
+		for (j = x0 - x; j <= (uint32_t)(x1 - x); j++) {
+			uint16_t c = ((b << j) & 0x8000) ? color : bgcolor;
+			data[n++] = c >> 8;
+			data[n++] = c & 0xFF;
+		}
+		ST7789_WritePixelData(data, n);
+	}
+	ST7789_UnSelect();
+}
+
 /** 
  * @brief Write a char
  * @param  x&y -> cursor of the start point.
@@ -417,24 +1360,7 @@ void ST7789_InvertColors(uint8_t invert)
  */
 void ST7789_WriteChar(uint16_t x, uint16_t y, char ch, FontDef font, uint16_t color, uint16_t bgcolor)
 {
-	uint32_t i, b, j;
-	ST7789_Select();
-	ST7789_SetAddressWindow(x, y, x + font.width - 1, y + font.height - 1);
-
-	for (i = 0; i < font.height; i++) {
-		b = font.data[(ch - 32) * font.height + i];
-		for (j = 0; j < font.width; j++) {
-			if ((b << j) & 0x8000) {
-				uint8_t data[] = {color >> 8, color & 0xFF};
-				ST7789_WriteData(data, sizeof(data));
-			}
-			else {
-				uint8_t data[] = {bgcolor >> 8, bgcolor & 0xFF};
-				ST7789_WriteData(data, sizeof(data));
-			}
-		}
-	}
-	ST7789_UnSelect();
+	ST7789_Char(x, y, ch, font, color, bgcolor);
 }
 
 /** 
@@ -470,39 +1396,143 @@ void ST7789_WriteString(uint16_t x, uint16_t y, const char *str, FontDef font, u
 	ST7789_UnSelect();
 }
 
-/** 
- * @brief Draw a filled Rectangle with single color
- * @param  x&y -> coordinates of the starting point
- * @param w&h -> width & height of the Rectangle
- * @param color -> color of the Rectangle
- * @return  none
+/**
+ * @brief Draw a char magnified by an integer factor
+ * Each font row is expanded once into replicated runs, copied for the
+ * screen rows it covers and sent as a single block, so a glyph costs one
+ * transfer per font row instead of one per scaled pixel.
+ * @param x&y -> top-left corner of the scaled char
+ * @param ch -> char to write
+ * @param font -> fontstyle of the char
+ * @param color -> color of the char
+ * @param bgcolor -> background color of the char
+ * @param scale -> 1 .. ST7789_MAX_SCALE
+ * @return none
  */
-void ST7789_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+static void ST7789_CharScaled(int32_t x, int32_t y, char ch, FontDef font, uint16_t color, uint16_t bgcolor, uint8_t scale)
 {
+	int32_t x0 = x, y0 = y, x1 = x + font.width * scale - 1, y1 = y + font.height * scale - 1;
+	int32_t r, last;
+	uint32_t b, j, n, k, w;
+	uint8_t *block = (uint8_t *)line_buf[0];
+
+	if (!ST7789_ClipBox(&x0, &y0, &x1, &y1))
+		return;
+	w = 2 * (x1 - x0 + 1);
+
 	ST7789_Select();
-	uint8_t i;
+	ST7789_SetWindow(x0, y0, x1, y1);
+
+	for (r = y0; r <= y1; r = last + 1) {
+		/* Screen rows r .. last all come from the same font row */
+		b = font.data[(ch - 32) * font.height + (r - y) / scale];
+		last = y + ((r - y) / scale + 1) * scale - 1;
+		if (last > y1)
+			last = y1;
+
+		n = 0;
+		for (j = x0 - x; j <= (uint32_t)(x1 - x); j++) {
+			uint16_t c = ((b << (j / scale)) & 0x8000) ? color : bgcolor;
+			block[n++] = c >> 8;
+			block[n++] = c & 0xFF;
+		}
+		for (k = 1; k <= (uint32_t)(last - r); k++)
+			memcpy(block + k * w, block, w);
+		ST7789_WritePixelData(block, n * (last - r + 1));
+	}
+	ST7789_UnSelect();
+}
 
-	/* Check input parameters */
-	if (x >= ST7789_WIDTH ||
-		y >= ST7789_HEIGHT) {
-		/* Return error */
+/**
+ * @brief Write a string magnified by an integer factor, e.g. for titles
+ * Gives large text from the small fonts, without a bigger table in flash.
+ * Text that does not fit is clipped, it does not wrap.
+ * @param x&y -> cursor of the start point.
+ * @param str -> string to write
+ * @param font -> fontstyle of the string
+ * @param color -> color of the string
+ * @param bgcolor -> background color of the string
+ * @param scale -> 1 .. ST7789_MAX_SCALE
+ * @return none
+ */
+void ST7789_WriteStringScaled(uint16_t x, uint16_t y, const char *str, FontDef font, uint16_t color, uint16_t bgcolor, uint8_t scale)
+{
+	int32_t cx = x;
+
+	if (scale < 1 || scale > ST7789_MAX_SCALE)
 		return;
+
+	while (*str) {
+		ST7789_CharScaled(cx, y, *str, font, color, bgcolor, scale);
+		cx += font.width * scale;
+		str++;
 	}
+}
 
-	/* Check width and height */
-	if ((x + w) >= ST7789_WIDTH) {
-		w = ST7789_WIDTH - x;
+/**
+ * @brief Write a string turned by a quarter, e.g. for vertical labels
+ * The panel is switched to the neighbouring rotation, where the text is
+ * horizontal, so the glyphs stream row by row exactly like WriteString
+ * and cost the same bandwidth. The orientation is restored afterwards.
+ * Assumes rotation n + 1 shows the picture turned 90 degrees clockwise
+ * from rotation n, and that the neighbouring rotations use no X/Y_SHIFT.
+ * @param x&y -> top-left corner of the text's box on screen
+ * @param str -> string to write
+ * @param font -> fontstyle of the string
+ * @param color -> color of the string
+ * @param bgcolor -> background color of the string
+ * @param dir -> ST7789_TEXT_DOWN (top to bottom) or ST7789_TEXT_UP (bottom to top)
+ * @return none
+ */
+void ST7789_WriteStringRotated(uint16_t x, uint16_t y, const char *str, FontDef font, uint16_t color, uint16_t bgcolor, uint8_t dir)
+{
+	ST7789_Rect saved = CLIP;
+	int32_t len = strlen(str), xb, yb;
+
+	if (dir != ST7789_TEXT_DOWN && dir != ST7789_TEXT_UP)
+		return;
+
+	/* Position of the text and of the clip rectangle in the turned frame */
+	if (dir == ST7789_TEXT_DOWN) {
+		xb = y;
+		yb = ST7789_WIDTH - x - font.height;
+		CLIP.x0 = saved.y0;
+		CLIP.x1 = saved.y1;
+		CLIP.y0 = ST7789_WIDTH - 1 - saved.x1;
+		CLIP.y1 = ST7789_WIDTH - 1 - saved.x0;
 	}
-	if ((y + h) >= ST7789_HEIGHT) {
-		h = ST7789_HEIGHT - y;
+	else {
+		xb = ST7789_HEIGHT - y - len * font.width;
+		yb = x;
+		CLIP.x0 = ST7789_HEIGHT - 1 - saved.y1;
+		CLIP.x1 = ST7789_HEIGHT - 1 - saved.y0;
+		CLIP.y0 = saved.x0;
+		CLIP.y1 = saved.x1;
 	}
 
-	/* Draw lines */
-	for (i = 0; i <= h; i++) {
-		/* Draw lines */
-		ST7789_DrawLine(x, y + i, x + w, y + i, color);
-	}
-	ST7789_UnSelect();
+	frame_turn = dir;
+	if (!FB_ACTIVE())
+		ST7789_SetRotation((ST7789_ROTATION + dir) % 4);
+
+	for (; *str; str++, xb += font.width)
+		ST7789_Char(xb, yb, *str, font, color, bgcolor);
+
+	frame_turn = 0;
+	if (!FB_ACTIVE())
+		ST7789_SetRotation(ST7789_ROTATION);
+	CLIP = saved;
+}
+
+/** 
+ * @brief Draw a filled Rectangle with single color
+ * @param  x&y -> coordinates of the starting point
+ * @param w&h -> width & height of the Rectangle
+ * @param color -> color of the Rectangle
+ * @return  none
+ */
+void ST7789_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	ST7789_FillRect(x, y, (int32_t)x + w, (int32_t)y + h, color);
 }
 
 /** 
@@ -605,11 +1635,11 @@ void ST7789_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
 	int16_t x = 0;
 	int16_t y = r;
 
-	ST7789_DrawPixel(x0, y0 + r, color);
-	ST7789_DrawPixel(x0, y0 - r, color);
-	ST7789_DrawPixel(x0 + r, y0, color);
-	ST7789_DrawPixel(x0 - r, y0, color);
-	ST7789_DrawLine(x0 - r, y0, x0 + r, y0, color);
+	ST7789_PlotClipped(x0, y0 + r, color);
+	ST7789_PlotClipped(x0, y0 - r, color);
+	ST7789_PlotClipped(x0 + r, y0, color);
+	ST7789_PlotClipped(x0 - r, y0, color);
+	ST7789_Line(x0 - r, y0, x0 + r, y0, color);
 
 	while (x < y) {
 		if (f >= 0) {
@@ -621,11 +1651,11 @@ void ST7789_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
 		ddF_x += 2;
 		f += ddF_x;
 
-		ST7789_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-		ST7789_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
+		ST7789_Line(x0 - x, y0 + y, x0 + x, y0 + y, color);
+		ST7789_Line(x0 + x, y0 - y, x0 - x, y0 - y, color);
 
-		ST7789_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-		ST7789_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
+		ST7789_Line(x0 + y, y0 + x, x0 - y, y0 + x, color);
+		ST7789_Line(x0 + y, y0 - x, x0 - y, y0 - x, color);
 	}
 	ST7789_UnSelect();
 }
@@ -640,11 +1670,11 @@ void ST7789_Draw_Semicircle_up(int16_t x0, int16_t y0, int16_t r, uint16_t color
 	int16_t x = 0;
 	int16_t y = r;
 
-	ST7789_DrawPixel(x0, y0 + r, color);
+	ST7789_PlotClipped(x0, y0 + r, color);
 	//ST7789_DrawPixel(x0, y0 - r, color);
-	ST7789_DrawPixel(x0 + r, y0, color);
-	ST7789_DrawPixel(x0 - r, y0, color);
-	ST7789_DrawLine(x0 - r, y0, x0 + r, y0, color);
+	ST7789_PlotClipped(x0 + r, y0, color);
+	ST7789_PlotClipped(x0 - r, y0, color);
+	ST7789_Line(x0 - r, y0, x0 + r, y0, color);
 
 	while (x < y) {
 		if (f >= 0) {
@@ -656,10 +1686,10 @@ void ST7789_Draw_Semicircle_up(int16_t x0, int16_t y0, int16_t r, uint16_t color
 		ddF_x += 2;
 		f += ddF_x;
 
-		ST7789_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
+		ST7789_Line(x0 - x, y0 + y, x0 + x, y0 + y, color);
 		//ST7789_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
 
-		ST7789_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
+		ST7789_Line(x0 + y, y0 + x, x0 - y, y0 + x, color);
 		//ST7789_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
 	}
 	ST7789_UnSelect();
@@ -676,10 +1706,10 @@ void ST7789_Draw_Semicircle_down(int16_t x0, int16_t y0, int16_t r, uint16_t col
 	int16_t y = r;
 
 	//ST7789_DrawPixel(x0, y0 + r, color);
-	ST7789_DrawPixel(x0, y0 - r, color);
-	ST7789_DrawPixel(x0 + r, y0, color);
-	ST7789_DrawPixel(x0 - r, y0, color);
-	ST7789_DrawLine(x0 - r, y0, x0 + r, y0, color);
+	ST7789_PlotClipped(x0, y0 - r, color);
+	ST7789_PlotClipped(x0 + r, y0, color);
+	ST7789_PlotClipped(x0 - r, y0, color);
+	ST7789_Line(x0 - r, y0, x0 + r, y0, color);
 
 	while (x < y) {
 		if (f >= 0) {
@@ -692,10 +1722,10 @@ void ST7789_Draw_Semicircle_down(int16_t x0, int16_t y0, int16_t r, uint16_t col
 		f += ddF_x;
 
 		//ST7789_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-		ST7789_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
+		ST7789_Line(x0 + x, y0 - y, x0 - x, y0 - y, color);
 
 		//ST7789_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-		ST7789_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
+		ST7789_Line(x0 + y, y0 - x, x0 - y, y0 - x, color);
 	}
 	ST7789_UnSelect();
 }
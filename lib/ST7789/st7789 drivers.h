@@ -5,6 +5,7 @@
 #ifndef __ST7789_H
 #define __ST7789_H
 
+#include <stdbool.h>
 #include "fonts.h"
 #include "pinmappings.h"
 
@@ -13,6 +14,27 @@
 #define ST7789_SPI_PORT hspi1
 extern SPI_HandleTypeDef ST7789_SPI_PORT;
 
+/* If u need DMA, uncomment below (MX_DMA_Init must run before MX_SPI1_Init) */
+#define USE_DMA
+
+#ifdef USE_DMA
+/* Smaller transfers are sent by polling, DMA setup costs more than it saves */
+#define DMA_MIN_SIZE 16
+#endif
+
+/**
+ * Comment below to draw straight to the panel only.
+ * ST7789_FB_Begin then redirects drawing into a 2bpp framebuffer
+ * (ST7789_WIDTH * ST7789_HEIGHT / 4 bytes of RAM) with a 4 color palette
+ * per row, and ST7789_FB_Flush sends only the rows that changed.
+ */
+#define ST7789_USE_FRAMEBUFFER
+
+#ifdef ST7789_USE_FRAMEBUFFER
+/* Bytes of RAM set aside for screen snapshots (see ST7789_FB_Capture) */
+#define ST7789_SNAPSHOT_POOL 16384
+#endif
+
 /* Pin connection*/
 #define ST7789_RST_PORT ST7789_RST_GPIO_Port
 #define ST7789_RST_PIN ST7789_RST_Pin
@@ -202,6 +224,16 @@ extern SPI_HandleTypeDef ST7789_SPI_PORT;
 #define ST7789_COLOR_MODE_16bit 0x55    //  RGB565 (16bit)
 #define ST7789_COLOR_MODE_18bit 0x66    //  RGB666 (18bit)
 
+/* Directions for ST7789_WriteStringRotated */
+#define ST7789_TEXT_DOWN 1	/* reads top to bottom, turned 90 degrees clockwise */
+#define ST7789_TEXT_UP 3	/* reads bottom to top, turned 90 degrees counter-clockwise */
+
+/* Largest factor ST7789_WriteStringScaled accepts */
+#define ST7789_MAX_SCALE 4
+
+/* How many clip rectangles can be pushed on top of the full screen */
+#define ST7789_CLIP_DEPTH 4
+
 /* Basic operations */
 #define ST7789_RST_Clr() HAL_GPIO_WritePin(ST7789_RST_PORT, ST7789_RST_PIN, GPIO_PIN_RESET)
 #define ST7789_RST_Set() HAL_GPIO_WritePin(ST7789_RST_PORT, ST7789_RST_PIN, GPIO_PIN_SET)
@@ -214,6 +246,28 @@ extern SPI_HandleTypeDef ST7789_SPI_PORT;
 
 #define ABS(x) ((x) > 0 ? (x) : -(x))
 
+/**
+ * A sprite is an RGB565 image stored in the same byte order as the
+ * images passed to ST7789_DrawImage (ready to be sent to the panel).
+ */
+typedef struct {
+	uint16_t width;
+	uint16_t height;
+	const uint16_t *data;
+} SpriteDef;
+
+/* A compressed copy of a whole screen, made by ST7789_FB_Capture */
+typedef struct {
+	const uint8_t *data;
+	uint16_t size;
+} ST7789_Snapshot;
+
+/**
+ * Pixel generator for ST7789_WritePixels: fills line[0..width-1] with the
+ * RGB565 colors of the given row (counted from the top of the block).
+ */
+typedef void (*ST7789_PixelGenerator)(uint16_t row, uint16_t *line, uint16_t width, void *ctx);
+
 /* Basic functions. */
 void ST7789_Init(void);
 void ST7789_SetRotation(uint8_t m);
@@ -227,11 +281,40 @@ void ST7789_DrawLine(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_
 void ST7789_DrawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
 void ST7789_DrawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color);
 void ST7789_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data);
+void ST7789_DrawSprite(int16_t x, int16_t y, SpriteDef sprite, uint16_t key);
+void ST7789_DrawSpriteRegion(int16_t x, int16_t y, SpriteDef sprite, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh, uint16_t key);
+void ST7789_WritePixels(int16_t x, int16_t y, uint16_t w, uint16_t h, ST7789_PixelGenerator gen, void *ctx);
 void ST7789_InvertColors(uint8_t invert);
 
+/* Framebuffer functions. */
+#ifdef ST7789_USE_FRAMEBUFFER
+void ST7789_FB_Begin(uint16_t color);
+void ST7789_FB_Flush(void);
+bool ST7789_FB_FlushStep(void);
+void ST7789_FB_Release(void);
+void ST7789_FB_End(void);
+bool ST7789_FB_Capture(ST7789_Snapshot *snap);
+void ST7789_FB_Restore(const ST7789_Snapshot *snap);
+#else
+#define ST7789_FB_Begin(color) ((void)(color))
+#define ST7789_FB_Flush() ((void)0)
+#define ST7789_FB_FlushStep() (false)
+#define ST7789_FB_Release() ((void)0)
+#define ST7789_FB_End() ((void)0)
+#define ST7789_FB_Capture(snap) ((void)(snap), false)
+#define ST7789_FB_Restore(snap) ((void)(snap))
+#endif
+
+/* Clipping functions. */
+void ST7789_PushClip(int16_t x, int16_t y, uint16_t w, uint16_t h);
+void ST7789_PopClip(void);
+void ST7789_ResetClip(void);
+
 /* Text functions. */
 void ST7789_WriteChar(uint16_t x, uint16_t y, char ch, FontDef font, uint16_t color, uint16_t bgcolor);
 void ST7789_WriteString(uint16_t x, uint16_t y, const char *str, FontDef font, uint16_t color, uint16_t bgcolor);
+void ST7789_WriteStringScaled(uint16_t x, uint16_t y, const char *str, FontDef font, uint16_t color, uint16_t bgcolor, uint8_t scale);
+void ST7789_WriteStringRotated(uint16_t x, uint16_t y, const char *str, FontDef font, uint16_t color, uint16_t bgcolor, uint8_t dir);
 
 /* Extented Graphical functions. */
 void ST7789_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
@@ -0,0 +1,129 @@
+// Cooperative run-to-completion scheduler
+
+#include <stddef.h>
+#include "scheduler.h"
+
+typedef struct {
+    SchedHandler handler;
+    uint16_t event;
+    uint32_t arg;
+} SchedEvent;
+
+typedef struct {
+    SchedHandler handler; // NULL while the timer is free
+    uint16_t event;
+    uint32_t due;
+    uint32_t period;
+} SchedTimerSlot;
+
+// Events are only posted and taken from the main loop, never from interrupts,
+// so the queue needs no protection. Interrupts hand their data to a poller instead
+static SchedEvent queue[SCHED_QUEUE_SIZE];
+static uint16_t head = 0;
+static uint16_t tail = 0;
+
+static SchedTimerSlot timers[SCHED_TIMERS];
+static SchedPoller pollers[SCHED_POLLERS];
+static uint8_t pollerCount = 0;
+static SchedClock now = NULL;
+
+// Purpose: Forgets every event, timer and poller and sets the clock the timers run on
+void SchedInit(SchedClock clock){
+    now = clock;
+    head = tail = 0;
+    pollerCount = 0;
+    for (int i = 0 ; i < SCHED_TIMERS ; i++){
+        timers[i].handler = NULL;
+    }
+}
+
+// Purpose: Returns the current time of the scheduler's clock
+uint32_t SchedNow(void){
+    return now();
+}
+
+// Purpose: Adds an event to the end of the queue. Returns false if the queue is full
+bool SchedPost(SchedHandler handler, uint16_t event, uint32_t arg){
+    if ((uint16_t)(head - tail) >= SCHED_QUEUE_SIZE){
+        return false;
+    }
+    queue[head & (SCHED_QUEUE_SIZE - 1)].handler = handler;
+    queue[head & (SCHED_QUEUE_SIZE - 1)].event = event;
+    queue[head & (SCHED_QUEUE_SIZE - 1)].arg = arg;
+    head++;
+    return true;
+}
+
+// Purpose: Starts a timer that posts event (with the timer as argument) after delay,
+//          and then every period if period is not 0. Returns the timer, or -1 if all are in use
+int SchedTimer(SchedHandler handler, uint16_t event, uint32_t delay, uint32_t period){
+    for (int i = 0 ; i < SCHED_TIMERS ; i++){
+        if (timers[i].handler == NULL){
+            timers[i].handler = handler;
+            timers[i].event = event;
+            timers[i].due = now() + delay;
+            timers[i].period = period;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Purpose: Stops a timer. An event it already posted is still handled
+void SchedCancel(int timer){
+    if (timer >= 0 && timer < SCHED_TIMERS){
+        timers[timer].handler = NULL;
+    }
+}
+
+// Purpose: Adds a function that is called on every pass to service hardware
+bool SchedAddPoller(SchedPoller poller){
+    if (pollerCount >= SCHED_POLLERS){
+        return false;
+    }
+    pollers[pollerCount++] = poller;
+    return true;
+}
+
+// Purpose: Does one pass of the scheduler: posts the events of the timers that are due,
+//          calls every poller, and then handles the oldest event. Returns false if nothing
+//          happened, so the caller can sleep until the next interrupt
+bool SchedRunOnce(void){
+    bool busy = false;
+    uint32_t time = now();
+    SchedEvent event;
+
+    for (int i = 0 ; i < SCHED_TIMERS ; i++){
+        // Signed difference, so the clock may wrap around
+        if (timers[i].handler != NULL && (int32_t)(time - timers[i].due) >= 0){
+            if (!SchedPost(timers[i].handler, timers[i].event, i)){
+                continue; // Queue is full, try again on the next pass
+            }
+            if (timers[i].period != 0){
+                timers[i].due += timers[i].period;
+                // Skip the periods that were missed instead of firing for each of them
+                if ((int32_t)(time - timers[i].due) >= 0){
+                    timers[i].due = time + timers[i].period;
+                }
+            }
+            else{
+                timers[i].handler = NULL;
+            }
+            busy = true;
+        }
+    }
+
+    for (int i = 0 ; i < pollerCount ; i++){
+        if (pollers[i]()){
+            busy = true;
+        }
+    }
+
+    if (head != tail){
+        event = queue[tail & (SCHED_QUEUE_SIZE - 1)];
+        tail++;
+        event.handler(event.event, event.arg);
+        busy = true;
+    }
+    return busy;
+}
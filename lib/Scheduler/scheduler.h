@@ -0,0 +1,35 @@
+// Cooperative run-to-completion scheduler
+
+// Work is split into short handlers that never wait. A handler is called with
+// an event (a number and an argument) and returns as soon as it has dealt with
+// it. Events come from three places:
+//   - SchedPost(), from handlers or from code that noticed something
+//   - timers, which post their event once or periodically
+//   - pollers, which are called on every pass to service hardware (button
+//     queue, display DMA, serial port) and post events when something happened
+// Time comes from a clock function given to SchedInit, so a host build can
+// drive the scheduler with a virtual clock.
+
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHED_QUEUE_SIZE 16 // events waiting to be handled, must be a power of 2
+#define SCHED_TIMERS 8      // timers that can run at the same time
+#define SCHED_POLLERS 4     // hardware services called on every pass
+
+typedef void (*SchedHandler)(uint16_t event, uint32_t arg);
+typedef bool (*SchedPoller)(void); // returns true while it still has work to do
+typedef uint32_t (*SchedClock)(void); // any unit, timer delays are in the same unit
+
+void SchedInit(SchedClock clock); // Clears all events, timers and pollers
+uint32_t SchedNow(void); // Current time of the scheduler's clock
+bool SchedPost(SchedHandler handler, uint16_t event, uint32_t arg); // Queues an event, false if the queue is full
+int SchedTimer(SchedHandler handler, uint16_t event, uint32_t delay, uint32_t period); // Posts event after delay, then every period (0 = once). Returns the timer, -1 if none is free
+void SchedCancel(int timer); // Stops a timer, nothing happens for -1
+bool SchedAddPoller(SchedPoller poller); // Adds a hardware service, false if there is no room
+bool SchedRunOnce(void); // One pass: due timers, pollers, then one event. Returns false if there was nothing to do
+
+#endif
@@ -0,0 +1,76 @@
+// Word order: a different order of the dictionary every game, without a table of it
+
+#include "shuffle.h"
+
+// Purpose: Marsaglia's xorshift32. Never gives 0, and goes through every other 32-bit number
+uint32_t ShuffleRandom(uint32_t *state){
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Purpose: Combines a value into the seed and spreads every bit of it over the whole result
+//          (the murmur3 finalizer), so a few noisy low bits are enough to change everything
+uint32_t ShuffleMix(uint32_t seed, uint32_t value){
+    uint32_t hash = seed ^ value;
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BUL;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35UL;
+    hash ^= hash >> 16;
+    return hash + 0x9E3779B9UL; // So a seed of 0 mixed with 0 does not stay 0
+}
+
+// Purpose: Sizes the network for count and draws its keys from the seed
+void ShuffleInit(Shuffle *shuffle, uint32_t count, uint32_t seed){
+    uint32_t state = ShuffleMix(seed, count);
+
+    if (state == 0){
+        state = 1;
+    }
+    shuffle->count = count;
+    shuffle->half = 1;
+    while (shuffle->half < 16 && (1UL << (2 * shuffle->half)) < count){
+        shuffle->half++;
+    }
+    for (int i = 0 ; i < SHUFFLE_ROUNDS ; i++){
+        shuffle->keys[i] = ShuffleRandom(&state);
+    }
+}
+
+// Purpose: The round function, any mix of the half and the key will do
+static uint32_t ShuffleRound(uint32_t half, uint32_t key){
+    uint32_t x = (half ^ key) * 0x9E3779B1UL;
+
+    x ^= x >> 15;
+    x *= 0x85EBCA77UL;
+    x ^= x >> 13;
+    return x;
+}
+
+// Purpose: Returns the index index is shuffled to. The network's range is less than 4 times count,
+//          so it takes under 4 passes on average to land inside
+uint32_t ShuffleAt(const Shuffle *shuffle, uint32_t index){
+    uint32_t mask = (1UL << shuffle->half) - 1;
+    uint32_t left, right, next;
+
+    if (shuffle->count == 0){
+        return 0;
+    }
+    do{
+        left = index >> shuffle->half;
+        right = index & mask;
+        for (int i = 0 ; i < SHUFFLE_ROUNDS ; i++){
+            next = left ^ (ShuffleRound(right, shuffle->keys[i]) & mask);
+            left = right;
+            right = next;
+        }
+        index = (left << shuffle->half) | right;
+    } while (index >= shuffle->count);
+    return index;
+}
@@ -0,0 +1,29 @@
+// Word order: a different order of the dictionary every game, without a table of it
+
+// ShuffleAt() maps the i-th word of a game to a dictionary index with a small
+// Feistel network, which is a bijection on numbers of 2 * half bits for any keys.
+// Indexes past the end of the dictionary are run through it again until they
+// land inside (cycle walking), so every word comes exactly once, and only the
+// keys are kept in RAM. The keys come from a xorshift generator, seeded with
+// whatever randomness the board has, see ShuffleMix().
+
+#ifndef __SHUFFLE_H
+#define __SHUFFLE_H
+
+#include <stdint.h>
+
+#define SHUFFLE_ROUNDS 12 // Feistel rounds. Small dictionaries have only a few bits per half, which takes
+                          // this many before the words that follow each other are no longer related
+
+typedef struct {
+    uint32_t count; // The order goes over 0 to count - 1
+    uint8_t half;   // Bits in each half of the Feistel network
+    uint32_t keys[SHUFFLE_ROUNDS];
+} Shuffle;
+
+uint32_t ShuffleRandom(uint32_t *state); // xorshift32, the next number from a state that is not 0
+uint32_t ShuffleMix(uint32_t seed, uint32_t value); // Stirs a noisy value into a seed
+void ShuffleInit(Shuffle *shuffle, uint32_t count, uint32_t seed); // Picks the order for this seed
+uint32_t ShuffleAt(const Shuffle *shuffle, uint32_t index); // Where index goes in the order
+
+#endif
@@ -0,0 +1,70 @@
+// RTC backup registers of the STM32F401, where the game snapshot is kept
+
+#include "backup.h"
+#include "stm32f4xx_hal.h"
+
+static uint16_t sequence = 0; // Sequence number of the newest snapshot
+static int newest = -1;       // Its slot, -1 if neither slot has one
+
+// Purpose: Returns the first register of a slot. BKP0R to BKP19R follow each other
+static volatile uint32_t *BackupSlot(int slot){
+    return &RTC->BKP0R + slot * SNAPSHOT_WORDS;
+}
+
+// Purpose: Reads a slot and unpacks it, false if it has no good snapshot
+static bool BackupRead(int slot, Snapshot *snapshot, uint16_t *number){
+    uint32_t words[SNAPSHOT_WORDS];
+
+    for (int i = 0 ; i < SNAPSHOT_WORDS ; i++){
+        words[i] = BackupSlot(slot)[i];
+    }
+    return SnapshotDecode(snapshot, number, words);
+}
+
+// Purpose: Turns on the power controller's clock and lifts the write protection of the backup domain.
+//          The registers can then be read and written like memory, the RTC itself does not have to run
+void BackupSetup(void){
+    Snapshot snapshot;
+    uint16_t number;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    newest = -1;
+    for (int slot = 0 ; slot < BACKUP_SLOTS ; slot++){
+        if (BackupRead(slot, &snapshot, &number) && (newest < 0 || SnapshotNewer(number, sequence))){
+            newest = slot;
+            sequence = number;
+        }
+    }
+}
+
+// Purpose: Packs the snapshot into the slot that does not have the newest one. The check word goes last,
+//          so until the whole snapshot is written the slot does not pass as one
+void BackupSave(const Snapshot *snapshot){
+    uint32_t words[SNAPSHOT_WORDS];
+    int slot = newest == 0 ? 1 : 0;
+
+    sequence++;
+    SnapshotEncode(snapshot, sequence, words);
+    BackupSlot(slot)[0] = 0;
+    for (int i = SNAPSHOT_WORDS - 1 ; i >= 0 ; i--){
+        BackupSlot(slot)[i] = words[i];
+    }
+    newest = slot;
+}
+
+// Purpose: Unpacks the newest snapshot BackupSetup() found or BackupSave() wrote
+bool BackupLoad(Snapshot *snapshot){
+    uint16_t number;
+
+    return newest >= 0 && BackupRead(newest, snapshot, &number);
+}
+
+// Purpose: Zeroes both slots. No check word matches all 0, see SNAPSHOT_MAGIC
+void BackupClear(void){
+    for (int i = 0 ; i < BACKUP_SLOTS * SNAPSHOT_WORDS ; i++){
+        BackupSlot(0)[i] = 0;
+    }
+    newest = -1;
+}
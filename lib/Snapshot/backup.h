@@ -0,0 +1,23 @@
+// RTC backup registers of the STM32F401, where the game snapshot is kept
+
+// The 20 backup registers are in the backup domain, which a reset, a
+// watchdog or a brownout leaves alone as long as VBAT has power (on the
+// Nucleo VBAT is tied to VDD, so unplugging the board does clear them).
+// The F401 has no backup SRAM, these 80 bytes are all there is. Two
+// snapshots of 6 registers are kept, each save going over the older one,
+// so a reset while saving still leaves the one before it.
+
+#ifndef __BACKUP_H
+#define __BACKUP_H
+
+#include <stdbool.h>
+#include "snapshot.h"
+
+#define BACKUP_SLOTS 2 // Snapshots kept, SNAPSHOT_WORDS registers each
+
+void BackupSetup(void); // Allows writing the backup registers and finds the newest snapshot's sequence number
+void BackupSave(const Snapshot *snapshot); // Saves over the older snapshot
+bool BackupLoad(Snapshot *snapshot); // The newest good snapshot, false if there is none
+void BackupClear(void); // Forgets both snapshots, e.g. when the game is over
+
+#endif
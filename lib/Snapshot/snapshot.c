@@ -0,0 +1,54 @@
+// Game snapshot: what it takes to go on with a game after a reset, in a few words
+
+#include "snapshot.h"
+
+// Purpose: Returns the 16 bit check of the packed words and the sequence number. Every bit of
+//          every word changes it (FNV-1a over the bytes), so a half written snapshot does not pass.
+//          The sequence number is hashed byte by byte like the words: put into the start it would
+//          cancel out with the same bit flipped in the first byte of word 1
+static uint16_t SnapshotCheck(const uint32_t words[SNAPSHOT_WORDS], uint16_t sequence){
+    uint32_t hash = 2166136261UL;
+
+    hash = (hash ^ (sequence & 0xFF)) * 16777619UL;
+    hash = (hash ^ (sequence >> 8)) * 16777619UL;
+    for (int i = 1 ; i < SNAPSHOT_WORDS ; i++){
+        for (int shift = 0 ; shift < 32 ; shift += 8){
+            hash ^= (words[i] >> shift) & 0xFF;
+            hash *= 16777619UL;
+        }
+    }
+    return (hash ^ (hash >> 16) ^ SNAPSHOT_MAGIC) & 0xFFFF;
+}
+
+// Purpose: Packs the snapshot. Word 0 is the check and the sequence number, the rest is:
+//          1: seed, 2: word, 3: round, 4: guessed (26 bits), evil, coded and lives (top 4 bits),
+//          5: the two press averages
+void SnapshotEncode(const Snapshot *snapshot, uint16_t sequence, uint32_t words[SNAPSHOT_WORDS]){
+    words[1] = snapshot->seed;
+    words[2] = snapshot->word;
+    words[3] = snapshot->round;
+    words[4] = (snapshot->guessed & 0x3FFFFFFUL) | (uint32_t)snapshot->evil << 26 | (uint32_t)snapshot->coded << 27
+             | (uint32_t)(snapshot->lives & 0xF) << 28;
+    words[5] = snapshot->shortMean | (uint32_t)snapshot->longMean << 16;
+    words[0] = sequence | (uint32_t)SnapshotCheck(words, sequence) << 16;
+}
+
+// Purpose: Unpacks the snapshot if its check matches, and gives its sequence number
+bool SnapshotDecode(Snapshot *snapshot, uint16_t *sequence, const uint32_t words[SNAPSHOT_WORDS]){
+    uint16_t number = words[0] & 0xFFFF;
+
+    if (words[0] >> 16 != SnapshotCheck(words, number)){
+        return false;
+    }
+    *sequence = number;
+    snapshot->seed = words[1];
+    snapshot->word = words[2];
+    snapshot->round = words[3];
+    snapshot->guessed = words[4] & 0x3FFFFFFUL;
+    snapshot->evil = (words[4] >> 26) & 1;
+    snapshot->coded = (words[4] >> 27) & 1;
+    snapshot->lives = words[4] >> 28;
+    snapshot->shortMean = words[5] & 0xFFFF;
+    snapshot->longMean = words[5] >> 16;
+    return true;
+}
@@ -0,0 +1,41 @@
+// Game snapshot: what it takes to go on with a game after a reset, in a few words
+
+// A station that browns out or is reset in the middle of a game should not
+// send the player back to the start. Everything the game needs to carry on is
+// packed into SNAPSHOT_WORDS 32-bit words: the word order's seed, how far into
+// it the game is, the word, the guesses, the lives, the mode and the player's
+// press timing. The words that still fit the guesses are not kept, they can
+// be found again from the word and the guesses.
+//
+// A check word, with a sequence number, is packed with them, so a save that
+// was cut short by a reset is told from a good one, and of two good ones the
+// newer is known. The packing has no hardware in it, see backup.h for where
+// the words are kept.
+
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SNAPSHOT_WORDS 6 // Words one snapshot is packed into
+#define SNAPSHOT_MAGIC 0x48AE // Part of the check, so all 0 or all 1 words are never a snapshot
+
+typedef struct {
+    uint32_t seed;      // The seed the word order was made from, see ShuffleInit()
+    uint32_t round;     // Words of the order started so far
+    uint32_t word;      // Dictionary index of the word being guessed
+    uint32_t guessed;   // Letters guessed this word, bit 0 is A
+    uint8_t lives;      // Lives left, up to 15
+    bool evil;          // The station plays evil
+    bool coded;         // Letters are entered with the prefix code
+    uint16_t shortMean; // Average length of the player's 0 and 1 presses, in ms, so they need no timing check again
+    uint16_t longMean;
+} Snapshot;
+
+void SnapshotEncode(const Snapshot *snapshot, uint16_t sequence, uint32_t words[SNAPSHOT_WORDS]); // Packs a snapshot with its sequence number
+bool SnapshotDecode(Snapshot *snapshot, uint16_t *sequence, const uint32_t words[SNAPSHOT_WORDS]); // Unpacks one, false if the words are not a whole snapshot
+
+#define SnapshotNewer(a, b) ((int16_t)((a) - (b)) > 0) // Sequence a was saved after b, the numbers can wrap
+
+#endif
@@ -0,0 +1,34 @@
+// Hint solver: which letter to guess next, from the words that still fit
+
+#include "solver.h"
+
+// Purpose: Counts how many of the candidates have each letter, 32 words at a time
+void SolverCounts(const Candidates *candidates, uint32_t counts[26]){
+    for (int letter = 0 ; letter < 26 ; letter++){
+        counts[letter] = 0;
+        for (int i = 0 ; i < DICT_SETS ; i++){
+            counts[letter] += __builtin_popcount(candidates->bits[i] & DictLetterSets[letter][i]);
+        }
+    }
+}
+
+// Purpose: Picks the unguessed letter (guessed has bit 0 for A) the most candidates have. It is the likeliest
+//          to be right, so the hint does not cost a life, and being right shows where it is in all those words.
+//          Of letters that are just as common, the first in the alphabet wins. count gets how many have it
+char SolverHint(const Candidates *candidates, uint32_t guessed, uint32_t *count){
+    uint32_t counts[26];
+    int best = -1;
+
+    SolverCounts(candidates, counts);
+    for (int letter = 0 ; letter < 26 ; letter++){
+        if (!(guessed & (1UL << letter)) && counts[letter] > 0 && (best < 0 || counts[letter] > counts[best])){
+            best = letter;
+        }
+    }
+    if (best < 0){
+        *count = 0;
+        return 0;
+    }
+    *count = counts[best];
+    return 'A' + best;
+}
@@ -0,0 +1,17 @@
+// Hint solver: which letter to guess next, from the words that still fit
+
+// The candidate words are kept up to date as the guesses come in (see
+// candidates.h), so a hint only has to count, for every letter not guessed yet,
+// how many of them have it. That is one popcount per letter for every 32 words,
+// with the letter bitmaps of the dictionary.
+
+#ifndef __SOLVER_H
+#define __SOLVER_H
+
+#include <stdint.h>
+#include "candidates.h"
+
+char SolverHint(const Candidates *candidates, uint32_t guessed, uint32_t *count); // The best letter to guess, 0 if no letter helps
+void SolverCounts(const Candidates *candidates, uint32_t counts[26]); // How many candidates have each letter
+
+#endif
@@ -0,0 +1,37 @@
+// Internal flash sectors 6 and 7 of the STM32F401RE, where the store keeps its log
+
+#include "flash.h"
+#include "stm32f4xx_hal.h"
+
+// Purpose: Programs one word. The flash is only unlocked while it is written
+static bool FlashProgram(int sector, uint32_t offset, uint32_t word){
+    HAL_StatusTypeDef status;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, FLASH_STORE_BASE + sector * FLASH_STORE_SIZE + offset, word);
+    HAL_FLASH_Lock();
+    return status == HAL_OK;
+}
+
+// Purpose: Erases sector 6 or 7. Range 3 (2.7 to 3.6 V) erases 32 bits at a time, the Nucleo runs at 3.3 V
+static bool FlashErase(int sector){
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t failed; // The sector that could not be erased, if any
+    HAL_StatusTypeDef status;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = FLASH_SECTOR_6 + sector;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&erase, &failed); // Also flushes the flash caches, so no stale data is read back
+    HAL_FLASH_Lock();
+    return status == HAL_OK;
+}
+
+const StoreFlash FlashStore = {
+    {(const uint8_t *)FLASH_STORE_BASE, (const uint8_t *)(FLASH_STORE_BASE + FLASH_STORE_SIZE)},
+    FLASH_STORE_SIZE,
+    FlashProgram,
+    FlashErase
+};
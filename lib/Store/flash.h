@@ -0,0 +1,19 @@
+// Internal flash sectors 6 and 7 of the STM32F401RE, where the store keeps its log
+
+// Sectors 6 (0x08040000) and 7 (0x08060000) are the last two 128 KB sectors.
+// The program has to stay in sectors 0 to 5, below 256 KB, which is why
+// platformio.ini limits the upload to that size. Erasing a sector stalls the
+// CPU for a second or two, as the program runs from the same flash, but the
+// store only does it when a sector is full.
+
+#ifndef __FLASH_H
+#define __FLASH_H
+
+#include "store.h"
+
+#define FLASH_STORE_BASE 0x08040000UL  // Sector 6
+#define FLASH_STORE_SIZE (128UL * 1024) // Bytes in each of sectors 6 and 7
+
+extern const StoreFlash FlashStore; // Sectors 6 and 7, through the HAL
+
+#endif
@@ -0,0 +1,199 @@
+// Persistent store: small values that survive resets and power cuts, kept as a log in two flash sectors
+
+#include <string.h>
+#include "store.h"
+
+#define STORE_ERASED 0xFFFFFFFFUL // A word that was never programmed
+
+// Purpose: Reads the word at offset in a sector
+static uint32_t StoreWord(const Store *store, int sector, uint32_t offset){
+    return *(const uint32_t *)(store->flash->sector[sector] + offset);
+}
+
+// Purpose: Returns how many bytes a record with a value this long takes, whole words so every header is aligned
+static uint32_t StoreSpan(uint8_t length){
+    return 4 + ((length + 3UL) & ~3UL);
+}
+
+// Purpose: CRC-16/CCITT (polynomial 0x1021, starting from 0xFFFF) of the key, the length and the value
+static uint16_t StoreCrc(uint8_t key, uint8_t length, const uint8_t *value){
+    uint16_t crc = 0xFFFF;
+    uint8_t head[2] = {key, length};
+
+    for (int i = 0 ; i < 2 + length ; i++){
+        crc ^= (uint16_t)(i < 2 ? head[i] : value[i - 2]) << 8;
+        for (int bit = 0 ; bit < 8 ; bit++){
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Purpose: Programs one word and counts it
+static bool StoreProgram(Store *store, int sector, uint32_t offset, uint32_t word){
+    store->programmed += 4;
+    return store->flash->program(sector, offset, word);
+}
+
+// Purpose: Erases one sector and counts it
+static bool StoreErase(Store *store, int sector){
+    store->erases++;
+    return store->flash->erase(sector);
+}
+
+// Purpose: Returns whether a sector has a complete header, i.e. its compaction finished
+static bool StoreValid(const Store *store, int sector){
+    return StoreWord(store, sector, 0) == STORE_MAGIC && StoreWord(store, sector, 4) != STORE_ERASED;
+}
+
+// Purpose: Walks the log of the active sector, keeping where the latest good record of each key is and where the log ends.
+//          A header that cannot be a record means the rest of the sector cannot be trusted, so it is treated as full
+static void StoreScan(Store *store){
+    uint32_t size = store->flash->size;
+    uint32_t offset = STORE_HEADER;
+
+    memset(store->index, 0, sizeof(store->index));
+    while (offset + 4 <= size){
+        uint32_t header = StoreWord(store, store->active, offset);
+        uint8_t key = header & 0xFF;
+        uint8_t length = (header >> 8) & 0xFF;
+        const uint8_t *value = store->flash->sector[store->active] + offset + 4;
+
+        if (header == STORE_ERASED){
+            break;
+        }
+        if (key >= STORE_KEYS || length > STORE_MAX_VALUE || offset + StoreSpan(length) > size){
+            offset = size;
+            break;
+        }
+        if (StoreCrc(key, length, value) == header >> 16){
+            store->index[key] = offset;
+        }
+        offset += StoreSpan(length);
+    }
+    store->end = offset;
+}
+
+// Purpose: Uses the sector with the newest complete header. When neither has one, e.g. the first time the
+//          board runs, sector 0 is erased and given the first header
+bool StoreInit(Store *store, const StoreFlash *flash){
+    store->flash = flash;
+    store->written = 0;
+    store->programmed = 0;
+    store->erases = 0;
+
+    bool valid[2] = {StoreValid(store, 0), StoreValid(store, 1)};
+    if (!valid[0] && !valid[1]){
+        store->active = 0;
+        store->generation = 1;
+        store->end = STORE_HEADER;
+        memset(store->index, 0, sizeof(store->index));
+        return StoreErase(store, 0) && StoreProgram(store, 0, 4, store->generation) && StoreProgram(store, 0, 0, STORE_MAGIC);
+    }
+
+    // Generations are compared by their difference, so the count can wrap
+    store->active = valid[1] && (!valid[0] || (int32_t)(StoreWord(store, 1, 4) - StoreWord(store, 0, 4)) > 0);
+    store->generation = StoreWord(store, store->active, 4);
+    StoreScan(store);
+    return true;
+}
+
+// Purpose: Returns where the value of key is in flash and sets length to its length, or returns NULL if it has none
+const uint8_t *StoreGet(const Store *store, uint8_t key, uint8_t *length){
+    if (key >= STORE_KEYS || store->index[key] == 0){
+        return NULL;
+    }
+    *length = (StoreWord(store, store->active, store->index[key]) >> 8) & 0xFF;
+    return store->flash->sector[store->active] + store->index[key] + 4;
+}
+
+// Purpose: Copies the value of key into value. A value of another length was stored by something else, so it is left alone
+bool StoreRead(const Store *store, uint8_t key, void *value, uint8_t length){
+    uint8_t stored;
+    const uint8_t *data = StoreGet(store, key, &stored);
+
+    if (data == NULL || stored != length){
+        return false;
+    }
+    memcpy(value, data, length);
+    return true;
+}
+
+// Purpose: Appends a record to the log. The header goes first: a record that was cut short still has its length,
+//          so the ones after it can be found, and its CRC does not match
+static bool StoreAppend(Store *store, uint8_t key, const uint8_t *value, uint8_t length){
+    uint32_t offset = store->end;
+    uint32_t header = key | (uint32_t)length << 8 | (uint32_t)StoreCrc(key, length, value) << 16;
+
+    // The end moves first, a failed write must not be written over
+    store->end += StoreSpan(length);
+    if (!StoreProgram(store, store->active, offset, header)){
+        return false;
+    }
+    for (int i = 0 ; i < length ; i += 4){
+        uint32_t word = STORE_ERASED; // The padding after the value is left erased
+
+        memcpy(&word, value + i, length - i < 4 ? length - i : 4);
+        if (!StoreProgram(store, store->active, offset + 4 + i, word)){
+            return false;
+        }
+    }
+    store->index[key] = offset;
+    return true;
+}
+
+// Purpose: Copies the latest record of every key to the other sector, then writes its header, which makes it
+//          the newest. Until then the old sector is still the one StoreInit() would use
+bool StoreCompact(Store *store){
+    int target = !store->active;
+    uint32_t index[STORE_KEYS] = {0};
+    uint32_t offset = STORE_HEADER;
+
+    if (!StoreErase(store, target)){
+        return false;
+    }
+    for (int key = 0 ; key < STORE_KEYS ; key++){
+        if (store->index[key] == 0){
+            continue;
+        }
+        uint32_t span = StoreSpan((StoreWord(store, store->active, store->index[key]) >> 8) & 0xFF);
+        for (uint32_t i = 0 ; i < span ; i += 4){
+            if (!StoreProgram(store, target, offset + i, StoreWord(store, store->active, store->index[key] + i))){
+                return false;
+            }
+        }
+        index[key] = offset;
+        offset += span;
+    }
+    if (!StoreProgram(store, target, 4, store->generation + 1) || !StoreProgram(store, target, 0, STORE_MAGIC)){
+        return false;
+    }
+
+    store->active = target;
+    store->generation++;
+    store->end = offset;
+    memcpy(store->index, index, sizeof(index));
+    return true;
+}
+
+// Purpose: Makes value the value of key. Nothing is written when it already is, to spare the flash,
+//          and the log is compacted first when the record does not fit at its end
+bool StorePut(Store *store, uint8_t key, const void *value, uint8_t length){
+    uint8_t stored;
+    const uint8_t *data = StoreGet(store, key, &stored);
+
+    if (key >= STORE_KEYS || length > STORE_MAX_VALUE){
+        return false;
+    }
+    if (data != NULL && stored == length && memcmp(data, value, length) == 0){
+        return true;
+    }
+    if (store->end + StoreSpan(length) > store->flash->size && !StoreCompact(store)){
+        return false;
+    }
+    if (store->end + StoreSpan(length) > store->flash->size){
+        return false;
+    }
+    store->written += length;
+    return StoreAppend(store, key, value, length);
+}
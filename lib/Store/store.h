@@ -0,0 +1,58 @@
+// Persistent store: small values that survive resets and power cuts, kept as a log in two flash sectors
+
+// Flash can only have bits cleared, and only a whole sector can be set back to
+// all 1, so values are never changed in place. Every StorePut() appends a
+// record (key, length, CRC-16 and the value) to the end of the log in the
+// active sector, and the latest record of a key is its value. When the
+// sector is full, the latest record of every key is copied to the other
+// sector, which then becomes the active one (compaction), so the two sectors
+// take turns being erased and wear out evenly.
+//
+// A sector header holds a generation count, one more every compaction, which
+// is written after the copied records: if the power is cut while compacting,
+// the old sector is still the newest complete one. A record whose CRC does
+// not match, e.g. one cut short by a reset, is skipped.
+//
+// StoreInit() walks the log once and keeps where the latest record of each
+// key is, so StoreGet() is a single array lookup. The flash is reached through
+// a StoreFlash, which can just as well be RAM on a host standing in for it.
+
+#ifndef __STORE_H
+#define __STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STORE_KEYS 16      // Keys are 0 to STORE_KEYS - 1
+#define STORE_MAX_VALUE 32 // Longest value, in bytes
+#define STORE_HEADER 8     // Bytes at the start of each sector: the magic number and the generation
+#define STORE_MAGIC 0x3156534BUL // "KSV1", tells a store sector from an erased one or old program code
+
+typedef struct {
+    const uint8_t *sector[2]; // Where each sector can be read, word aligned
+    uint32_t size;            // Bytes in each sector
+    bool (*program)(int sector, uint32_t offset, uint32_t word); // Clears the 0 bits of word at this offset
+    bool (*erase)(int sector); // Sets the whole sector back to all 1
+} StoreFlash;
+
+typedef struct {
+    const StoreFlash *flash;
+    uint8_t active;             // The sector the log is in
+    uint32_t generation;        // Generation in the active sector's header
+    uint32_t end;               // Offset of the first free byte in the active sector
+    uint32_t index[STORE_KEYS]; // Offset of each key's latest record in the active sector, 0 if it has none
+    uint32_t written;           // Bytes of values given to StorePut() since StoreInit()
+    uint32_t programmed;        // Bytes programmed for them, headers, padding and compaction included
+    uint32_t erases;            // Sectors erased since StoreInit()
+} Store;
+
+bool StoreInit(Store *store, const StoreFlash *flash); // Finds the newest sector and indexes its log, formats the flash if there is none
+const uint8_t *StoreGet(const Store *store, uint8_t key, uint8_t *length); // Where the value of key is in flash, NULL if it has none
+bool StoreRead(const Store *store, uint8_t key, void *value, uint8_t length); // Copies the value of key, false unless it has exactly this length
+bool StorePut(Store *store, uint8_t key, const void *value, uint8_t length); // Makes this the value of key, false if the flash could not take it
+bool StoreCompact(Store *store); // Moves the latest records to the other sector and makes it the active one
+
+#define StoreUsed(store) ((store)->end) // Bytes of the active sector in use
+#define StoreFree(store) ((store)->flash->size - (store)->end)
+
+#endif
@@ -90,6 +90,36 @@ void SerialPuts(char *ptr)
         SerialPutc(*ptr++);
 }
 
+// queue a string of characters to be sent by SerialService() instead of waiting for the port;
+// returns false if the queue was too full to hold all of it (the rest is dropped)
+
+#define SERIAL_QUEUE_SIZE 256  // must be a power of 2
+
+static char serialQueue[SERIAL_QUEUE_SIZE];
+static uint16_t serialHead = 0;  // next free slot, only moved by SerialQueue()
+static uint16_t serialTail = 0;  // next character to send, only moved by SerialService()
+
+bool SerialQueue(char *ptr)
+{
+    while (*ptr)
+    {
+        if ((uint16_t)(serialHead - serialTail) >= SERIAL_QUEUE_SIZE)
+            return false;
+        serialQueue[serialHead++ & (SERIAL_QUEUE_SIZE - 1)] = *ptr++;
+    }
+    return true;
+}
+
+// send queued characters for as long as the port can take them without waiting;
+// returns true while there are still characters left (call it again later)
+
+bool SerialService()
+{
+    while (serialTail != serialHead && (UART_Handle.Instance->SR & USART_SR_TXE) != 0)
+        UART_Handle.Instance->DR = serialQueue[serialTail++ & (SERIAL_QUEUE_SIZE - 1)];
+    return serialTail != serialHead;
+}
+
 // get a string of characters (up to maxlen) from the serial port into a buffer,
 // collecting them until the user presses the enter key;
 // also echoes the typed characters back to the user, and handles backspacing
@@ -13,6 +13,8 @@ void SerialGets(char *buff, int maxlen);
 
 void SerialPutc(char c);
 void SerialPuts(char *ptr);
+bool SerialQueue(char *ptr);
+bool SerialService();
 
 // macro for reading an entire port (we provide this so students don't need to know about structs)
 #define ReadPort(port) (port->IDR)
@@ -8,41 +8,167 @@
 #include <stdlib.h>
 #include "spi.h"
 #include "gpio.h"
+#include "dma.h"
+#include "button.h"
+#include "press.h"
+#include "indicator.h"
+#include "scheduler.h"
+#include "prefix.h"
+#include "game.h"
+#include "dictionary.h"
+#include "candidates.h"
+#include "evil.h"
+#include "solver.h"
+#include "shuffle.h"
+#include "store.h"
+#include "flash.h"
+#include "backup.h"
+#include "sd.h"
+#include "fat.h"
+#include "pack.h"
 #include "fonts.h"
 #include "pinmappings.h"
 #include "st7789 drivers.h"
 #include "stm32f4xx_hal.h"
 #include "ece198.h"
-#include <math.h>
 
 // All functions were previously planned out in detail allowing us to create near if not fully functional copies immediately with 
 // little testing in a burner file. 
 
 //Git testing
 
+// The game runs as a set of states on the cooperative scheduler. Each state handler is given an event, draws what it needs,
+// asks for the next input or for a press to continue, and returns right away. Meanwhile the main loop keeps servicing
+// the button, the display DMA and the serial port, and sleeps whenever there is nothing to do.
+
+// Events handled by the game states
+enum {
+    EV_ENTER,    // the state was just entered
+    EV_INPUT,    // the binary input asked for by askInput() is complete, arg is its value
+    EV_CONTINUE, // the button was pressed after askContinue()
+    EV_REFRESH   // time to update the live press indicator
+};
+
+typedef void (*State)(uint16_t, uint32_t);
+
+// Moves a guess can be instead of a letter, bit n is the move entered as value n
+#define MOVE_EXIT 0x1 // all 0
+#define MOVE_WORD 0x2 // 1 then all 0, guess the whole word
+#define MOVE_HINT 0x4 // 0, 1, then all 0, ask for a hint
+
+#define CALIBRATE_PRESSES 4 // Presses of each kind the timing check asks for
+
+// What the station keeps in its store, in flash sectors 6 and 7, so it outlasts resets and power cuts
+enum {
+    KEY_PASSWORD,  // uint32_t, the digits that open the settings
+    KEY_LIVES,     // uint8_t, lives a game starts with
+    KEY_HIGH_SCORE // uint16_t, most words guessed in one game
+};
+
+#define PASSWORD_DIGITS 8
+#define DEFAULT_PASSWORD 0xA5 // 1 0 1 0 0 1 0 1, until the owner sets their own
+#define MAX_LIVES 7 // The most lives the settings allow, 3 digits
+
+#define PACK_FILE "WORDS.TXT" // The word pack on the SD card, played instead of the built-in words when it is there
+
+#define DIGIT_X(n) (5 + (n) * 12) // Where digit n (from 0) of an input is shown, on the bottom line
+
 // Functions
 int main(void); // main function
-void welcome(); // welcome message
-void instructions(); // instructions
+void goTo(State); // leaves the current state and enters another one
+void dispatch(uint16_t, uint32_t); // passes a game event to the current state
+void welcomeState(uint16_t, uint32_t); // welcome message
+void calibrateState(uint16_t, uint32_t); // measures the player's short and long presses and sets the thresholds to them
+void menuState(uint16_t, uint32_t); // gets users choice between instructions, quit, and play
+void instructionsState(uint16_t, uint32_t); // instructions, one page per press
+void modeState(uint16_t, uint32_t); // asks if the station plays fair or evil
+void newWordState(uint16_t, uint32_t); // takes the next word from the list and starts a round with it
+void guessState(uint16_t, uint32_t); // gets one user guess and either reveals letters or removes lives (playing the game)
+void wordGuessState(uint16_t, uint32_t); // gets a guess of the whole word, letter by letter, and checks it against the dictionary
+void roundWonState(uint16_t, uint32_t); // asks if the user wants to keep playing after guessing a word
+void goodbyeState(uint16_t, uint32_t); // goodbye message, the game ends here
+void settingsAccessState(uint16_t, uint32_t); // Password entry page to access settings, or to quit
+void settingsState(uint16_t, uint32_t); // Admin page accessible only by escape room owner with a password
+int accessGranted(uint32_t); // Checks to see if password is correct, incorrect, or if user wants to quit
+void save(uint8_t, const void*, uint8_t); // Writes a setting or score to the store, and reports what that cost the flash
+void suspendGame(); // Saves the game in progress to the backup registers, so a reset does not lose it
+bool resumeGame(); // Goes back into the game a reset cut short, if there is one
+void reportTimings(); // Times the letter code, the dictionary and the perfect hash, and reports them over serial
+void loadPack(); // Looks for a word pack on the SD card, and counts its words
 void goodbye(); // goodbye message
-void pauseProgram(); // asks for a char input to pause the program
-void menu(char[]); // gets users choice between instructions, quit, and play
-void startGame(); // opens file and starts game if user selects to  play (calls menu)
-bool isPresent(char, char[]); // checks to see if the char argument is present in the char[] argument
-void play(char[]); // repeatedly gets user guesses and either reveals letters or removes lives (playing the game)
-int addToGuessed(char, char[]); // returns the next free index in guessedLetters to add a new letter to guessedLetters
-bool isRoundWon(char[], char[], int); // Checks if the word has been fully guessed
-int getBinaryInput(int); // Gets input from the single button in binary and converts it to an ascii value
+void showHint(); // Suggests the letter most of the words that still fit have
+void evilWord(); // Shows the first of the words the evil station has left as the word
+void askInput(int); // Starts getting input from the single button in binary, EV_INPUT carries the ascii value
+void askCode(const PrefixCode*); // Starts getting one letter entered with a prefix code, EV_INPUT carries the ascii value
+void askLetter(uint32_t, uint8_t); // Starts getting a letter the way the game is played, with the prefix code or in ascii
+void askGuess(uint32_t, uint8_t); // Starts getting a guess in 8 digit ascii, which ends early once only one of the letters fits
+void narrowGuess(int, int); // Drops the letters the latest digit of a guess rules out
+uint32_t letterDigits(char, int); // Which letters have a 1 at this digit of their ascii code
+void finishInput(uint32_t); // Ends the input and sends its value to the current state
+void askContinue(); // asks for a button press to continue, which sends EV_CONTINUE
+bool pollButton(void); // Feeds the button edges to the press decoder and completes inputs and pauses
+bool pollDisplay(void); // Sends the next part of the changed screen to the display
+void showIndicator(uint16_t, uint32_t); // Shows what the press being held would enter, and how close it is to the next one
+void clearIndicator(); // Forgets the live indicator once its press has been decided
+void showScreen(ST7789_Snapshot*, void (*)(int), int, char[]); // Draws a screen that never changes, from its snapshot after the first time
+void drawWelcome(int); // Draws the welcome titles
+void drawMenu(int); // Draws the menu options
+void drawInstructions(int); // Draws one page of the instructions
+void drawCodeTable(); // Lists the prefix code of every letter
 void strout(char[], int, int, int, int); // Allows for printing of strings greater than one line in 
                                          // length, around 28 characters, without cutting words in half when it hits the edge.
                                          // Used for printing large strings which require little formatting
 
-// NOTE: Unfortunately the functions below were not able to be completed, as file system / manipulation with STM32 
-// is very problematic as far as we've researched, partially due to little documentation. This makes us unable to save a config file as planned. 
-// This is still ok as they were extra features which we were adding, and not in our design document or pitch.
-void settings(); // Admin page accessible only by escape room owner with a password.
-void settingsAccess(); // Password entry page to access settings or return to main menu.
-int accessGranted(); // Checks to see if password is correct, incorrect, or if user wants to return to menu.
+// The game, kept between the state handlers
+static State state; // The state that gets the game events
+static Game game; // The word being guessed, the guesses and the lives
+static int wordNum = 0; // Words of the dictionary played this game
+static Shuffle order; // The order the dictionary is played in this game
+static uint32_t orderSeed = 0; // What order was made from, kept in the snapshot to make it again
+static int wordIndex = 0; // Where the word being guessed is in the dictionary
+static Store store; // The settings and the high score, see lib/Store
+static uint32_t password = DEFAULT_PASSWORD; // The settings as they are in the store
+static uint8_t lives = GAME_LIVES;
+static uint16_t highScore = 0;
+static uint32_t entropy = 0; // Noise gathered since power up: the temperature sensor, then the timing of every button edge
+static int page = 0; // The instructions page being shown
+static bool coded = false; // Letters are entered with letterCode instead of 8 digit ascii
+static PrefixCode letterCode; // Short codes for common letters, built from English letter frequencies
+static int guesses = 0; // Guesses made this game, with the presses and time they took, to compare the two ways to enter letters
+static uint32_t guessPresses = 0;
+static uint32_t guessTime = 0;
+static bool evil = false; // The station has not settled on a word, it keeps the most words it can with every guess
+static Candidates candidates; // The words that still fit the guesses, for hints and the evil station
+static Cache cache; // The blocks last read from the SD card
+static Fat fat; // The card's volume
+static WordPack pack; // The words on the card
+static bool cardPack = false; // The card has a word pack, which the games are played from
+static bool packed = false; // This game's words come from the pack. There are no hints or evil station then, they need the built-in words
+static char spelled[GAME_MAX_LENGTH]; // The whole word guess so far
+static int spelledLength = 0;
+
+// Decodes the button edges into binary digits
+static PressDecoder decoder;
+static PressLearner learner; // Keeps moving the decoder's thresholds towards how this player presses
+
+// The input being asked for
+static int inputLength = 0; // How many digits askInput() wants, 0 while no input is asked for
+static const PrefixCode *inputCode = NULL; // The code askCode() is entering a letter with, NULL for plain binary
+static uint8_t inputNode = PREFIX_ROOT; // How far into inputCode the digits so far have gone
+static int inputPresses = 0; // Presses the input took so far, redos included
+static uint32_t inputStart = 0; // When the first press of the input started, in microseconds
+static uint32_t inputTime = 0; // How long the finished input took from its first press to its last release, in ms
+static bool narrowing = false; // The input is a guess, which askGuess() narrows down as the digits come in
+static uint32_t upperLeft = 0; // Unguessed letters (bit 0 is A) whose upper case code still fits the digits so far
+static uint32_t lowerLeft = 0; // The same for the lower case codes
+static uint8_t movesLeft = 0; // The moves below whose values still fit
+static bool skipPress = false; // The press that was held when the input was asked for belongs to the screen before
+static int indicatorTimer = -1; // Refreshes the live press indicator while an input is asked for
+static Indicator indicator; // The live digit and progress bar on screen, see lib/Indicator
+static bool calibrating = false; // The input measures presses instead of entering a value
+static uint32_t calibrateTotal = 0; // How long the presses of the calibration took together, in microseconds
+static bool continueAsked = false; // askContinue() is waiting for a press
+static uint32_t continueTime = 0; // Only presses that start after this continue
 
 int main(void){
     HAL_Init(); // initialize the Hardware Abstraction Layer
@@ -56,422 +182,1024 @@ int main(void){
 
     // Setup for lcd display
     MX_GPIO_Init();
+    MX_DMA_Init();
     MX_SPI1_Init();
     ST7789_Init();
+    ST7789_FB_Begin(BLACK); // Draw into RAM, the panel is updated from the main loop by pollDisplay
 
     // set up for serial communication to the host computer
     // (anything we write to the serial port will appear in the terminal (i.e. serial monitor) in VSCode)
     SerialSetup(9600); // For testing only
+    ButtonSetup(); // Button edges are timestamped by interrupt and queued for pollButton
+    PressInit(&decoder, &(PressConfig)PRESS_DEFAULT_CONFIG);
+    PressLearnInit(&learner, &decoder.config);
+    IndicatorInit(&indicator);
+    PrefixBuild(&letterCode, PrefixEnglish);
+
+    // The lowest bits of the temperature sensor are noise, a first seed for the word order
+    ADC_HandleTypeDef adc;
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    InitializeADC(&adc, ADC1);
+    for (int i = 0 ; i < 32 ; i++){
+        entropy = ShuffleMix(entropy, ReadADC(&adc, ADC_CHANNEL_TEMPSENSOR));
+    }
 
-    welcome(); // Welcome screen
-    startGame(); // Starting the game
+    // Enable the cycle counter, used to time how long screens take to draw
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // The scheduler runs on the 1 ms HAL tick, so timer delays are in ms
+    SchedInit(HAL_GetTick);
+    SchedAddPoller(pollButton);
+    SchedAddPoller(pollDisplay);
+    SchedAddPoller(SerialService);
+
+    // The settings and the high score. The whole log is read once to index it, which is timed
+    char report[80];
+    uint32_t start = DWT->CYCCNT;
+    bool stored = StoreInit(&store, &FlashStore);
+    uint32_t cycles = DWT->CYCCNT - start;
+    StoreRead(&store, KEY_PASSWORD, &password, sizeof(password));
+    StoreRead(&store, KEY_HIGH_SCORE, &highScore, sizeof(highScore));
+    if (!StoreRead(&store, KEY_LIVES, &lives, sizeof(lives)) || lives == 0 || lives > MAX_LIVES){
+        lives = GAME_LIVES;
+    }
+    sprintf(report, "store: %lu bytes of log indexed in %lu us%s\r\n", StoreUsed(&store), cycles / (SystemCoreClock / 1000000),
+            stored ? "" : ", flash failed");
+    SerialQueue(report);
+
+    // A game a reset cut short goes on right where it was, without the welcome, the timing check or the menu.
+    // HAL_Init() started the tick at reset, so it says how long that took. The card is looked at either way,
+    // so the games after a resumed one are played from its pack too
+    loadPack();
+    BackupSetup();
+    if (resumeGame()){
+        sprintf(report, "resumed: round %i, %lu ms after reset\r\n", wordNum, HAL_GetTick());
+        SerialQueue(report);
+    }
+    else{
+        reportTimings();
+        goTo(welcomeState); // Welcome screen
+    }
+    while (true){
+        if (!SchedRunOnce()){
+            __WFI(); // Nothing to do until the next interrupt: a button edge, the display DMA or the 1 ms tick
+        }
+    }
     return 0;
 }
 
-// Purpose: Retrieves input from one button rather than two, and differentiates between 1 and 0 bits by how long the button was held. 
-//          All to eventually return an ascii value.
-int getBinaryInput(int length){
-    bool blue = false;
-    int sum = 0; // total sum of all binary bits whihc is the ascii value
-    int count = 0; // how many times to get input
-    uint32_t pressTime = 0; // When the button is pressed
-    uint32_t liveTime = 0; // When the button is released
-    uint32_t totalPressTime = 0; // The difference between livetime and presstime, meaning i is how long the button was held down
-    uint32_t colorTimerLive = 0; // Stores Live value of how long the button is held for the color output
-
-    // This is done so that we can control how many inputs we get
-    // For example, menu only needs two inputs, whereas play needs 7
-    while (count < length){
-        blue = false;
-        colorTimerLive = 0;
-        pressTime = 0; // Resets both values before getting more input
-        liveTime = 0;
-        
-        // As soon as the button is pressed, this while loop terminates, hence giving the msot recent time for pressTime
-        while (HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13)){
-            pressTime = HAL_GetTick();
-            
-        }
+// Purpose: Wakes up the SD card, if there is one, and reads through its word pack once to count the words.
+//          How long that took and how many blocks it read are reported
+void loadPack(){
+    char report[80];
+    uint32_t start = HAL_GetTick();
+
+    CacheInit(&cache, SdRead);
+    cardPack = SdInit() && FatMount(&fat, &cache) && PackOpen(&pack, &fat, PACK_FILE);
+    if (cardPack){
+        sprintf(report, "sd: %lu words in %s, counted in %lu ms from %lu blocks\r\n", PackCount(&pack), PACK_FILE,
+                HAL_GetTick() - start, cache.misses);
+    }
+    else{
+        sprintf(report, "sd: no %s, playing the built-in words\r\n", PACK_FILE);
+    }
+    SerialQueue(report);
+}
 
-        // Stops the program until after the user lets go of the button
-        while (!HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13)){
-            colorTimerLive = HAL_GetTick();
-            // Checks to see if the time between the initial press and current is less than 500 ms.
-            if ((colorTimerLive - pressTime) < 500){
-                //ST7789_DrawFilledCircle(300, 220, 10, RED); // Shows red circle for holding less than 500 ms, meaning 0 
-                ST7789_WriteChar(5 + count*12, 220, '0', Font_11x18, RED, BLACK);
-            }
-            else if ((colorTimerLive - pressTime) >= 500 && (colorTimerLive - pressTime) < 2500){
-                //ST7789_DrawFilledCircle(300, 220, 10, GREEN); // Shows green circle for holding more then 499 ms, meaning 1
-                ST7789_WriteChar(5 + count*12, 220, '1', Font_11x18, GREEN, BLACK);
-            }
-            else{
-                blue = true;
-                ST7789_WriteChar(5 + count*12, 220, 'D', Font_11x18, BLUE, BLACK);
+// Purpose: Reports how fast the letter code is to enter and how long the word lists take to read, on a fresh start
+void reportTimings(){
+    char report[80];
+    uint32_t average = PrefixAverage(&letterCode, PrefixEnglish);
+    sprintf(report, "letter code: %lu.%02lu presses per letter\r\n", average / 100, average % 100);
+    SerialQueue(report);
+
+    // How long fetching a word from the packed dictionary takes, on average over all of them
+    char letters[GAME_MAX_LENGTH];
+    uint32_t start = DWT->CYCCNT;
+    for (int i = 0 ; i < DictCount ; i++){
+        DictWord(i, letters);
+    }
+    uint32_t cycles = (DWT->CYCCNT - start) / DictCount;
+    sprintf(report, "dictionary: %lu words, %lu cycles per word\r\n", DictCount, cycles);
+    SerialQueue(report);
+
+    // Finding each word again with the perfect hash. Every hit is compared with the word, so there are no false positives
+    start = DWT->CYCCNT;
+    for (int i = 0 ; i < DictCount ; i++){
+        DictFind(letters, DictWord(i, letters));
+    }
+    sprintf(report, "hash: %lu cycles per fetch and lookup\r\n", (DWT->CYCCNT - start) / DictCount);
+    SerialQueue(report);
+}
+
+// Purpose: Makes next the current state and lets it draw itself
+void goTo(State next){
+    state = next;
+    SchedPost(dispatch, EV_ENTER, 0);
+}
+
+// Purpose: Passes a game event on to whichever state is current when it is handled
+void dispatch(uint16_t event, uint32_t arg){
+    state(event, arg);
+}
+
+// Purpose: Starts getting input from one button rather than two, which differentiates between 1 and 0 bits by how long the button was held.
+//          All to eventually send an ascii value to the current state with EV_INPUT. The timing and debouncing is done by the 
+//          press decoder, pollButton feeds it the button edges and shows the digits.
+void askInput(int digits){
+    PressClear(&decoder);
+    inputLength = digits;
+    inputCode = NULL;
+    narrowing = false;
+    calibrating = false;
+    inputPresses = 0;
+    skipPress = PressIsDown(&decoder);
+    if (indicatorTimer < 0){
+        indicatorTimer = SchedTimer(showIndicator, EV_REFRESH, 0, 40); // 25 frames per second at most, often enough to look live
+    }
+}
+
+// Purpose: Starts getting one letter, entered with the digits of its code. The letter is known as soon as
+//          its last digit is in, so common letters take 3 or 4 presses instead of 8
+void askCode(const PrefixCode *code){
+    askInput(PRESS_MAX_BITS);
+    inputCode = code;
+    inputNode = PREFIX_ROOT;
+}
+
+// Purpose: Starts getting a letter with the prefix code when playing with codes, else in ascii narrowed down to letters.
+//          moves are the MOVE_ values that are offered besides them, the code always has all of them
+void askLetter(uint32_t letters, uint8_t moves){
+    if (coded){
+        askCode(&letterCode);
+    }
+    else{
+        askGuess(letters, moves);
+    }
+}
+
+// Purpose: Starts getting a guess, in the same 8 digit ascii as always. Every digit rules out the letters whose code
+//          does not have it, and once only one of the letters (in either case) or moves is left it is entered right away,
+//          without the remaining digits. What is still possible is shown as the digits come in
+void askGuess(uint32_t letters, uint8_t moves){
+    askInput(8);
+    narrowing = true;
+    upperLeft = letters;
+    lowerLeft = upperLeft;
+    movesLeft = moves;
+    narrowGuess(-1, 0);
+}
+
+// Purpose: Keeps only the letters whose code has this digit at this position, shows what is left,
+//          and enters the guess if that is only one letter. A digit of -1 only shows the letters
+void narrowGuess(int digit, int position){
+    char shown[40] = "Could be: ";
+    int n = 10;
+    uint32_t left;
+
+    if (digit >= 0){
+        upperLeft &= digit ? letterDigits('A', position) : ~letterDigits('A', position);
+        lowerLeft &= digit ? letterDigits('a', position) : ~letterDigits('a', position);
+        for (int move = 0 ; move < 3 ; move++){
+            if (((move >> position) & 1) != digit){
+                movesLeft &= ~(1 << move);
             }
         }
-        //ST7789_DrawFilledCircle(300, 220, 10, BLACK); // Erase the hold length indicators
-        // ST7789_WriteString(20, 220, "                           ", Font_11x18, BLACK, BLACK);
-        if (blue){
-            ST7789_WriteChar(5 + count*12, 220, 'D', Font_11x18, BLACK, BLACK);
-        }
-
-        liveTime = HAL_GetTick(); // Gets the time of button release as soon as the user releases it
-        totalPressTime = liveTime - pressTime; // Finds the total length of time that the button was held
+    }
+    left = upperLeft | lowerLeft; // Upper and lower case are the same guess
 
-        // If the button was held for more than 1000 ms, binary bit is flipped on, and 
-        // we add to the sum, else the binary bit is off and sum is untouched
+    if (__builtin_popcount(left) + __builtin_popcount(movesLeft) == 1){
+        finishInput(movesLeft != 0 ? __builtin_ctz(movesLeft) : 'A' + __builtin_ctz(left));
+        return;
+    }
 
-        if (totalPressTime >= 500 && totalPressTime < 2500){
-            // Adds the decimal value of whatever binary value it currently is, eventually 
-            // summing up to a final ascii value after 8 inputs. decimal value = 2^count
-            sum += pow(2, count);
-            count++; // Increments count for the next input/binary bit
+    // Still open, or nothing fits any more and all 8 digits are entered as before
+    for (int i = 0 ; i < 26 ; i++){
+        if (left & (1UL << i)){
+            shown[n++] = 'A' + i;
         }
-        else if (totalPressTime < 500){
-            
-            // Increments count, and sum is untouched, as a 0 input was given.
-            count++;
+    }
+    if (movesLeft & MOVE_EXIT){
+        shown[n++] = '-';
+    }
+    if (movesLeft & MOVE_WORD){
+        shown[n++] = '#';
+    }
+    if (movesLeft & MOVE_HINT){
+        shown[n++] = '?';
+    }
+    while (n < 37){
+        shown[n++] = ' '; // Covers the letters that were shown before
+    }
+    shown[n] = 0;
+    ST7789_WriteString(5, 260, shown, Font_11x18, WHITE, BLACK);
+}
+
+// Purpose: Returns the letters (bit 0 is the first) whose ascii code, counted from first, has a 1 at this digit
+uint32_t letterDigits(char first, int position){
+    uint32_t ones = 0;
+
+    for (int i = 0 ; i < 26 ; i++){
+        if (((first + i) >> position) & 1){
+            ones |= 1UL << i;
         }
     }
+    return ones;
+}
+
+// Purpose: Ends the input that was asked for, and sends its value to the current state with EV_INPUT
+void finishInput(uint32_t value){
+    inputLength = 0;
+    inputTime = (decoder.rawTime - inputStart) / 1000; // Up to the release that decided the last digit
+    SchedCancel(indicatorTimer);
+    indicatorTimer = -1;
     ST7789_WriteString(0, 220, "                             ", Font_11x18, BLACK, BLACK);
-    return sum; // Returns the final ascii value obtained
+    if (narrowing){
+        ST7789_WriteString(5, 260, "                                     ", Font_11x18, BLACK, BLACK);
+        narrowing = false;
+    }
+    SchedPost(dispatch, EV_INPUT, value);
 }
 
-// Purpose: Actual Gameplay. Gets user input, processes guesses, and outputs gameplay to the user
-void play(char words[]){
+// Purpose: Asks for a button press to continue, which sends EV_CONTINUE to the current state
+void askContinue(){
+    ST7789_WriteString(7, 220, "Press blue to continue...", Font_11x18, WHITE, BLACK);
+    continueAsked = true;
+    continueTime = ButtonNow(); // Presses made before the prompt is shown do not count
+}
 
-    // Variables
-    int lives = 7;
-    int length = 0; // The length of the current word being guessed
-    char guess; // The users input
-    char guessedLetters[26] = {0}; // Array which stores all the guessed letters
-    char word[13];
-    int wordNum = 0;
-    int wordIndex = 0;
+// Purpose: Takes the next button edge (or just the time passing) to the press decoder, and acts on what it decided
+bool pollButton(void){
+    ButtonEvent event; // A press or release edge, timestamped by the button interrupt
+    PressBit bit; // The digit the latest edge completed, if any
+    bool busy = ButtonGetEvent(&event);
 
+    if (busy){
+        bit = PressFeed(&decoder, event.time, event.pressed);
+        entropy = ShuffleMix(entropy, event.time); // No two people press to the microsecond
+    }
+    else{
+        bit = PressPoll(&decoder, ButtonNow());
+    }
 
-    while (lives != 0){
+    // A new press continues, as soon as it is sure it is not a bounce
+    if (continueAsked && PressIsDown(&decoder) && (int32_t)(decoder.downTime - continueTime) >= 0){
+        continueAsked = false;
+        ST7789_WriteString(7, 220, "                         ", Font_11x18, WHITE, BLACK);
+        SchedPost(dispatch, EV_CONTINUE, 0);
+    }
 
-        // Clear guessedLetters and sets word length to 0 if its not the first time here and there are chars stored 
-        // (necessary if the user passed the first word)
-        length = 0;
-        for (int i = 0 ; i < 26 ; i++){
-            guessedLetters[i] = 0;
-            if (i < 13){
-                word[i] = 0;
-            }
-        }
+    if (inputLength == 0 || bit == PRESS_NONE){
+        return busy;
+    }
+    if (skipPress){
+        // e.g. the press that continued to this screen, it is not a digit
+        skipPress = false;
+        PressClear(&decoder);
+        return true;
+    }
 
-        // This code block is responsible for filling the word array with each word after every round.
-        wordIndex = 0; // Index for word
-        // This will always iterate 13 times, however each time it will remember its position in the large words array
-        // Takes sets of 13 characters and puts it into word array for each round
-        for (int i = wordNum*13 ; i < (wordNum+1)*13 ; i++){
-            word[wordIndex] = words[i];
-            if (words[i+1] == ' '){
-                wordNum++;
-                break;
-            }
-            wordIndex++;
+    if (inputPresses++ == 0){
+        inputStart = decoder.downTime; // Still the start of the press that was just decided
+    }
+    clearIndicator();
+    if (bit == PRESS_REDO){
+        ST7789_WriteChar(DIGIT_X(PressBits(&decoder)), 220, 'D', Font_11x18, BLACK, BLACK); // Erase the indicator, the digit is entered again
+        return true;
+    }
+    if (calibrating){
+        calibrateTotal += PressLastHeld(&decoder);
+    }
+    else{
+        PressLearn(&learner, &decoder, bit); // Only presses meant as digits, the continue presses are left out
+    }
+
+    // The digit is final, it stays where the live indicator was. The decoder has already counted it
+    ST7789_WriteChar(DIGIT_X(PressBits(&decoder) - 1), 220, bit == PRESS_ONE ? '1' : '0', Font_11x18, bit == PRESS_ONE ? GREEN : RED, BLACK);
+    if (inputCode != NULL){
+        int symbol = PrefixStep(inputCode, &inputNode, bit == PRESS_ONE);
+        if (symbol >= 0){
+            finishInput(symbol == PREFIX_EXIT ? 0 : symbol == PREFIX_WORD ? 1 : symbol == PREFIX_HINT ? 2 : 'A' + symbol); // Same values as in ascii
         }
-        //strout(word, 10, 110, 13, 1); // For testing to see if word was acquired correctly
-        pauseProgram();
+    }
+    else if (PressBits(&decoder) == inputLength){
+        finishInput(PressValue(&decoder)); // The digits were added up as they came, the first one is the lowest bit
+    }
+    else if (narrowing){
+        narrowGuess(bit == PRESS_ONE, PressBits(&decoder) - 1);
+    }
+    return true;
+}
 
-        // CLear screen if user chooses to play
+// Purpose: Shows what the press being held would enter while an input is asked for. Only what changed is drawn
+void showIndicator(uint16_t event, uint32_t timer){
+    if (inputLength == 0 || skipPress){
+        return;
+    }
+    IndicatorShow(&indicator, &decoder, ButtonNow(), DIGIT_X(PressBits(&decoder)));
+}
+
+// Purpose: Forgets the live indicator and erases its bar, once the press it showed has been decided
+void clearIndicator(){
+    IndicatorClear(&indicator);
+}
+
+// Purpose: Sends the rows of the screen that changed, a bit at a time, without waiting for the DMA
+bool pollDisplay(void){
+    return ST7789_FB_FlushStep();
+}
+
+// Purpose: Outputs welcome message and asks to continue
+void welcomeState(uint16_t event, uint32_t arg){
+    static ST7789_Snapshot welcomeScreen; // The titles, captured the first time they are drawn
+
+    if (event == EV_ENTER){
+        showScreen(&welcomeScreen, drawWelcome, 0, "welcome");
+        askContinue();
+    }
+    else if (event == EV_CONTINUE){
+        goTo(calibrateState);
+    }
+}
+
+// Purpose: Has the new player make a few presses of each kind, and puts the thresholds between their average lengths.
+//          They keep adjusting during the game, see pollButton()
+void calibrateState(uint16_t event, uint32_t arg){
+    static uint32_t shortMean = 0; // Average length of the quick presses, in microseconds
+    static int step = 0; // 0 while the quick presses are made, 1 for the longer ones
+    char line[40];
+
+    if (event == EV_ENTER){
         ST7789_Fill_Color(BLACK);
-        //fgets(word, 13, words); // get the next word from the file
-        //printf("word: %s-", word);
+        ST7789_WriteString(7, 10, "Timing check:", Font_11x18, WHITE, BLACK);
+        strout("Make 4 quick presses, the way you would enter a 0.", 7, 50, 51, 3);
+        askInput(CALIBRATE_PRESSES);
+        calibrating = true;
+        calibrateTotal = 0;
+        step = 0;
+    }
+    else if (event == EV_INPUT && step == 0){
+        shortMean = calibrateTotal / CALIBRATE_PRESSES;
+        strout("Now make 4 longer presses, the way you would enter a 1.", 7, 50, 56, 3);
+        askInput(CALIBRATE_PRESSES);
+        calibrating = true;
+        calibrateTotal = 0;
+        step = 1;
+    }
+    else if (event == EV_INPUT){
+        // Presses that are not longer than the quick ones leave the thresholds as they are
+        PressLearnSet(&learner, &decoder, shortMean, calibrateTotal / CALIBRATE_PRESSES);
+        sprintf(line, "0 under %lu ms", decoder.config.oneAfter / 1000);
+        ST7789_WriteString(7, 130, line, Font_11x18, RED, BLACK);
+        sprintf(line, "1 under %lu ms", decoder.config.redoAfter / 1000);
+        ST7789_WriteString(7, 150, line, Font_11x18, GREEN, BLACK);
+
+        sprintf(line, "calibrated: %lu / %lu ms\r\n", decoder.config.oneAfter / 1000, decoder.config.redoAfter / 1000);
+        SerialQueue(line);
+        askContinue();
+    }
+    else if (event == EV_CONTINUE){
+        goTo(menuState);
+    }
+}
 
-        // Traverses through the first 13 characters of word
-        for (int i = 0 ; i < 13 ; i++){
+// Purpose: Act as the menu for the player. Gives options on what to do, like play, quit, and instructions.
+//          Correctly gets user input and sends the user to where they choose
+void menuState(uint16_t event, uint32_t guess){
+    static ST7789_Snapshot menuScreen; // The menu, captured the first time it is drawn
 
-            // If word isnt any letter in the alphabet, upper or lower case, it will stop adding length to the word, meaning the word is finished
-            if ( !((word[i] >= 65 && word[i] <= 90) || (word[i] >= 97 && word[i] <= 122)) ){
-                break;
-            }
-            length++;
+    if (event == EV_ENTER){
+        BackupClear(); // Any game is over here, a reset should not go back into it
+        showScreen(&menuScreen, drawMenu, 0, "menu");
+        askInput(2);
+    }
+    else if (event == EV_INPUT){
+        // If statement to determine where to send the user, either sends user to a state, or quits
+        if (guess == 3){
+            goTo(instructionsState);
         }
-        
-        // Actual gameplay with guessing and output
-        do{
-
-            // Printing the word with non guessed letters hidden
-            for (int i = 0 ; i < length ; i++){
-                
-                // if (word[i] == ' '){
-                //     break;
-                // }
-                // If the letter in word[] is already guessed, output the letter instead of a star
-                if (isPresent(word[i], guessedLetters)){
-                    //printf("%c", word[i]);
-                    ST7789_WriteChar(7 + 12*i, 10, word[i], Font_11x18, WHITE, BLACK);
-                }
-                else {
-                    ST7789_WriteChar(7 + 12*i, 10, '*', Font_11x18, WHITE, BLACK);
-                }
-            }
+        else if (guess == 0){
+            goTo(settingsAccessState); // The password opens the settings, all 0 quits and goodbye() will trigger
+        }
+        else if (guess == 2 || guess == 1){
+            coded = guess == 1; // 1-0 plays with the short letter codes
+            packed = cardPack;
+            GameStart(&game, lives);
+            wordNum = 0;
+            guesses = 0;
+            guessPresses = 0;
+            guessTime = 0;
+            goTo(modeState);
+        }
+        else{
+            strout("Invalid input!!! Try again.", 7, 220, 28, 1);
+            askContinue();
+        }
+    }
+    else if (event == EV_CONTINUE){
+        goTo(menuState);
+    }
+}
 
-            // Printing out what the player has already guessed and the lives
-            //printf("\nGuessed: ", '\n');
-            strout("Guessed: ", 7, 30, 10, 1);
-            for (int i = 0 ; i < 26 ; i++){
-
-                // If there is a non default entry in guessedletters, it must be a letter which was guessed
-                if (guessedLetters[i] != 0){    
-                    
-                    // If its the first letter that was guessed, dont add a coma, otherwise add one to keep a clean look
-                    //if (i == 0){
-                        //printf("%c", guessedLetters[i]);
-                        ST7789_WriteChar(110 + i*12, 30, guessedLetters[i], Font_11x18, WHITE, BLACK);
-                    //}
-                    //else{
-                        //printf(", %c", guessedLetters[i]);
-                        //ST7789_WriteString(127, 30 + i*12, guessedLetters[i], Font_11x18, WHITE, BLACK);
-                    //}
-                }
+// Purpose: Outputs the instructions of the game to the user
+void instructionsState(uint16_t event, uint32_t arg){
+    static ST7789_Snapshot pages[4]; // Each page, captured the first time it is drawn
+
+    if (event == EV_ENTER){
+        page = 0;
+    }
+    else if (event == EV_CONTINUE){
+        page++;
+        if (page == 4){
+            goTo(menuState);
+            return;
+        }
+    }
+    else{
+        return;
+    }
+    showScreen(&pages[page], drawInstructions, page, "instructions");
+    askContinue();
+}
+
+// Purpose: Lets the user choose between a station that picks a word and one that keeps dodging the guesses
+void modeState(uint16_t event, uint32_t mode){
+    if (event == EV_ENTER && packed){
+        modeState(EV_INPUT, 0); // The evil station needs the built-in words, a word pack is always played fair
+    }
+    else if (event == EV_ENTER){
+        ST7789_Fill_Color(BLACK);
+        strout("Enter 1 to play against an evil station that changes its word to dodge your guesses, or 0 for a fair one.", 7, 10, 106, 6);
+        askInput(1);
+    }
+    else if (event == EV_INPUT){
+        evil = mode == 1;
+        orderSeed = entropy; // Every press so far is in the seed, so every game has its own order
+        ShuffleInit(&order, packed ? PackCount(&pack) : DictCount, orderSeed);
+        goTo(newWordState);
+    }
+}
+
+// Purpose: Starts a round with the next word from the list
+void newWordState(uint16_t event, uint32_t arg){
+    if (event == EV_ENTER){
+        // The words come from src/words.txt, packed into flash when the game is built, or from the pack on the card.
+        // They are taken in this game's order, so each one comes once and the list does not start over the same
+        wordIndex = ShuffleAt(&order, wordNum);
+        if (packed){
+            WordView word;
+            char report[100];
+            uint32_t start = DWT->CYCCNT;
+
+            // A pack word is read from the card into RAM, from the nearest mark before it
+            if (!PackWord(&pack, wordIndex, &word)){
+                cardPack = false; // The built-in words from the next game on
+                SerialQueue("sd: the card failed, back to the built-in words\r\n");
+                goTo(menuState);
+                return;
             }
+            GameWord(&game, word, GameMask(word));
+            snprintf(report, sizeof(report), "sd: word %i read in %lu us, %lu blocks cached, %lu read\r\n", wordIndex,
+                     (DWT->CYCCNT - start) / (SystemCoreClock / 1000000), cache.hits, cache.misses);
+            SerialQueue(report);
+        }
+        else{
+            GameWord(&game, DictView(wordIndex), DictMask(wordIndex));
+        }
+        wordNum++;
+
+        // Every word this long fits until the first guess. The evil station only takes the length, any of them can still be the one
+        CandAll(&candidates, GameLength(&game));
+        if (evil){
+            evilWord();
+        }
+        suspendGame();
+        askContinue();
+    }
+    else if (event == EV_CONTINUE){
+        // CLear screen if user chooses to play
+        ST7789_Fill_Color(BLACK);
+        goTo(guessState);
+    }
+}
+
+// Purpose: Actual Gameplay. Gets user input, processes guesses, and outputs gameplay to the user
+void guessState(uint16_t event, uint32_t arg){
+    char guess = arg; // The users input
+
+    if (event == EV_ENTER){
 
-            // Printing the users total lives
-            //printf("\nLives: %i", lives, '\n');
-            //printf("\n", '\n');
-            ST7789_WriteString(7, 50, "Lives: ", Font_11x18, WHITE, BLACK);
-            ST7789_WriteChar(103, 50, lives+48, Font_11x18, WHITE, BLACK);
+        // Printing the word with non guessed letters hidden
+        for (int i = 0 ; i < GameLength(&game) ; i++){
             
-            // User guessing
-            //printf("Please enter your letter guess: ");
-            //ST7789_WriteString(7, 70, "Please enter your guess [all 0 to exit]:", Font_11x18, WHITE, BLACK);
-            strout("Please enter your guess or all 0 to exit:", 7, 70, 42, 3);
-            guess = getBinaryInput(8);
-            fflush(stdin);
-
-            // If the guess was lower case, subtract 32 to make its ascii value the equivalent upper case letter
-            if (guess == 0){
-                break;
+            // If the letter in the word is already guessed, output the letter instead of a star
+            if (GameRevealed(&game, i)){
+                ST7789_WriteChar(7 + 12*i, 10, GameLetter(&game, i), Font_11x18, WHITE, BLACK);
             }
-            else if ( !((guess >= 65 && guess <= 90) || (guess >= 97 && guess <= 122)) ){
-                lives--;
-                ST7789_WriteString(7, 200, "Thats no letter!", Font_11x18, WHITE, BLACK);
+            else {
+                ST7789_WriteChar(7 + 12*i, 10, '*', Font_11x18, WHITE, BLACK);
             }
-            else{
-                if (guess > 90){
-                    guess -=32;
-                }
-
-                // Checking if the guess is already present in guessed letters
-                if (isPresent(guess, guessedLetters)){
-                    ST7789_WriteString(7, 200, "You already guessed that!", Font_11x18, WHITE, BLACK);
-                }
-                else{
-
-                    // Adds letter guess to guesedletters
-                    guessedLetters[addToGuessed(guess, guessedLetters)] = guess;
-
-                    // If the guess is present in the word, or not
-                    if (isPresent(guess,word)){
-                        ST7789_WriteString(7, 200, "Correct", Font_11x18, WHITE, BLACK);
-                    }
-                    else{
-                        lives--;
-                        ST7789_WriteString(7, 200, "Incorrect", Font_11x18, WHITE, BLACK);
-                    }
-                }
+        }
+
+        // Printing out what the player has already guessed and the lives
+        strout("Guessed: ", 7, 30, 10, 1);
+        int shown = 0; // Guessed letters listed so far, in alphabetical order
+        for (int i = 0 ; i < 26 ; i++){
+            if (GameGuessed(&game, 'A' + i)){
+                ST7789_WriteChar(110 + shown*12, 30, 'A' + i, Font_11x18, WHITE, BLACK);
+                shown++;
             }
+        }
 
-            // Stopping the program to let the user see the correct or incorrect message
-            pauseProgram(); 
-            ST7789_Fill_Color(BLACK);
+        // Printing the users total lives
+        ST7789_WriteString(7, 50, "Lives: ", Font_11x18, WHITE, BLACK);
+        ST7789_WriteChar(103, 50, game.lives+48, Font_11x18, WHITE, BLACK);
+        
+        // User guessing
+        if (coded){
+            strout("Enter the code of a letter, - to exit, # to guess the word or ? for a hint:", 7, 70, 76, 3);
+            drawCodeTable();
+        }
+        else{
+            strout("Enter a letter, all 0 to exit, 1 0.. for the word, 0 1 0.. for a hint:", 7, 70, 71, 3);
+        }
+        askLetter(GAME_ALL & ~game.guessed, MOVE_EXIT | MOVE_WORD | MOVE_HINT);
+    }
+    else if (event == EV_INPUT){
 
-            // If the user guessed all the letters in the word
-            if (isRoundWon(word, guessedLetters, length)){
-                ST7789_WriteString(7, 130, "YOU GUESSED IT!", Font_11x18, WHITE, BLACK);
-                pauseProgram();
-                
-                if (wordNum == 5){
-                    ST7789_WriteString(7, 150, "YOU GUESSED IT ALL!!!!", Font_11x18, CYAN, BLACK);
-                    break;
-                }
-                else{
-                    strout("Enter 1 to stop. Enter 0 to continue playing.", 7, 130, 46, 3);
-                    guess = getBinaryInput(1);
-                    fflush(stdin);
-
-                    if (guess == 1){
-                        lives = 0;
-                    }
-                    else if(guess == 0){
-                        guess = 3;
-                    }
-                    break;
-                }
-            }
+        // All 0 leaves the game for the menu
+        if (guess == 0){
+            goTo(menuState);
+            return;
+        }
+        if (guess == 1){
+            goTo(wordGuessState);
+            return;
+        }
+        if (guess == 2){
+            showHint();
+            return;
         }
-        while( (lives != 0) && !isRoundWon(word,guessedLetters,length));
 
-        if (guess == 1 || guess == 0 || wordNum == 5){
-            break;
+        // Reports how many presses and how long guesses take, on average over this game
+        char report[80];
+        guesses++;
+        guessPresses += inputPresses;
+        guessTime += inputTime;
+        sprintf(report, "guess %i: %i presses in %lu ms, average %lu.%02lu presses in %lu ms\r\n", guesses, inputPresses, inputTime,
+                guessPresses / guesses, guessPresses * 100 / guesses % 100, guessTime / guesses);
+        SerialQueue(report);
+
+        // The evil station first keeps the biggest family of words for a new letter, then the guess is
+        // checked against one of them. They all have the letter in the same places, or not at all
+        if (guess >= 'a' && guess <= 'z'){
+            guess -= 'a' - 'A';
+        }
+        if (evil && guess >= 'A' && guess <= 'Z' && !GameGuessed(&game, guess)){
+            uint32_t start = DWT->CYCCNT;
+            EvilGuess(&candidates, guess);
+            evilWord();
+            sprintf(report, "evil: %lu words left, partitioned in %lu us\r\n", candidates.count,
+                    (DWT->CYCCNT - start) / (SystemCoreClock / 1000000));
+            SerialQueue(report);
+        }
+        else if (guess >= 'A' && guess <= 'Z' && !GameGuessed(&game, guess)){
+            CandKeep(&candidates, guess, GamePositions(&game, guess)); // What the guess shows, for the hints
+        }
+
+        // Lower case counts as upper case, a wrong letter or something that is not a letter costs a life
+        switch (GameGuess(&game, guess)){
+            case GAME_INVALID:
+                ST7789_WriteString(7, 200, "Thats no letter!", Font_11x18, WHITE, BLACK);
+                break;
+            case GAME_REPEAT:
+                ST7789_WriteString(7, 200, "You already guessed that!", Font_11x18, WHITE, BLACK);
+                break;
+            case GAME_HIT:
+                ST7789_WriteString(7, 200, "Correct", Font_11x18, WHITE, BLACK);
+                break;
+            case GAME_MISS:
+                ST7789_WriteString(7, 200, "Incorrect", Font_11x18, WHITE, BLACK);
+                break;
         }
+        suspendGame();
+
+        // Stopping the game to let the user see the correct or incorrect message
+        askContinue();
     }
+    else if (event == EV_CONTINUE){
+        ST7789_Fill_Color(BLACK);
 
-    // close and open the file to restart at the beginning if the user is kicked from the game loops
-    // (meaning the user lost all lives, or purposefully chose to restart)
-    // fclose(words);
-    // fopen("words.txt","r");
+        // If the user guessed all the letters in the word
+        if (GameWon(&game)){
+            goTo(roundWonState);
+        }
+        else if (GameLost(&game)){
+            goTo(menuState);
+        }
+        else{
+            goTo(guessState);
+        }
+    }
 }
 
-// Purpose: Checks to see if the char 'letter' passed in is found in the array 'guessesOrWord' passed in
-bool isPresent(char letter, char guessesOrWord[26]){ // guessesOrWord array can either hold the guessed letters array, or the words array
+// Purpose: Lets the user spell out the whole word. Letters that are not a word in the dictionary are turned away
+//          without costing a life, a wrong word costs one like a wrong letter does, and the right one wins the round
+void wordGuessState(uint16_t event, uint32_t arg){
+    char letter = arg; // The users input
 
-    // Traverse through the guessesOrWord array
-    for (int i = 0 ; i < 26 ; i++){
+    if (event == EV_ENTER){
+        spelledLength = 0;
+        strout("Spell the word, or exit to go back to guessing letters:", 7, 70, 56, 3);
+        askLetter(GAME_ALL, MOVE_EXIT);
+    }
+    else if (event == EV_INPUT){
+        if (letter == 0){
+            ST7789_Fill_Color(BLACK);
+            goTo(guessState);
+            return;
+        }
+        if (letter >= 'a' && letter <= 'z'){
+            letter -= 'a' - 'A';
+        }
+        if (letter < 'A' || letter > 'Z'){
+            askLetter(GAME_ALL, MOVE_EXIT); // e.g. # or ? in the code, they are no letters
+            return;
+        }
+        ST7789_WriteChar(7 + 12*spelledLength, 150, letter, Font_11x18, WHITE, BLACK);
+        spelled[spelledLength++] = letter;
+        if (spelledLength < GameLength(&game)){
+            askLetter(GAME_ALL, MOVE_EXIT);
+            return;
+        }
+
+        // The dictionary's perfect hash finds the only word it can be in constant time. A pack word is not in it,
+        // so then any spelling is taken as a guess
+        int index = packed ? -1 : DictFind(spelled, spelledLength);
 
-        // If the letter is found in the array, return true
-        if (letter == guessesOrWord[i]){
-            return true;
+        // The evil station drops a word that was guessed right, as long as it has others left
+        if (evil && index >= 0 && candidates.count > 1){
+            CandRemove(&candidates, index);
+            evilWord();
         }
-        if (guessesOrWord[i+1] > 90 || guessesOrWord[i+1] < 65){ // Null character were causing issues with returning true for non-present charcters, hence this
-            return false;                                        // if statement to recognize when the next letter is non-alphabet, and return false before then.
+        if (index < 0 && !packed){
+            ST7789_WriteString(7, 200, "Not a word, try again", Font_11x18, WHITE, BLACK);
         }
+        else if (GameGuessWord(&game, spelled, spelledLength) == GAME_HIT){
+            ST7789_WriteString(7, 200, "Correct", Font_11x18, WHITE, BLACK);
+        }
+        else{
+            if (index >= 0){
+                CandRemove(&candidates, index); // One word less for the hints
+            }
+            ST7789_WriteString(7, 200, "Incorrect", Font_11x18, WHITE, BLACK);
+        }
+        suspendGame();
+        askContinue();
+    }
+    else if (event == EV_CONTINUE){
+        guessState(EV_CONTINUE, 0); // On to the next guess, or the end of the round
     }
-    return false;
 }
 
-// Purpose: returns the next free index of guessedletters to add letters to the array in the play function
-int addToGuessed(char letter, char guessedLetters[]){
-    // Variables
-    int index = 0; // The next free index
+// Purpose: Shows the letter the solver suggests, and how many of the words that still fit have it.
+//          A hint costs nothing, the guess screen comes back after it
+void showHint(){
+    char line[40];
+    uint32_t count;
+    uint32_t start = DWT->CYCCNT;
+    char hint;
+
+    if (packed){
+        ST7789_WriteString(7, 200, "No hints for card words", Font_11x18, WHITE, BLACK);
+        askContinue();
+        return;
+    }
+    hint = SolverHint(&candidates, game.guessed, &count);
+    uint32_t time = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
 
-    // Traverse through the guessedleters array
-    for (int i = 0 ; i < 26 ; i++){
-        
-        // If index i of guessedletters is the default value, set the index to return as i, and break the loop
-        if (guessedLetters[i] == 0){
-            index = i;
-            break;
-        }
+    if (hint == 0){
+        ST7789_WriteString(7, 200, "No letter left to try", Font_11x18, WHITE, BLACK);
+    }
+    else{
+        snprintf(line, sizeof(line), "Try %c, %lu of %lu words have it", hint, count, candidates.count);
+        ST7789_WriteString(7, 200, line, Font_11x18, YELLOW, BLACK);
     }
+    snprintf(line, sizeof(line), "hint: %c from %lu words in %lu us\r\n", hint == 0 ? '-' : hint, candidates.count, time);
+    SerialQueue(line);
+    askContinue();
+}
 
-    return index;
+// Purpose: Makes the first word the evil station has left the one that is shown and checked.
+//          It fits every guess so far, so nothing on the screen changes
+void evilWord(){
+    wordIndex = CandFirst(&candidates);
+    GameSwap(&game, DictView(wordIndex), DictMask(wordIndex));
 }
 
-// Purpose: Returns true if the word has been fully guessed, false if otherwise
-bool isRoundWon(char word[], char guessedLetters[], int length){
+// Purpose: Congratulates the user on a guessed word, and lets them stop or carry on with the next one
+void roundWonState(uint16_t event, uint32_t guess){
+    if (event == EV_ENTER){
+        char line[30];
 
-    // Variables
-    int count = 0; // Indicates how many correctly guessed letters are in the word
+        // Every word of this game was guessed, so far
+        if (wordNum > highScore){
+            highScore = wordNum;
+            save(KEY_HIGH_SCORE, &highScore, sizeof(highScore));
+        }
+        sprintf(line, "Words: %i  Best: %u", wordNum, highScore);
+        ST7789_WriteString(7, 10, line, Font_11x18, YELLOW, BLACK);
+        ST7789_WriteString(7, 130, "YOU GUESSED IT!", Font_11x18, WHITE, BLACK);
+        askContinue();
+    }
+    else if (event == EV_CONTINUE){
+        if (wordNum == order.count){
+            ST7789_WriteString(7, 150, "YOU GUESSED IT ALL!!!!", Font_11x18, CYAN, BLACK);
+            goTo(menuState);
+        }
+        else{
+            strout("Enter 1 to stop. Enter 0 to continue playing.", 7, 130, 46, 3);
+            askInput(1);
+        }
+    }
+    else if (event == EV_INPUT){
+        if (guess == 1){
+            goTo(menuState);
+        }
+        else{
+            goTo(newWordState);
+        }
+    }
+}
 
-    // Traverses through the length of the word
-    for (int i = 0 ; i < length ; i++){
+// Purpose: Says goodbye. No state comes after this one
+void goodbyeState(uint16_t event, uint32_t arg){
+    if (event == EV_ENTER){
+        goodbye();
+    }
+}
 
-        // Traverses through the guessedletters array to see if word[i] is guessed or not
-        for (int j = 0 ; j < 26 ; j++){
+// Purpose: Asks for the password of the settings. All 0 quits instead, as 0-0 did before there were settings
+void settingsAccessState(uint16_t event, uint32_t code){
+    if (event == EV_ENTER){
+        ST7789_Fill_Color(BLACK);
+        strout("Enter the 8 digit password for the settings, or all 0 to quit.", 7, 10, 63, 4);
+        askInput(PASSWORD_DIGITS);
+    }
+    else if (event == EV_INPUT){
+        int access = accessGranted(code);
 
-            // If the letter in word has been guessed, add 1 to the count of correct letters, and break the inner loop
-            if (word[i] == guessedLetters[j]){
-                count++; // counts how many letters in word are already guessed
-                break; // break out of loop
-            }
+        if (access == 1){
+            goTo(settingsState);
+        }
+        else if (access == 0){
+            goTo(goodbyeState);
+        }
+        else{
+            ST7789_WriteString(7, 200, "Wrong password", Font_11x18, WHITE, BLACK);
+            askContinue();
         }
     }
+    else if (event == EV_CONTINUE){
+        goTo(menuState);
+    }
+}
 
-    // If the length of the word = the amount of correct guesses, game wins, otherwise returns false
-    if (count == length){ 
-        return true;
+// Purpose: Returns 1 if the code is the password, 0 if it is all 0 (quit) and -1 if it is wrong
+int accessGranted(uint32_t code){
+    if (code == 0){
+        return 0;
     }
-    return false;
+    return code == password ? 1 : -1;
 }
 
-// Purpose: Setup the answer file and send the user to the menu
-void startGame(){
+// Purpose: Lets the owner change the lives a game starts with and the password, and clear the high score.
+//          Everything is saved to the store right away. page is 0 for the choice, then what is being entered
+void settingsState(uint16_t event, uint32_t value){
+    char line[30];
 
-    // Variables
-    char word[65] = "PROFESSOR LAPTOP KNIFE NUCLEO PHYSICS "; // This will hold the words in the game because files do not work properly with STM32 Nucleo
-    //char word[65] = "PP LL K K P "; // Fast and easy testing word
-    
-    // All file code below is N/A, beyond scope of the course, very difficult
-    // FILE *words = fopen("D:\\words.txt", "r"); 
-    // //Checking to see if file open was a success, if not, output error
-    // if (words == NULL){
-    //     SerialPuts("ERROR OPENING FILE");
-    // }
-
-    menu(word); // Continue to the main menu
-    
+    if (event == EV_ENTER || event == EV_CONTINUE){
+        ST7789_Fill_Color(BLACK);
+        ST7789_WriteString(7, 10, "Settings:", Font_11x18, WHITE, BLACK);
+        sprintf(line, "Lives: %u  High score: %u", lives, highScore);
+        ST7789_WriteString(7, 30, line, Font_11x18, YELLOW, BLACK);
+        ST7789_WriteString(7, 70, "Enter 1-1 to change lives", Font_11x18, WHITE, BLACK);
+        ST7789_WriteString(7, 90, "Enter 1-0 for a new password", Font_11x18, WHITE, BLACK);
+        ST7789_WriteString(7, 110, "Enter 0-1 to clear the score", Font_11x18, WHITE, BLACK);
+        ST7789_WriteString(7, 130, "Enter 0-0 for the menu", Font_11x18, WHITE, BLACK);
+        askInput(2);
+        page = 0;
+    }
+    else if (event == EV_INPUT && page == 0){
+        if (value == 3){
+            strout("Enter the lives a game starts with, 1 to 7:", 7, 170, 44, 2);
+            askInput(3);
+            page = 1;
+        }
+        else if (value == 2){
+            strout("Enter the new 8 digit password, not all 0:", 7, 170, 43, 2);
+            askInput(PASSWORD_DIGITS);
+            page = 2;
+        }
+        else if (value == 1){
+            highScore = 0;
+            save(KEY_HIGH_SCORE, &highScore, sizeof(highScore));
+            settingsState(EV_CONTINUE, 0);
+        }
+        else{
+            goTo(menuState);
+        }
+    }
+    else if (event == EV_INPUT){
+        // 0 lives or an all 0 password could never be used, so they are turned away
+        if (value == 0){
+            ST7789_WriteString(7, 220, "Not changed, it can't be 0", Font_11x18, WHITE, BLACK);
+            askContinue();
+            return;
+        }
+        if (page == 1){
+            lives = value;
+            save(KEY_LIVES, &lives, sizeof(lives));
+        }
+        else{
+            password = value;
+            save(KEY_PASSWORD, &password, sizeof(password));
+        }
+        settingsState(EV_CONTINUE, 0);
+    }
 }
 
-// Purpose: Act as the menu for the player. Gives options on what to do, like play, quit, and instructions.
-//          Correctly gets user input and sends the user to where they choose
-void menu(char word[]){
-    // Variables
-    char guess; // The users input on what to do
+// Purpose: Writes a value to the store. How many bytes that programmed, against the bytes of the values saved,
+//          is reported with every save, to see how much compaction and the record headers add to the wear
+void save(uint8_t key, const void *value, uint8_t length){
+    char report[90];
 
-    // While the guess is not q or Q, aka: while the user does not want to quit
-    while (guess != 0){
-        
-        ST7789_Fill_Color(BLACK); // MUST REMOVE THIS FOR DEBUGGING. IT MAY HIDE USEFUL ERRORS IF NOT COMMENTED
-        ST7789_WriteString(7, 10, "Enter 1-1 for Instructions", Font_11x18, WHITE, BLACK);
-        ST7789_WriteString(7, 30, "Enter 0-0 to Quit :(", Font_11x18, WHITE, BLACK);
-        ST7789_WriteString(7, 50, "Enter 0-1 to Play :D", Font_11x18, WHITE, BLACK);
-        //ST7789_WriteString(7, 70, "Enter 10 for Settings", Font_11x18, WHITE, BLACK); // Unfortunately settings were not done, see function declarations for why
-        //strout("Enter 11 for Instructions - Enter 00 for Quit - Enter 01 for Play", 7, 10, 69, 4);
-        
-        ST7789_WriteString(7, 110, "Short press ", Font_11x18, WHITE, BLACK);
-        ST7789_WriteString(151, 110, "(RED)", Font_11x18, RED, BLACK);
-        ST7789_WriteString(211, 110, " for 0", Font_11x18, WHITE, BLACK);
+    if (!StorePut(&store, key, value, length)){
+        SerialQueue("store: save failed\r\n");
+        return;
+    }
+    sprintf(report, "store: key %u saved, %lu bytes programmed for %lu written, %lu erases, %lu bytes free\r\n",
+            key, store.programmed, store.written, store.erases, StoreFree(&store));
+    SerialQueue(report);
+}
 
-        ST7789_WriteString(7, 130, "Long press ", Font_11x18, WHITE, BLACK);
-        ST7789_WriteString(139, 130, "(GREEN)", Font_11x18, GREEN, BLACK);
-        ST7789_WriteString(223, 130, " for 1", Font_11x18, WHITE, BLACK);
+// Purpose: Saves the game to the backup registers. It is called whenever the game changes, so a reset loses at most
+//          the guess being entered. Saving is a few register writes, which are timed
+void suspendGame(){
+    Snapshot snapshot;
+    char report[40];
+    uint32_t start = DWT->CYCCNT;
 
-        ST7789_WriteString(7, 150, "Hold press ", Font_11x18, WHITE, BLACK);
-        ST7789_WriteString(139, 150, "(BLUE)", Font_11x18, BLUE, BLACK);
-        ST7789_WriteString(211, 150, " to redo", Font_11x18, WHITE, BLACK);
+    // A pack word has no place in the dictionary to come back to
+    if (packed){
+        return;
+    }
 
-        strout("Please enter your choice: ", 7, 190, 27, 1);
-        
-        guess = getBinaryInput(2);
+    snapshot.seed = orderSeed;
+    snapshot.round = wordNum;
+    snapshot.word = wordIndex;
+    snapshot.guessed = game.guessed;
+    snapshot.lives = game.lives;
+    snapshot.evil = evil;
+    snapshot.coded = coded;
+    snapshot.shortMean = learner.shortMean / 1000;
+    snapshot.longMean = learner.longMean / 1000;
+    BackupSave(&snapshot);
+    sprintf(report, "suspended in %lu cycles\r\n", DWT->CYCCNT - start);
+    SerialQueue(report);
+}
 
-        // If statement to determine where to send the user, either sends user to a function, or breaks the menu loop
-        if (guess == 3){
-            instructions();
-        }
-        else if (guess == 0){
-            break;
-        }
-        else if (guess == 2){
-            play(word);
-        }
-        else if (guess == 1){
+// Purpose: Goes on with the game in the backup registers, straight into guessing, or into the end of the round
+//          if its last guess won it. Returns false when there is none to go on with, e.g. after power up
+bool resumeGame(){
+    Snapshot snapshot;
 
-        }
-        else{
-            strout("Invalid input!!! Try again.", 7, 220, 28, 1);
-            pauseProgram();
+    // A snapshot made with another dictionary, or of a game that was lost, is no game to go back into
+    if (!BackupLoad(&snapshot) || snapshot.word >= DictCount || snapshot.round > DictCount || snapshot.lives == 0){
+        return false;
+    }
+    packed = false; // Only games of the built-in words are saved
+    coded = snapshot.coded;
+    evil = snapshot.evil;
+    orderSeed = snapshot.seed;
+    ShuffleInit(&order, DictCount, orderSeed);
+    wordNum = snapshot.round;
+    wordIndex = snapshot.word;
+    GameStart(&game, snapshot.lives);
+    GameWord(&game, DictView(wordIndex), DictMask(wordIndex));
+    game.guessed = snapshot.guessed;
+    PressLearnSet(&learner, &decoder, snapshot.shortMean * 1000UL, snapshot.longMean * 1000UL);
+
+    // The words that fit the guesses are all the ones with the guessed letters where the word has them. For the
+    // evil station that is the family it kept, as every family it chose fits the word. The whole words guessed
+    // wrong are not in the snapshot, so they are lost: they come back into the hints, and the evil station may
+    // switch to one of them later
+    CandAll(&candidates, GameLength(&game));
+    for (char letter = 'A' ; letter <= 'Z' ; letter++){
+        if (GameGuessed(&game, letter)){
+            CandKeep(&candidates, letter, GamePositions(&game, letter));
         }
     }
-    // If the user wanted to quit, the loop will break and goodbye() will trigger
-    goodbye();
+
+    ST7789_Fill_Color(BLACK);
+    goTo(GameWon(&game) ? roundWonState : guessState);
+    return true;
 }
 
-// Purpose: Outputs the instructions of the game to the user
-void instructions(){
+// Purpose: Draws one page of the instructions, under the same title
+void drawInstructions(int page){
 
     ST7789_Fill_Color(BLACK);
 
     char sentence[30] = "Instructions:";
     ST7789_WriteString(7, 10, sentence, Font_11x18, WHITE, BLACK);
 
-    strout("1. You will have to guess letters to try and complete the word hidden under the stars.", 7, 50, 87, 7);
-    pauseProgram();
+    if (page == 0){
+        strout("1. You will have to guess letters to try and complete the word hidden under the stars.", 7, 50, 87, 7);
+    }
+    else if (page == 1){
+        strout("2. If there are multiple instances of the same letter, they all are revealed upon guessing.", 7, 50, 92, 7);
+    }
+    else if (page == 2){
+        strout("3. Any incorrect guess deducts a life, once all lives are depleted, the game ends.", 7, 50, 83, 7);
+    }
+    else{
+        strout("4. If you guess the word before losing all your lives, you can move to a new word with your remaining lives.", 7, 50, 109, 7);
+    }
+}
 
-    strout("2. If there are multiple instances of the same letter, they all are revealed upon guessing.", 7, 50, 92, 7);
-    pauseProgram();
+// Purpose: Draws the menu options, see menuState()
+void drawMenu(int unused){
+    ST7789_Fill_Color(BLACK); // MUST REMOVE THIS FOR DEBUGGING. IT MAY HIDE USEFUL ERRORS IF NOT COMMENTED
+    ST7789_WriteString(7, 10, "Enter 1-1 for Instructions", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(7, 30, "Enter 0-0 for Settings/Quit", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(7, 50, "Enter 0-1 to Play :D", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(7, 70, "Enter 1-0 to Play with codes", Font_11x18, WHITE, BLACK);
+    //strout("Enter 11 for Instructions - Enter 00 for Quit - Enter 01 for Play", 7, 10, 69, 4);
+    
+    ST7789_WriteString(7, 110, "Short press ", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(151, 110, "(RED)", Font_11x18, RED, BLACK);
+    ST7789_WriteString(211, 110, " for 0", Font_11x18, WHITE, BLACK);
+
+    ST7789_WriteString(7, 130, "Long press ", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(139, 130, "(GREEN)", Font_11x18, GREEN, BLACK);
+    ST7789_WriteString(223, 130, " for 1", Font_11x18, WHITE, BLACK);
 
-    strout("3. Any incorrect guess deducts a life, once all lives are depleted, the game ends.", 7, 50, 83, 7);
-    pauseProgram();
+    ST7789_WriteString(7, 150, "Hold press ", Font_11x18, WHITE, BLACK);
+    ST7789_WriteString(139, 150, "(BLUE)", Font_11x18, BLUE, BLACK);
+    ST7789_WriteString(211, 150, " to redo", Font_11x18, WHITE, BLACK);
 
-    strout("4. If you guess the word before losing all your lives, you can move to a new word with your remaining lives.", 7, 50, 109, 7);
-    pauseProgram();
+    strout("Please enter your choice: ", 7, 190, 27, 1);
+}
+
+// Purpose: Lists the code of every letter under the input, shortest codes first, so the user can look them up.
+//          - is the code to exit, # the one to guess the whole word and ? the one for a hint
+void drawCodeTable(){
+    char entry[16];
+    int n = 0; // Entries listed so far, 6 to a column
+
+    for (int digits = 1 ; digits <= 13 && n < PREFIX_SYMBOLS ; digits++){
+        for (int symbol = 0 ; symbol < PREFIX_SYMBOLS ; symbol++){
+            if (letterCode.length[symbol] != digits){
+                continue;
+            }
+            entry[0] = symbol == PREFIX_EXIT ? '-' : symbol == PREFIX_WORD ? '#' : symbol == PREFIX_HINT ? '?' : 'A' + symbol;
+            entry[1] = ' ';
+            for (int i = 0 ; i < digits ; i++){
+                entry[2 + i] = '0' + ((letterCode.bits[symbol] >> i) & 1); // First digit to enter on the left
+            }
+            entry[2 + digits] = 0;
+            ST7789_WriteString(5 + (n / 6) * 96, 250 + (n % 6) * 12, entry, Font_7x10, WHITE, BLACK);
+            n++;
+        }
+    }
+}
+
+// Purpose: Draws a screen that never changes. The first time it is rendered with draw() and captured,
+//          after that the snapshot is replayed. Both times are reported over serial to compare them.
+void showScreen(ST7789_Snapshot *snapshot, void (*draw)(int), int arg, char name[]){
+    char report[60];
+    uint32_t start = DWT->CYCCNT;
+    bool replayed = snapshot->data != NULL;
+
+    if (replayed){
+        ST7789_FB_Restore(snapshot);
+    }
+    else{
+        draw(arg);
+    }
+
+    // Cycles to microseconds. Sending to the display is left to pollDisplay, so this is only the drawing into RAM
+    uint32_t time = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+    sprintf(report, "%s %i: %s in %lu us\r\n", name, arg, replayed ? "replayed" : "rendered", time);
+    SerialQueue(report); // Sent by SerialService from the main loop
+
+    // Captured after timing, so the render time stays comparable
+    if (!replayed){
+        ST7789_FB_Capture(snapshot);
+    }
 }
 
 // Purpose: Prints strings greater than one line in length, while moving to the next line when letters move off the page
@@ -516,28 +1244,17 @@ void strout(char sentence[], int x, int y, int size, int lines){
     }
 }
 
-// Purpose: Pauses the entire program by asking for user input to continue
-void pauseProgram(){
-
-    char sentence[30] = "Press blue to continue...";
-    ST7789_WriteString(7, 220, sentence, Font_11x18, WHITE, BLACK);
-    //printf("\nEnter any key to continue!\n");
-    while(HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13));
-    ST7789_WriteString(7, 220, "                         ", Font_11x18, WHITE, BLACK);
-    //fflush(stdin);
-}
-
-// Purpose: Outputs welcome message and asks to continue
-void welcome(){
+// Purpose: Draws the welcome titles
+void drawWelcome(int unused){
     // Variables for easy movement of the Titles as one group
     int xshift = -40;
     int yshift = 0;
 
-    ST7789_WriteString(80 + xshift, 40 + yshift, "Welcome", Font_16x26, LIGHTBLUE, BLACK);
-    ST7789_WriteString(110 + xshift, 70 + yshift, "to", Font_16x26, LIGHTBLUE, BLACK);
-    ST7789_WriteString(140 + xshift, 100 + yshift, "Binary", Font_16x26, LIGHTBLUE, BLACK);
-    ST7789_WriteString(170 + xshift, 130 + yshift, "HANGMAN!!!", Font_16x26, CYAN, BLACK);
-    pauseProgram();
+    // Font_7x10 at 3x, so the large Font_16x26 table is not needed
+    ST7789_WriteStringScaled(80 + xshift, 40 + yshift, "Welcome", Font_7x10, LIGHTBLUE, BLACK, 3);
+    ST7789_WriteStringScaled(110 + xshift, 74 + yshift, "to", Font_7x10, LIGHTBLUE, BLACK, 3);
+    ST7789_WriteStringScaled(140 + xshift, 108 + yshift, "Binary", Font_7x10, LIGHTBLUE, BLACK, 3);
+    ST7789_WriteStringScaled(170 + xshift, 142 + yshift, "HANGMAN!!!", Font_7x10, CYAN, BLACK, 3);
 }
 
 // Purpose: Outputs goodbye message
@@ -545,5 +1262,6 @@ void goodbye(){
     ST7789_Fill_Color(BLACK);
     strout("Goodbye! We hope you enjoyed and got valuable clues!!!", 7, 10, 55, 3);
     strout("By: Aditya Chaudhary and Ethan Bitnun", 7, 90, 38, 2);
+    ST7789_FB_End();
 }
 
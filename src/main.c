@@ -30,6 +30,7 @@
 #include "fonts.h"
 #include "spi.h"
 #include "gpio.h"
+#include "dma.h"
 
 /*int main(void)
 {
@@ -299,3 +300,15 @@ void SysTick_Handler(void)
     HAL_IncTick(); // tell HAL that a new tick has happened
     // we can do other things in here too if we need to, but be careful
 }
+
+// This function is called by the DMA controller when a transfer to the display finishes
+void DMA2_Stream3_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_spi1_tx);
+}
+
+// This function is called on every edge of the blue button (EXTI line 13), see button.c
+void EXTI15_10_IRQHandler(void)
+{
+    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
+}
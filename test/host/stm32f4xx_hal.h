@@ -0,0 +1,102 @@
+// Host stand-in for the STM32 HAL: just the types and calls the libraries under test use
+
+// The native tests build the libraries on the computer, where there is no
+// HAL. This header takes its place (platformio.ini puts test/host on the
+// include path of [env:native] only), and each test defines the calls it
+// needs, usually to record what the library sent to the hardware.
+
+#ifndef __STM32F4XX_HAL_H
+#define __STM32F4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum { HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+typedef struct { uint32_t MODER; } GPIO_TypeDef;
+typedef enum { GPIO_PIN_RESET, GPIO_PIN_SET } GPIO_PinState;
+
+extern GPIO_TypeDef HostGPIOA, HostGPIOB, HostGPIOC;
+#define GPIOA (&HostGPIOA)
+#define GPIOB (&HostGPIOB)
+#define GPIOC (&HostGPIOC)
+
+#define GPIO_PIN_0 0x0001
+#define GPIO_PIN_1 0x0002
+#define GPIO_PIN_4 0x0010
+#define GPIO_PIN_5 0x0020
+#define GPIO_PIN_6 0x0040
+#define GPIO_PIN_7 0x0080
+#define GPIO_PIN_13 0x2000
+
+#define GPIO_MODE_OUTPUT_PP 0x01
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000
+#define GPIO_NOPULL 0
+#define GPIO_PULLUP 1
+#define GPIO_SPEED_FREQ_VERY_HIGH 3
+
+typedef struct { uint32_t Pin, Mode, Pull, Speed, Alternate; } GPIO_InitTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+typedef enum { HAL_SPI_STATE_RESET, HAL_SPI_STATE_READY, HAL_SPI_STATE_BUSY_TX } HAL_SPI_StateTypeDef;
+typedef struct { uint32_t BaudRatePrescaler; } SPI_InitTypeDef;
+typedef struct { SPI_InitTypeDef Init; HAL_SPI_StateTypeDef State; } SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *spi, uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *spi, uint8_t *data, uint16_t size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *spi);
+
+typedef struct { uint32_t CR1, EGR, CNT, PSC, ARR; } TIM_TypeDef;
+typedef struct { uint32_t CFGR; } RCC_TypeDef;
+
+extern TIM_TypeDef HostTIM5;
+extern RCC_TypeDef HostRCC;
+#define TIM5 (&HostTIM5)
+#define RCC (&HostRCC)
+
+#define TIM_CR1_CEN 0x0001
+#define TIM_EGR_UG 0x0001
+#define RCC_CFGR_PPRE1 0x1C00
+#define RCC_CFGR_PPRE1_DIV1 0x0000
+
+#define __HAL_RCC_GPIOC_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_TIM5_CLK_ENABLE() ((void)0)
+
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+typedef enum { EXTI15_10_IRQn = 40 } IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+
+typedef struct { uint32_t BKP0R, BKP1R, BKP2R, BKP3R, BKP4R, BKP5R, BKP6R, BKP7R, BKP8R, BKP9R,
+                 BKP10R, BKP11R, BKP12R, BKP13R, BKP14R, BKP15R, BKP16R, BKP17R, BKP18R, BKP19R; } RTC_TypeDef;
+
+extern RTC_TypeDef HostRTC;
+#define RTC (&HostRTC)
+
+#define __HAL_RCC_PWR_CLK_ENABLE() ((void)0)
+
+void HAL_PWR_EnableBkUpAccess(void);
+
+#define FLASH_TYPEPROGRAM_WORD 2
+#define FLASH_TYPEERASE_SECTORS 0
+#define FLASH_SECTOR_6 6
+#define FLASH_VOLTAGE_RANGE_3 2
+
+typedef struct { uint32_t TypeErase, Banks, Sector, NbSectors, VoltageRange; } FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t address, uint64_t data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *erase, uint32_t *failed);
+
+void HAL_Delay(uint32_t delay);
+uint32_t HAL_GetTick(void);
+
+#endif
@@ -0,0 +1,145 @@
+// Tests of the button's edge ring, fed with edges the way the EXTI interrupt does
+
+#include <unity.h>
+#include "button.h"
+
+void setUp(void){
+    ButtonFlush();
+}
+
+void tearDown(void){
+}
+
+// Purpose: Pushes a press and its release, like a clean press of the button
+static void press(uint32_t down, uint32_t up){
+    ButtonPushEdge(down, true);
+    ButtonPushEdge(up, false);
+}
+
+void test_empty_ring_has_no_event(void){
+    ButtonEvent event;
+
+    TEST_ASSERT_FALSE(ButtonGetEvent(&event));
+}
+
+void test_edges_come_out_in_order_with_their_times(void){
+    static const uint32_t times[] = {1000, 1150, 2000, 3500};
+    ButtonEvent event;
+
+    press(1000, 1150);
+    press(2000, 3500);
+    for (int i = 0 ; i < 4 ; i++){
+        TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+        TEST_ASSERT_EQUAL(i % 2 == 0, event.pressed);
+        TEST_ASSERT_EQUAL_UINT32(times[i], event.time);
+    }
+    TEST_ASSERT_FALSE(ButtonGetEvent(&event));
+}
+
+void test_bouncing_edges_are_all_kept(void){
+    // A contact bounce is a burst of edges microseconds apart; the ring keeps them all for the decoder to judge
+    static const uint32_t times[] = {500, 503, 507, 512, 20000, 20004};
+    ButtonEvent event;
+
+    for (int i = 0 ; i < 6 ; i++){
+        ButtonPushEdge(times[i], i % 2 == 0);
+    }
+    for (int i = 0 ; i < 6 ; i++){
+        TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+        TEST_ASSERT_EQUAL_UINT32(times[i], event.time);
+        TEST_ASSERT_EQUAL(i % 2 == 0, event.pressed);
+    }
+}
+
+void test_full_ring_drops_the_newest_edges(void){
+    uint32_t dropped = ButtonDropped();
+    ButtonEvent event;
+
+    for (uint32_t i = 0 ; i < BUTTON_QUEUE_SIZE + 5 ; i++){
+        ButtonPushEdge(i, true);
+    }
+    TEST_ASSERT_EQUAL_UINT32(dropped + 5, ButtonDropped());
+
+    // The edges already in the ring are kept, the ones that did not fit are lost
+    for (uint32_t i = 0 ; i < BUTTON_QUEUE_SIZE ; i++){
+        TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+        TEST_ASSERT_EQUAL_UINT32(i, event.time);
+    }
+    TEST_ASSERT_FALSE(ButtonGetEvent(&event));
+}
+
+void test_taking_an_edge_makes_room(void){
+    uint32_t dropped = ButtonDropped();
+    ButtonEvent event;
+
+    for (uint32_t i = 0 ; i < BUTTON_QUEUE_SIZE ; i++){
+        ButtonPushEdge(i, false);
+    }
+    TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+    ButtonPushEdge(999, true);
+    TEST_ASSERT_EQUAL_UINT32(dropped, ButtonDropped());
+    for (uint32_t i = 1 ; i < BUTTON_QUEUE_SIZE ; i++){
+        TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+        TEST_ASSERT_EQUAL_UINT32(i, event.time);
+    }
+    TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+    TEST_ASSERT_EQUAL_UINT32(999, event.time);
+    TEST_ASSERT_TRUE(event.pressed);
+}
+
+void test_ring_wraps_many_times(void){
+    ButtonEvent event;
+    uint32_t next = 0;
+
+    // Pushes and takes interleaved unevenly, so head and tail go round the ring at different places
+    for (uint32_t round = 0 ; round < 1000 ; round++){
+        uint32_t count = 1 + round % (BUTTON_QUEUE_SIZE - 1);
+
+        for (uint32_t i = 0 ; i < count ; i++){
+            ButtonPushEdge(next + i, (next + i) & 1);
+        }
+        for (uint32_t i = 0 ; i < count ; i++){
+            TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+            TEST_ASSERT_EQUAL_UINT32(next + i, event.time);
+            TEST_ASSERT_EQUAL((next + i) & 1, event.pressed);
+        }
+        next += count;
+    }
+    TEST_ASSERT_FALSE(ButtonGetEvent(&event));
+}
+
+void test_times_keep_wrapping_around(void){
+    ButtonEvent event;
+
+    // The microsecond counter wraps after 2^32 us, the edges just carry the raw counts
+    press(0xFFFFFF00UL, 0x00000100UL);
+    TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFF00UL, event.time);
+    TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+    TEST_ASSERT_EQUAL_UINT32(0x00000100UL, event.time);
+    TEST_ASSERT_EQUAL_UINT32(0x200, event.time - 0xFFFFFF00UL);
+}
+
+void test_flush_throws_away_pending_edges(void){
+    ButtonEvent event;
+
+    press(10, 20);
+    ButtonFlush();
+    TEST_ASSERT_FALSE(ButtonGetEvent(&event));
+    press(30, 40);
+    TEST_ASSERT_TRUE(ButtonGetEvent(&event));
+    TEST_ASSERT_EQUAL_UINT32(30, event.time);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_ring_has_no_event);
+    RUN_TEST(test_edges_come_out_in_order_with_their_times);
+    RUN_TEST(test_bouncing_edges_are_all_kept);
+    RUN_TEST(test_full_ring_drops_the_newest_edges);
+    RUN_TEST(test_taking_an_edge_makes_room);
+    RUN_TEST(test_ring_wraps_many_times);
+    RUN_TEST(test_times_keep_wrapping_around);
+    RUN_TEST(test_flush_throws_away_pending_edges);
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+// Tests of the flat word list and the DAWG against each other, and how big and fast each of them is
+
+// The tests run on whatever list the build was given: the words of src/words.txt
+// in [env:native], or 50000 made-up words in [env:native_large] (see
+// tools/dictionary.py), which is the size the DAWG was added for.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "dictionary.h"
+#include "dawg.h"
+
+static char (*sorted)[DICT_MAX_LENGTH + 1]; // Every word of the flat list, in alphabetical order
+
+// Purpose: Orders two words the way the DAWG does, alphabetically
+static int compare(const void *a, const void *b){
+    return strcmp(a, b);
+}
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+// Purpose: Returns how many edges the DAWG has. Its nodes are laid out in the order they are
+//          reached from the root, so the last one to start is found by following every edge once
+static uint32_t dawgEdges(void){
+    uint32_t end = 1; // The root has at least one edge
+
+    for (uint32_t edge = 0 ; edge < end ; edge++){
+        uint32_t child = DawgChild(DawgEdges[edge]);
+
+        if (child != 0){
+            while (!(DawgEdges[child] & DAWG_LAST)){
+                child++;
+            }
+            if (child + 1 > end){
+                end = child + 1;
+            }
+        }
+        if (edge + 1 == end && !(DawgEdges[edge] & DAWG_LAST)){
+            end++; // The root's run goes on
+        }
+    }
+    return end;
+}
+
+void test_every_word_is_found_by_both(void){
+    char word[DICT_MAX_LENGTH];
+
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        uint8_t length = DictWord(i, word);
+
+        TEST_ASSERT_EQUAL_INT(i, DictFind(word, length));
+        TEST_ASSERT_TRUE(DawgContains(word, length));
+    }
+}
+
+void test_both_refuse_the_same_non_words(void){
+    char word[DICT_MAX_LENGTH + 1];
+    uint32_t refused = 0;
+
+    // Every word with its last letter changed, and with a letter added or taken off
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        uint8_t length = DictWord(i, word);
+
+        word[length - 1] = word[length - 1] == 'Z' ? 'A' : word[length - 1] + 1;
+        TEST_ASSERT_EQUAL(DictFind(word, length) >= 0, DawgContains(word, length));
+        refused += DictFind(word, length) < 0;
+        if (length < DICT_MAX_LENGTH){
+            word[length] = 'Q';
+            TEST_ASSERT_EQUAL(DictFind(word, length + 1) >= 0, DawgContains(word, length + 1));
+        }
+        TEST_ASSERT_EQUAL(DictFind(word, length - 1) >= 0, DawgContains(word, length - 1));
+    }
+    TEST_ASSERT_TRUE(refused > 0);
+}
+
+void test_dawg_words_are_the_flat_words_in_order(void){
+    char word[DICT_MAX_LENGTH + 1];
+    uint32_t lengths[DICT_MAX_LENGTH + 1] = {0};
+
+    TEST_ASSERT_EQUAL_UINT32(DictCount, DawgTotal);
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        uint8_t length = DictWord(i, sorted[i]);
+
+        sorted[i][length] = 0;
+        lengths[length]++;
+    }
+    qsort(sorted, DictCount, sizeof(sorted[0]), compare);
+
+    for (uint32_t i = 0 ; i < DawgTotal ; i++){
+        uint8_t length = DawgWord(i, word);
+
+        word[length] = 0;
+        TEST_ASSERT_EQUAL_STRING(sorted[i], word);
+    }
+    TEST_ASSERT_EQUAL(0, DawgWord(DawgTotal, word));
+    for (int length = 0 ; length <= DICT_MAX_LENGTH ; length++){
+        TEST_ASSERT_EQUAL_UINT32(lengths[length], DawgCount(length));
+    }
+}
+
+void test_size_and_speed(void){
+    enum { ROUNDS = 20 };
+    char word[DICT_MAX_LENGTH], report[120];
+    uint32_t letters = DictOffsets[DictCount];
+    uint32_t flat, dawg, edges = dawgEdges(), found = 0;
+    double flatTime, dawgTime;
+    clock_t start;
+
+    // The same sums tools/dictionary.py prints when it builds them
+    flat = (letters * DICT_BITS + 7) / 8 + 1 + 4 * (DictCount + 1) + 4 * DictCount + sizeof(DictSeed) * DictBuckets + 4 * 26 * DICT_SETS;
+    dawg = 4 * edges + sizeof(DawgTally) * edges + 4 * (DAWG_MAX_LENGTH + 1) + 4;
+
+    // Each word fetched by its index and looked up again, the way the game uses them
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        for (uint32_t i = 0 ; i < DictCount ; i++){
+            found += DictFind(word, DictWord(i, word)) >= 0;
+        }
+    }
+    flatTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        for (uint32_t i = 0 ; i < DawgTotal ; i++){
+            found += DawgContains(word, DawgWord(i, word));
+        }
+    }
+    dawgTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_EQUAL_UINT32(2 * ROUNDS * DictCount, found);
+    snprintf(report, sizeof(report), "%u words: flat %lu bytes, %.0f ns per word; DAWG %lu bytes (%lu edges), %.0f ns per word",
+             (unsigned)DictCount, (unsigned long)flat, flatTime * 1e9 / ROUNDS / DictCount,
+             (unsigned long)dawg, (unsigned long)edges, dawgTime * 1e9 / ROUNDS / DawgTotal);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    sorted = malloc(sizeof(sorted[0]) * DICT_WORDS);
+    UNITY_BEGIN();
+    RUN_TEST(test_every_word_is_found_by_both);
+    RUN_TEST(test_both_refuse_the_same_non_words);
+    RUN_TEST(test_dawg_words_are_the_flat_words_in_order);
+    RUN_TEST(test_size_and_speed);
+    free(sorted);
+    return UNITY_END();
+}
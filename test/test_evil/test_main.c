@@ -0,0 +1,159 @@
+// Tests of the evil station's partitions, and how long one takes on a large list
+
+// The tests run on whatever list the build was given: the words of src/words.txt
+// in [env:native], or 10000 and 100000 made-up words in [env:native_10k] and
+// [env:native_100k] (see tools/dictionary.py). The family each guess keeps is
+// checked against one counted here word by word, with every pattern of
+// positions in a table of its own instead of EvilGuess()'s small hash table.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "evil.h"
+
+static uint32_t family[1UL << DICT_MAX_LENGTH]; // Words of each pattern of positions
+static Candidates candidates;
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+// Purpose: The length most words have, so the partitions are as big as the list makes them
+static uint8_t commonLength(void){
+    uint32_t lengths[DICT_MAX_LENGTH + 1] = {0};
+    uint8_t common = 0;
+
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        lengths[DictLength(i)]++;
+    }
+    for (int length = 1 ; length <= DICT_MAX_LENGTH ; length++){
+        if (lengths[length] > lengths[common]){
+            common = length;
+        }
+    }
+    return common;
+}
+
+// Purpose: The positions EvilGuess() should keep for letter: the biggest family, the one without the letter
+//          if it is as big, then the fewest positions, then the lowest. Returns 0xFFFF if there are more
+//          families than EvilGuess() tells apart
+static uint16_t expectedFamily(const Candidates *set, char letter, uint32_t *count){
+    uint32_t families = 0, best = 0;
+
+    memset(family, 0, sizeof(family));
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        if (CandHas(set, i)){
+            uint16_t positions = CandPositions(i, letter);
+
+            families += family[positions]++ == 0;
+        }
+    }
+    for (uint32_t positions = 1 ; positions < (1UL << DICT_MAX_LENGTH) ; positions++){
+        if (family[positions] > family[best] || (family[positions] == family[best] && best != 0
+                && __builtin_popcount(positions) < __builtin_popcount(best))){
+            best = positions;
+        }
+    }
+    *count = family[best];
+    return families > EVIL_FAMILIES ? 0xFFFF : best;
+}
+
+void test_biggest_family_is_kept(void){
+    uint8_t length = commonLength();
+    int checked = 0;
+
+    for (char letter = 'A' ; letter <= 'Z' ; letter++){
+        uint32_t count;
+        uint16_t expected, kept;
+
+        CandAll(&candidates, length);
+        expected = expectedFamily(&candidates, letter, &count);
+        if (expected == 0xFFFF){
+            continue; // Too many families for the hash table, a real word list never has them
+        }
+        kept = EvilGuess(&candidates, letter);
+        TEST_ASSERT_EQUAL_HEX16(expected, kept);
+        TEST_ASSERT_EQUAL_UINT32(count, candidates.count);
+        checked++;
+    }
+    TEST_ASSERT_TRUE(checked > 20);
+}
+
+void test_kept_words_all_show_the_same_positions(void){
+    uint16_t kept;
+
+    CandAll(&candidates, commonLength());
+    kept = EvilGuess(&candidates, 'E');
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        if (CandHas(&candidates, i)){
+            TEST_ASSERT_EQUAL_HEX16(kept, CandPositions(i, 'E'));
+        }
+    }
+}
+
+void test_a_game_never_runs_out_of_words(void){
+    static const char order[] = "ETAOINSHRDLCUMWFGYPBVKJXQZ";
+    uint32_t before;
+
+    // The most common letters first, as a player would, until one word is left or every letter is guessed
+    CandAll(&candidates, commonLength());
+    for (int i = 0 ; order[i] && candidates.count > 1 ; i++){
+        before = candidates.count;
+        EvilGuess(&candidates, order[i]);
+        TEST_ASSERT_TRUE(candidates.count > 0);
+        TEST_ASSERT_TRUE(candidates.count <= before);
+    }
+    TEST_ASSERT_TRUE(CandFirst(&candidates) >= 0);
+}
+
+void test_same_guesses_leave_the_same_words(void){
+    static Candidates first;
+
+    CandAll(&first, commonLength());
+    EvilGuess(&first, 'S');
+    EvilGuess(&first, 'A');
+    CandAll(&candidates, commonLength());
+    EvilGuess(&candidates, 'S');
+    EvilGuess(&candidates, 'A');
+    TEST_ASSERT_EQUAL_UINT32(first.count, candidates.count);
+    TEST_ASSERT_EQUAL_MEMORY(first.bits, candidates.bits, sizeof(first.bits));
+}
+
+void test_partition_time(void){
+    enum { ROUNDS = 20 };
+    uint8_t length = commonLength();
+    uint32_t words;
+    double seconds = 0;
+    char report[120];
+
+    // The first guess of a game is the biggest partition there is: every word of the length, one guess of each letter
+    CandAll(&candidates, length);
+    words = candidates.count;
+    for (int round = 0 ; round < ROUNDS ; round++){
+        for (char letter = 'A' ; letter <= 'Z' ; letter++){
+            clock_t start;
+
+            CandAll(&candidates, length);
+            start = clock();
+            EvilGuess(&candidates, letter);
+            seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+        }
+    }
+
+    snprintf(report, sizeof(report), "%lu words, %lu of %u letters: %.1f us per partition, %.1f ns per word",
+             (unsigned long)DictCount, (unsigned long)words, length, seconds * 1e6 / ROUNDS / 26, seconds * 1e9 / ROUNDS / 26 / words);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_biggest_family_is_kept);
+    RUN_TEST(test_kept_words_all_show_the_same_positions);
+    RUN_TEST(test_a_game_never_runs_out_of_words);
+    RUN_TEST(test_same_guesses_leave_the_same_words);
+    RUN_TEST(test_partition_time);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+// Tests of the game rules, on words packed here the way tools/dictionary.py packs them, and how many turns a second they take
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "game.h"
+
+static uint8_t packed[64]; // The letters of the test word, 5 bits each, with the spare byte at the end
+static Game game;
+
+// Purpose: Packs a word in upper case like the dictionary stores it, starting shift bits into the first byte
+static WordView view(const char *word, uint8_t shift){
+    WordView view = {packed, shift, strlen(word)};
+    uint32_t bit = shift;
+
+    memset(packed, 0, sizeof(packed));
+    for (int i = 0 ; word[i] ; i++, bit += DICT_BITS){
+        uint16_t letter = (word[i] - 'A' + 1) << (bit & 7);
+
+        packed[bit >> 3] |= letter;
+        packed[(bit >> 3) + 1] |= letter >> 8;
+    }
+    return view;
+}
+
+// Purpose: Starts a game with the default lives on this word
+static void play(const char *word){
+    WordView stored = view(word, 3);
+
+    GameStart(&game, GAME_LIVES);
+    GameWord(&game, stored, GameMask(stored));
+}
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+void test_word_is_read_where_it_is_packed(void){
+    for (uint8_t shift = 0 ; shift < 8 ; shift++){
+        WordView word = view("QUIZ", shift);
+
+        TEST_ASSERT_EQUAL('Q', WordLetter(word, 0));
+        TEST_ASSERT_EQUAL('Z', WordLetter(word, 3));
+        TEST_ASSERT_EQUAL_HEX32(GameBit('Q') | GameBit('U') | GameBit('I') | GameBit('Z'), GameMask(word));
+    }
+}
+
+void test_hits_and_misses(void){
+    play("LAPTOP");
+    TEST_ASSERT_EQUAL(GAME_HIT, GameGuess(&game, 'P'));
+    TEST_ASSERT_EQUAL(GAME_LIVES, game.lives);
+    TEST_ASSERT_EQUAL_HEX16(0x24, GamePositions(&game, 'P')); // Third and sixth letters
+    TEST_ASSERT_TRUE(GameRevealed(&game, 2));
+    TEST_ASSERT_FALSE(GameRevealed(&game, 0));
+
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuess(&game, 'E'));
+    TEST_ASSERT_EQUAL(GAME_LIVES - 1, game.lives);
+    TEST_ASSERT_TRUE(GameGuessed(&game, 'E'));
+    TEST_ASSERT_EQUAL_HEX16(0, GamePositions(&game, 'E'));
+}
+
+void test_lower_case_is_the_same_guess(void){
+    play("KNIFE");
+    TEST_ASSERT_EQUAL(GAME_HIT, GameGuess(&game, 'k'));
+    TEST_ASSERT_TRUE(GameGuessed(&game, 'K'));
+    TEST_ASSERT_EQUAL(GAME_REPEAT, GameGuess(&game, 'K'));
+}
+
+void test_repeat_guesses_cost_nothing(void){
+    play("KNIFE");
+    GameGuess(&game, 'N');
+    GameGuess(&game, 'X');
+    TEST_ASSERT_EQUAL(GAME_REPEAT, GameGuess(&game, 'N'));
+    TEST_ASSERT_EQUAL(GAME_REPEAT, GameGuess(&game, 'X')); // A wrong letter again is not another life
+    TEST_ASSERT_EQUAL(GAME_REPEAT, GameGuess(&game, 'x'));
+    TEST_ASSERT_EQUAL(GAME_LIVES - 1, game.lives);
+}
+
+void test_invalid_guesses_cost_a_life_every_time(void){
+    static const char invalid[] = {'0', '@', '[', '`', '{', ' ', 0x7F};
+
+    play("NUCLEO");
+    for (int i = 0 ; i < (int)sizeof(invalid) ; i++){
+        TEST_ASSERT_EQUAL(GAME_INVALID, GameGuess(&game, invalid[i]));
+    }
+    TEST_ASSERT_EQUAL(0, game.lives);
+    TEST_ASSERT_TRUE(GameLost(&game));
+    TEST_ASSERT_EQUAL_HEX32(0, game.guessed);
+}
+
+void test_game_is_won_when_every_letter_is_guessed(void){
+    play("PROFESSOR");
+    for (const char *c = "PROFE" ; *c ; c++){
+        TEST_ASSERT_FALSE(GameWon(&game));
+        TEST_ASSERT_EQUAL(GAME_HIT, GameGuess(&game, *c));
+    }
+    TEST_ASSERT_FALSE(GameWon(&game));
+    GameGuess(&game, 'S');
+    TEST_ASSERT_TRUE(GameWon(&game));
+    TEST_ASSERT_FALSE(GameLost(&game));
+    TEST_ASSERT_EQUAL(GAME_LIVES, game.lives);
+}
+
+void test_game_is_lost_with_the_last_life(void){
+    play("PHYSICS");
+    for (const char *c = "ABDEFG" ; *c ; c++){
+        GameGuess(&game, *c);
+        TEST_ASSERT_FALSE(GameLost(&game));
+    }
+    TEST_ASSERT_EQUAL(1, game.lives);
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuess(&game, 'J'));
+    TEST_ASSERT_TRUE(GameLost(&game));
+    TEST_ASSERT_FALSE(GameWon(&game));
+}
+
+void test_whole_word_guess(void){
+    play("LAPTOP");
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuessWord(&game, "LAPTOPS", 7)); // Longer, with the word at its start
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuessWord(&game, "LAPTO", 5));
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuessWord(&game, "LAPTOB", 6));
+    TEST_ASSERT_EQUAL(GAME_LIVES - 3, game.lives);
+    TEST_ASSERT_FALSE(GameWon(&game));
+    TEST_ASSERT_EQUAL(GAME_HIT, GameGuessWord(&game, "LAPTOP", 6));
+    TEST_ASSERT_TRUE(GameWon(&game));
+    for (int i = 0 ; i < 6 ; i++){
+        TEST_ASSERT_TRUE(GameRevealed(&game, i));
+    }
+}
+
+void test_lives_carry_over_to_the_next_word(void){
+    WordView next;
+
+    play("KNIFE");
+    GameGuess(&game, 'Z');
+    GameGuess(&game, 'K');
+    next = view("NUCLEO", 0);
+    GameWord(&game, next, GameMask(next));
+    TEST_ASSERT_EQUAL(GAME_LIVES - 1, game.lives);
+    TEST_ASSERT_FALSE(GameGuessed(&game, 'K')); // The guesses start over
+    TEST_ASSERT_EQUAL(GAME_HIT, GameGuess(&game, 'N'));
+}
+
+void test_swap_keeps_guesses_and_lives(void){
+    WordView other;
+
+    // The evil station moves to another word with the same revealed letters
+    play("CAT");
+    GameGuess(&game, 'A');
+    GameGuess(&game, 'E');
+    other = view("BAT", 0);
+    GameSwap(&game, other, GameMask(other));
+    TEST_ASSERT_EQUAL('B', GameLetter(&game, 0));
+    TEST_ASSERT_TRUE(GameGuessed(&game, 'A'));
+    TEST_ASSERT_TRUE(GameGuessed(&game, 'E'));
+    TEST_ASSERT_EQUAL(GAME_LIVES - 1, game.lives);
+    TEST_ASSERT_EQUAL(GAME_MISS, GameGuess(&game, 'C'));
+}
+
+void test_turns_per_second(void){
+    enum { GAMES = 200000 };
+    static const char *const words[] = {"PROFESSOR", "LAPTOP", "KNIFE", "NUCLEO", "PHYSICS", "ABCDEFGHIJKLMNOP"};
+    uint32_t turns = 0, won = 0, seed = 12345;
+    char report[80];
+    clock_t start = clock();
+
+    // Random guesses, in either case, until the word is won or lost
+    for (int g = 0 ; g < GAMES ; g++){
+        play(words[g % 6]);
+        while (!GameWon(&game) && !GameLost(&game)){
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            GameGuess(&game, (seed & 0x20 ? 'a' : 'A') + (seed >> 8) % 26);
+            turns++;
+        }
+        won += GameWon(&game);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_TRUE(won > 0 && won < GAMES);
+    snprintf(report, sizeof(report), "%.1f million turns a second on this computer", turns / seconds / 1e6);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_word_is_read_where_it_is_packed);
+    RUN_TEST(test_hits_and_misses);
+    RUN_TEST(test_lower_case_is_the_same_guess);
+    RUN_TEST(test_repeat_guesses_cost_nothing);
+    RUN_TEST(test_invalid_guesses_cost_a_life_every_time);
+    RUN_TEST(test_game_is_won_when_every_letter_is_guessed);
+    RUN_TEST(test_game_is_lost_with_the_last_life);
+    RUN_TEST(test_whole_word_guess);
+    RUN_TEST(test_lives_carry_over_to_the_next_word);
+    RUN_TEST(test_swap_keeps_guesses_and_lives);
+    RUN_TEST(test_turns_per_second);
+    return UNITY_END();
+}
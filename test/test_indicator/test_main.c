@@ -0,0 +1,212 @@
+// Tests of the live press indicator, counting the glyphs and bar pieces it sends to the panel
+
+// The indicator draws straight to the panel here (no framebuffer is begun), so
+// every drawing call shows up on the SPI bus as a CASET/RASET window. A window
+// the height of a Font_11x18 glyph is a digit, one the height of the bar is a
+// piece of the bar. Each test holds the button with the decoder, refreshes the
+// indicator every 40 ms like the game's timer, and counts the windows.
+
+#include <stdio.h>
+#include <unity.h>
+#include "indicator.h"
+#include "st7789 drivers.h"
+
+#define MS 1000UL // Microseconds in a millisecond
+#define FRAME (40 * MS) // The game refreshes the indicator 25 times a second
+
+GPIO_TypeDef HostGPIOA, HostGPIOB, HostGPIOC;
+SPI_HandleTypeDef hspi1;
+
+static bool dc; // Level of the DC pin, high for data
+static uint8_t lastCommand;
+static uint8_t window[4]; // The data of the latest RASET
+static int windowBytes;
+static int glyphs; // Digits drawn
+static int bars; // Pieces of the bar drawn or erased
+static int barPixels; // Columns the pieces of the bar cover together
+static uint16_t barColumns; // Width of the latest CASET, for barPixels
+static uint8_t column[4];
+static int columnBytes;
+
+static PressDecoder decoder;
+static Indicator indicator;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state){
+    if (port == ST7789_DC_PORT && pin == ST7789_DC_PIN){
+        dc = state == GPIO_PIN_SET;
+    }
+}
+
+// Purpose: Sorts every RASET by its height into a glyph or a piece of the bar, and keeps the CASET width for the bar
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *spi, uint8_t *bytes, uint16_t size, uint32_t timeout){
+    for (int i = 0 ; i < size ; i++){
+        if (!dc){
+            lastCommand = bytes[i];
+            windowBytes = columnBytes = 0;
+        }
+        else if (lastCommand == ST7789_CASET && columnBytes < 4){
+            column[columnBytes++] = bytes[i];
+            if (columnBytes == 4){
+                barColumns = (column[2] << 8 | column[3]) - (column[0] << 8 | column[1]) + 1;
+            }
+        }
+        else if (lastCommand == ST7789_RASET && windowBytes < 4){
+            window[windowBytes++] = bytes[i];
+            if (windowBytes == 4){
+                int height = (window[2] << 8 | window[3]) - (window[0] << 8 | window[1]) + 1;
+
+                if (height == Font_11x18.height){
+                    glyphs++;
+                }
+                else if (height == INDICATOR_BAR_HEIGHT){
+                    bars++;
+                    barPixels += barColumns;
+                }
+            }
+        }
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *spi, uint8_t *bytes, uint16_t size){
+    return HAL_SPI_Transmit(spi, bytes, size, HAL_MAX_DELAY);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *spi){
+    return HAL_SPI_STATE_READY;
+}
+
+void HAL_Delay(uint32_t delay){
+}
+
+uint32_t HAL_GetTick(void){
+    return 0;
+}
+
+void setUp(void){
+    PressInit(&decoder, &(PressConfig)PRESS_DEFAULT_CONFIG);
+    IndicatorInit(&indicator);
+    ST7789_ResetClip();
+    glyphs = bars = barPixels = 0;
+}
+
+void tearDown(void){
+}
+
+// Purpose: Holds the button from start for held microseconds, refreshing the indicator every frame, then lets it go.
+//          The indicator is left as it was at the last refresh
+static void hold(uint32_t start, uint32_t held){
+    uint32_t t;
+
+    PressFeed(&decoder, start, true);
+    for (t = start + FRAME ; t < start + held ; t += FRAME){
+        PressPoll(&decoder, t);
+        IndicatorShow(&indicator, &decoder, t, 5);
+    }
+    PressFeed(&decoder, start + held, false);
+    PressPoll(&decoder, start + held + 30 * MS);
+}
+
+void test_short_press_draws_one_glyph(void){
+    hold(1000 * MS, 300 * MS);
+    TEST_ASSERT_EQUAL(1, glyphs);
+}
+
+void test_each_threshold_draws_one_glyph(void){
+    // 0, then 1 at 500 ms, then D at 2500 ms: three glyphs for over 70 refreshes
+    hold(1000 * MS, 3000 * MS);
+    TEST_ASSERT_EQUAL(3, glyphs);
+}
+
+void test_released_button_draws_nothing(void){
+    for (uint32_t t = 0 ; t < 2000 * MS ; t += FRAME){
+        PressPoll(&decoder, t);
+        IndicatorShow(&indicator, &decoder, t, 5);
+    }
+    TEST_ASSERT_EQUAL(0, glyphs);
+    TEST_ASSERT_EQUAL(0, bars);
+}
+
+void test_bar_only_draws_what_grew(void){
+    // A 0 held to just before the 1: the bar reaches nearly across, a piece per frame, never more than the width
+    hold(1000 * MS, 490 * MS);
+    TEST_ASSERT_TRUE(barPixels <= INDICATOR_BAR_WIDTH);
+    TEST_ASSERT_TRUE(barPixels >= INDICATOR_BAR_WIDTH * 400 / 500);
+    TEST_ASSERT_TRUE(bars <= (int)(490 * MS / FRAME));
+}
+
+void test_bar_starts_over_at_each_threshold(void){
+    PressFeed(&decoder, 0, true);
+    PressPoll(&decoder, 30 * MS);
+    IndicatorShow(&indicator, &decoder, 400 * MS, 5);
+    TEST_ASSERT_EQUAL(INDICATOR_BAR_WIDTH * 400 / 500, indicator.bar);
+
+    // Past 500 ms it is a 1: the bar is erased and fills again towards the redo at 2500 ms
+    IndicatorShow(&indicator, &decoder, 1000 * MS, 5);
+    TEST_ASSERT_EQUAL(PRESS_ONE, indicator.shown);
+    TEST_ASSERT_EQUAL(INDICATOR_BAR_WIDTH * 500 / 2000, indicator.bar);
+
+    // Nothing comes after a redo, the bar stays empty
+    IndicatorShow(&indicator, &decoder, 3000 * MS, 5);
+    TEST_ASSERT_EQUAL(PRESS_REDO, indicator.shown);
+    TEST_ASSERT_EQUAL(0, indicator.bar);
+}
+
+void test_same_state_draws_nothing_again(void){
+    PressFeed(&decoder, 0, true);
+    PressPoll(&decoder, 30 * MS);
+    IndicatorShow(&indicator, &decoder, 100 * MS, 5);
+    glyphs = bars = 0;
+
+    // The same time again, as when the timer fires faster than the bar grows
+    IndicatorShow(&indicator, &decoder, 100 * MS, 5);
+    TEST_ASSERT_EQUAL(0, glyphs);
+    TEST_ASSERT_EQUAL(0, bars);
+}
+
+void test_clear_only_erases_a_drawn_bar(void){
+    IndicatorClear(&indicator);
+    TEST_ASSERT_EQUAL(0, bars);
+    PressFeed(&decoder, 0, true);
+    PressPoll(&decoder, 30 * MS);
+    IndicatorShow(&indicator, &decoder, 200 * MS, 5);
+    bars = 0;
+    IndicatorClear(&indicator);
+    TEST_ASSERT_EQUAL(1, bars);
+    TEST_ASSERT_EQUAL(PRESS_NONE, indicator.shown);
+}
+
+void test_glyph_writes_per_press(void){
+    // Presses as the players of the game make them: mostly 0s and 1s, now and then a redo
+    static const uint32_t lengths[] = {150, 220, 310, 420, 700, 900, 1100, 1400, 2000, 3200};
+    int presses = sizeof(lengths) / sizeof(lengths[0]);
+    int frames = 0;
+    uint32_t t = 0;
+    char report[100];
+
+    for (int i = 0 ; i < presses ; i++){
+        hold(t, lengths[i] * MS);
+        IndicatorClear(&indicator); // The game does this once the press is decided
+        frames += lengths[i] * MS / FRAME;
+        t += lengths[i] * MS + 500 * MS;
+    }
+
+    // 0s take one glyph, 1s two and redos three: 4 * 1 + 5 * 2 + 1 * 3
+    TEST_ASSERT_EQUAL(17, glyphs);
+    snprintf(report, sizeof(report), "%.1f glyph writes and %.1f bar pieces per press, over %.1f refreshes per press",
+             (double)glyphs / presses, (double)bars / presses, (double)frames / presses);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_short_press_draws_one_glyph);
+    RUN_TEST(test_each_threshold_draws_one_glyph);
+    RUN_TEST(test_released_button_draws_nothing);
+    RUN_TEST(test_bar_only_draws_what_grew);
+    RUN_TEST(test_bar_starts_over_at_each_threshold);
+    RUN_TEST(test_same_state_draws_nothing_again);
+    RUN_TEST(test_clear_only_erases_a_drawn_bar);
+    RUN_TEST(test_glyph_writes_per_press);
+    return UNITY_END();
+}
@@ -0,0 +1,399 @@
+// Card images for test/test_pack, written by test/test_pack/cards.py: do not edit
+
+#define CARD_WORDS 600 // Words in the pack
+
+// The words of the pack, in upper case
+static const char *const cardWords[CARD_WORDS] = {
+    "B", "SWPDVXPO", "BQJGNFMYATPRSYS", "KIKHTT", "DVBTVHMRGQXNN", "EDJP", "LMKWBHJGCBN", "HQ",
+    "LPTEPZKVO", "HKMDNGSEYTBQUAMR", "FOIEASH", "XDEUSZWWXDDZTR", "MDKUC", "TSXILDOFKNAL", "SWR", "VBQELLGPPJ",
+    "I", "MLDHQLBL", "GYBHJRETJSMJPER", "MQUSIN", "XGPLTGSXFUIQO", "OKDF", "EZFAYFKZIPX", "PF",
+    "ODIBSGGSZ", "GXQCDORCJVULWVEP", "EJFJRHY", "AQGCLZOCJWYLAV", "HLQIF", "XOJFZNKLUMFC", "CXS", "BKTVGFENJO",
+    "A", "OSCBTFXI", "COHTLBYGHFUFTCU", "MIXDFY", "THGLZXCRTPADN", "WUNC", "JYUUYBBNQCK", "RF",
+    "CKQGWQCYO", "HMLTZRJRGZYPZODJ", "BRUERAM", "IBDOLPKHPEOXVE", "LQQJA", "ZHWUZAMZCNJA", "SRR", "LPWDHLGRKH",
+    "G", "UAYZHHJC", "FKKBAVUEJGIIBCD", "HSFNWY", "MKCMVVEEXPFKO", "VUFH", "JHLLFCKQITX", "PF",
+    "SYXIEDFCO", "SRYPMBYSMZRFJBJH", "YUTRWPD", "OEWHYXWJIMICJZ", "YPKWG", "UNVRVYHEYOFI", "QTC", "WWTHUZDUZN",
+    "G", "BQLFVVUN", "MQWJSYOOKGIBJWP", "RPEGKC", "FZWTKRYZVRPJO", "KUEY", "ISHJWDOLQUH", "IS",
+    "OAJAJFDSZ", "WJQCUAHLSYIANTIR", "NQFYFHO", "ZDZIOALZHFNBMD", "CZMIS", "UEPWENHAXGZT", "PRE", "MCMHUDNEVM",
+    "J", "SZKIHPTH", "BYJVCUXNFSCIFEJ", "HVGQCJ", "UXWDOEBBRCAKX", "KJAT", "SZVHFNOXIQQ", "QM",
+    "ZSEIQFACV", "NSEXXPREQAGZXYVH", "RHOKZFB", "EGAZGPYGALHZJC", "JFZCL", "LCFPRSILPECP", "SBB", "HXLUQDITBW",
+    "S", "GCDSCJWG", "BAIJWSYMUBZGNDI", "ZFFKQG", "AYBJEZLGZTWMP", "HOZW", "CXNOTHXPODH", "LW",
+    "JGSJCQEVV", "LDMCIRVEKTIEKZER", "JCPJQTH", "HHPTXIVWCEGMYT", "BLVNP", "HEKZSFCTFYLI", "WLH", "GVMHUNDKXR",
+    "C", "MORUEZGB", "TCXIYDSADJJACOC", "ZZELXZ", "ADEXGEFCWSTAI", "CHIL", "HOQOCOQSJMB", "HL",
+    "SOYDYYGIS", "MZCQPCXZAWENYGVK", "OORRWSO", "OKWSAHUQBNWJSN", "HUYFV", "FKKFHSTGFSDY", "LCJ", "RAOWGDFHFY",
+    "S", "DBWYLLLZ", "MUXNUQUEZYGWOYK", "OVQMRG", "VURAOCZVNWSNT", "EWAF", "KLPRFZNTYBM", "JT",
+    "TRKQLXZKG", "KYXSGBCRWZACRVYL", "OBOQVWX", "PNQPHOHHCJIJRN", "OYSRA", "EJRTCNRZNDPT", "KOT", "CCAJWVZQMA",
+    "J", "LPBASAQD", "XUHBRRKVDWICDGO", "FFQSBM", "EEGNXHRHOQSTD", "UOJH", "CODESESRQHA", "CR",
+    "HYBLGLTPG", "OKQJWIPWJLMBBGKT", "QDASGVJ", "TBCNWIPZKTVSTE", "AWOEC", "BHYISHZTFONK", "JXU", "QCTBXJZOFF",
+    "X", "ZPWAMATP", "ZLIIZSLNCQOOWRJ", "HBBUVZ", "RHBPOUCIHPENY", "ISQC", "QKOZHLMHOAI", "GX",
+    "MWJAOXFHJ", "USMTAGLZFJKCXLVP", "QLQGSMD", "ZXFFUGFXYHEVML", "GIFRK", "BTQSIBULXESS", "XMP", "YRLSJRTHRA",
+    "U", "ORMBNAMV", "OQFJNYZPOCKLTWI", "GCWZOE", "VDQZODJUTBPAP", "ZMAD", "WJCKOBXQOSX", "QP",
+    "CSAVSXQHZ", "NTWHEBQPPCQBPWZL", "SSTXMKI", "WJGDAUMENKKPOF", "WDKFN", "MANMRZNFAYHB", "EHC", "TGAIHHGKDM",
+    "M", "QHWKMGAW", "RGIYSJBBWSMYJOD", "PYSWIG", "HKLNBLDFJIRNH", "BCES", "HJDMISHJHCV", "PC",
+    "SJVYPMYEL", "QJWOOMBLVHPKHGAM", "PVIWMEZ", "ASQUGVJUERARMO", "GWRAY", "YEVLLPJYTTTW", "DOI", "SSTLGDJDAJ",
+    "U", "KXZCRJGK", "WTDCBAMTQYBTDUC", "RHARPF", "AELOIRTUQZSWD", "HXRH", "KQAGOSCHLKJ", "WX",
+    "DCSUAVWCH", "UUTGJYWJFBCLVYGX", "ZSZRKXX", "BESWOZCLPNYKSE", "YCBDF", "NSJASADPJQDJ", "UTL", "XGVLUKFPRP",
+    "A", "JJNRVOPQ", "UADTZRDYOAPLYMK", "RRCWHO", "EQNLZCBRFEEHS", "FEVI", "OLODURHUMQA", "DK",
+    "RFKTKZFVY", "ABYLRTALQCCNZVYC", "ARLWVEO", "ZMJBTIMJYAPCWD", "XMXKL", "AADGEJDWHFNY", "MYU", "TWQFBEMHJW",
+    "U", "DLVVTHGZ", "LFYKBSLOXLCNFXK", "NNGMQO", "SMFJCCQDLARYL", "DOBF", "AYMQJPLDJNM", "OM",
+    "DAFVUJBJU", "JPYELNVUIKZTLPOH", "TVIDUCM", "QDSTGWEDTNQDBX", "EIQLU", "WVMFBLRQJZDT", "TSG", "WXQCCWTMZU",
+    "M", "UJYGGLQX", "QTMTNSOFCPAQABJ", "VGFBVW", "LCJDAOZWBJSYF", "INLI", "OYAGSPWTXEG", "GC",
+    "GJJOKAJXA", "ORMCMOZNMHKUAWVS", "PKQALNO", "AKSPUQENJVBIYB", "MXXRE", "ZZLQATVOQZBB", "RGH", "JSLPRFJOOL",
+    "E", "CEMXSHNK", "YNOBVGZGBUXUDAX", "NFTCOS", "GAIRDSXHXXBMC", "ZGXE", "LSVLWRIFZFZ", "YS",
+    "XFNRRJTJH", "SVBQLOXZRYWGZRGF", "BODVUSR", "ZZCPMRJMJKDWGN", "FTWZP", "JFMNNNKOOEJT", "LMF", "FEVCUUYKEA",
+    "C", "OYGZPCOP", "OLWLLXYUQBXTIQU", "GWKMDP", "QYZZWWZQBGKBY", "KVYS", "ZFTYXCPHZBL", "FI",
+    "IJELAUGXI", "WMYOTXLUOXLNCDQV", "KJJFDYK", "KYHKXWQWZFMDYC", "LETUA", "CHUPACVIKJLO", "FXO", "XAETDAPGDH",
+    "X", "VYPVMESN", "PKEBWJLKGACFDOC", "XFBTDC", "JQHBSAXHQHDVW", "MUGU", "TEDHZRGGWKB", "ZZ",
+    "CETSMXAXN", "AXPLVAFJLPXKAWNY", "JRHPQIW", "DFXNETZCJLMUTR", "BHCGL", "ZFFIBBXAYXFC", "KDZ", "NTONAKARKG",
+    "G", "CAISQYAO", "BANIOUYTCRQKDQP", "XESZMS", "DYPAJKGIRRVCC", "DKKM", "OXCRLTUUUVA", "CK",
+    "LJMVCUQJR", "MGPLCGHFZTHULOCB", "PRHOKVM", "BTNIJVPNXEVETI", "LLQQX", "SCLCJGVMFDQX", "QPR", "SGVPHRCUUL",
+    "Q", "HPXBXWCN", "XTSTMWMRBZJMWQO", "EWPNDA", "QZISRYFWHLNON", "JLID", "IKFZMVCIQAJ", "ZN",
+    "WOFOEXXBI", "JKSSJFTZUVAVCRRH", "PUUAQXW", "ZELHTCKIGSCMSW", "JSPSY", "BPDWNRSBHIDB", "MMW", "LJRUWIYXVS",
+    "M", "CVCSYYFV", "TDQIKFDKCPUHNOL", "ISRIAC", "QWUBSYBKPYETY", "ANTF", "UXXATLRVJKR", "IE",
+    "QYROJRWPB", "PLBTFCUALSHRGQUZ", "GVOUKAT", "NDKEWUKOUYEKWH", "BUUZO", "FTGUZFMCAXAE", "CXW", "AWHDLEPJPE",
+    "U", "VMVLYYYF", "GQQWMNTPQICBXMF", "ZFEBAN", "IEQSOSLYQRZVB", "DZWL", "VCUYILKWRUM", "GD",
+    "TXWLOVQRM", "TZODXEOIXAZVEKYE", "QMPLVJJ", "PEEPVAEEADJCRN", "ACSGP", "VVCUJIOSSUZV", "TUO", "XOHAZJIZES",
+    "S", "LQRRNXUN", "LCCBEZWIHJLHULI", "PGKJHJ", "VYKFPYQAHEHHG", "FFTL", "KHTRNBFLQXW", "TY",
+    "JPQFMKTGT", "DGRSFOUKMSBINLHM", "IUKZDTH", "HBHCNNEHCFWXCS", "WNTVO", "ISQZMBHNSIXQ", "IMI", "ALUGZNQFRJ",
+    "K", "EJEDSEPJ", "ALSMHOCTYQXMACH", "GZLGSQ", "HNQBMYEAOCINH", "KIOY", "NNTZPISSDPP", "AV",
+    "JUVUKUCDI", "VQPJXUHROCTQUJBD", "OMKPAFR", "NZYDHCGSRWNKSR", "VUWGQ", "DURXLYWEBHLK", "SBO", "BIFLQHPYLE",
+    "W", "RRSVMTIB", "EMDSDMGGVZULJUF", "KXSRMB", "WIEORRCLCWNBL", "EQLQ", "VESOPVTSJPE", "TM",
+    "EOBFSYEYW", "WXHMJWQIXCWCTITL", "ODLIGSH", "QCNVUTJLLMBYCY", "UTQQO", "YHVYMGLKWJZL", "DHU", "NNWVZDOXIN",
+    "L", "NTXFBPOR", "EJAPBZVLCLMQKSR", "KMTEDI", "UBCFIVXBQVVME", "BQPF", "FIGFSVWSLNT", "EJ",
+    "OOUUVOTEQ", "BGQNSRAFEUWBFJZV", "XZRTGUL", "PPUQFSCUVJWHAJ", "OIPFA", "GLWZJULWMKRF", "PQY", "WWGTGZSFUN",
+    "W", "XWXYLYAS", "GONXFFHOFEGYHUA", "HEXFFF", "APLSVDRJBOEAH", "LZUQ", "PHAQBOQTOXK", "TW",
+    "VECLLTGCL", "JEUXZJZBVMQQSAMB", "DOEZUJX", "STSKDCKGUMNSKX", "SSKHL", "NPYPJRMZNUGK", "SKS", "QVADLHTZVY",
+    "O", "HHPRTMNS", "TVFIHTBTDIJOQBB", "CIQPDD", "KFSOEUBEJTLUC", "RUTO", "GZCMKQDLILB", "FF",
+    "EJGHEXMIZ", "LIDXQSBGDRETWZGB", "HGRTQLR", "JHPWDEBGUPEJVY", "NDTAD", "WMBEGCYKWTZL", "QIW", "ITRLMNLNUL",
+    "T", "ZHSVAUVY", "JJBHONFCXWJQGIT", "XANUOS", "XFWJIQMTFPADY", "JZAU", "TFCZPPCRTJC", "CP",
+    "JVJERRDGT", "ZEFOEPQFZITMHPCM", "UYBZFVN", "KBAMXQDWOTCKJJ", "QGEUV", "RNFBKSBPYQTC", "DDU", "HLQGEDICKF",
+    "Q", "JGRCUCZO", "MUYZWAWHKUSNOXO", "QDZNIQ", "YVBAKBFZDIEAO", "JIGP", "EOPXTCUZEXC", "FQ",
+    "WQNJOXOJN", "SDFYULSMFLLFKBIY", "GFHORKM", "JYNYDHCFNWGQLZ", "KKEFL", "XUJCFPTMCYEH", "XPL", "POVIQGOQKQ",
+    "G", "HEZCTDBU", "HFIOGONBNGUWCYK", "DHDUAY", "JVGNTPVHSIPIF", "VLAA", "PCZNLKMPFHW", "TW",
+    "QREUVJQBJ", "SQOGYLFNJWMUBUHF", "CBNWRMU", "BUVWZKZTEZJDDK", "CSYMX", "VQPNLESYJJYI", "WIK", "SKOLFFGPDK",
+    "L", "PEADBZUI", "DQLKSFFYTSKVZCQ", "JUFQJG", "HBKOCTBQHYMDK", "NBFZ", "MZEBJZPHNEQ", "BT",
+    "IVXSPCXQG", "VYHPWYQCBXIOFBFY", "UVRUCDX", "PYTPTQKGLNGHUA", "IRICA", "WRNSYVMUCFSP", "PAQ", "BNHPZRLHOG",
+    "R", "HBRWJPHC", "OPCVYLKVSOHNGCU", "KZPBGD", "RNIUUPRRDOXHO", "KDGE", "KLAPPIPBWYU", "MZ",
+    "SFDXSQFJS", "VLENJGGLRDSMLQHK", "SSSNCVE", "VLABBIFWXPUFNV", "NHUYO", "XHFVMQOAOCDO", "TTX", "SJDVIYEPLX",
+    "Z", "XVXSCEDL", "KNZMKZISDBBYBRJ", "JXVQTY", "TDFGQLQTGVLCI", "NVAR", "IEVABMRLXPE", "VJ",
+    "FRBUCYHAQ", "IDOBNMWBPUJZRRLN", "EEDDVOE", "TAAWRRQMTUKQEC", "RAZVA", "ZDKCLCYPOKDV", "ALR", "SECJXCEVWY",
+    "A", "JYOKEORL", "PNBVSMFSRHPGGFQ", "JDXVLD", "NHIBVDADVPBUE", "IJNR", "ZAVYVMDFFMO", "EW",
+    "MRCKFPXYB", "LDNHYRZMFJMEKVKS", "XIMKLVU", "OIQGQKRNKFUQED", "EHIHU", "ZUWPANOQGOQQ", "VPJ", "KCGJAZVLUN",
+    "I", "XIARFZRX", "NVOWLYTOKMOZMRP", "XMASXQ", "WNOFLROZWCINP", "MZNY", "IHSUPIMIBWQ", "XD",
+};
+
+// WORDS.TXT, the pack's text
+static const char cardText[6061] =
+    "B SWPDVXPO\x0A\x42QJGNFMYATPRSYS\x0D\x0Akikhtt\x09\x44VBTVHMRGQXNN  EDJP LMKWBHJGC"
+    "BN\x0AHQ\x0D\x0Alptepzkvo\x09HKMDNGSEYTBQUAMR  FOIEASH XDEUSZWWXDDZTR\x0AMDKUC\x0D"
+    "\x0Atsxildofknal\x09SWR  VBQELLGPPJ I\x0AMLDHQLBL\x0D\x0Agybhjretjsmjper\x09MQUSIN"
+    "  XGPLTGSXFUIQO OKDF\x0A\x45ZFAYFKZIPX\x0D\x0Apf\x09ODIBSGGSZ  GXQCDORCJVULWVEP"
+    " EJFJRHY\x0A\x41QGCLZOCJWYLAV\x0D\x0Ahlqif\x09XOJFZNKLUMFC  CXS BKTVGFENJO\x0A\x41\x0D\x0Ao"
+    "scbtfxi\x09\x43OHTLBYGHFUFTCU  MIXDFY THGLZXCRTPADN\x0Ax2 WUNC\x0D\x0Ajyuuybbnq"
+    "ck\x09RF  CKQGWQCYO HMLTZRJRGZYPZODJ\x0A\x42RUERAM\x0D\x0Aibdolpkhpeoxve\x09LQQJA "
+    " ZHWUZAMZCNJA SRR\x0ALPWDHLGRKH\x0D\x0Ag\x09UAYZHHJC  FKKBAVUEJGIIBCD HSFNWY"
+    "\x0AMKCMVVEEXPFKO\x0D\x0Avufh\x09JHLLFCKQITX  PF SYXIEDFCO\x0ASRYPMBYSMZRFJBJH\x0D"
+    "\x0Ayutrwpd\x09OEWHYXWJIMICJZ  YPKWG UNVRVYHEYOFI\x0AQTC\x0D\x0Awwthuzduzn\x09G  B"
+    "QLFVVUN MQWJSYOOKGIBJWP\x0ARPEGKC\x0D\x0A\x66zwtkryzvrpjo\x09KUEY  ISHJWDOLQUH "
+    "IS\x0AOAJAJFDSZ\x0D\x0Awjqcuahlsyiantir\x09\x44ON'T NQFYFHO  ZDZIOALZHFNBMD CZM"
+    "IS\x0AUEPWENHAXGZT\x0D\x0Apre\x09MCMHUDNEVM  J SZKIHPTH\x0A\x42YJVCUXNFSCIFEJ\x0D\x0Ahvg"
+    "qcj\x09UXWDOEBBRCAKX  KJAT SZVHFNOXIQQ\x0AQM\x0D\x0Azseiqfacv\x09NSEXXPREQAGZXY"
+    "VH  RHOKZFB EGAZGPYGALHZJC\x0AJFZCL\x0D\x0Alcfprsilpecp\x09SBB  HXLUQDITBW S"
+    "\x0AGCDSCJWG\x0D\x0A\x62\x61ijwsymubzgndi\x09ZFFKQG  AYBJEZLGZTWMP HOZW\x0A\x43XNOTHXPOD"
+    "H\x0D\x0Alw\x09JGSJCQEVV  LDMCIRVEKTIEKZER JCPJQTH\x0AHHPTXIVWCEGMYT\x0D\x0A\x62lvnp\x09"
+    "HEKZSFCTFYLI  WLH AAAAAAAAAAAAAAAAA GVMHUNDKXR\x0A\x43\x0D\x0Amoruezgb\x09TCXIY"
+    "DSADJJACOC  ZZELXZ ADEXGEFCWSTAI\x0A\x43HIL\x0D\x0Ahoqocoqsjmb\x09HL  SOYDYYGIS"
+    " MZCQPCXZAWENYGVK\x0AOORRWSO\x0D\x0Aokwsahuqbnwjsn\x09HUYFV  FKKFHSTGFSDY LC"
+    "J\x0ARAOWGDFHFY\x0D\x0As\x09\x44\x42WYLLLZ  MUXNUQUEZYGWOYK OVQMRG\x0AVURAOCZVNWSNT\x0D\x0A"
+    "ewaf\x09KLPRFZNTYBM  JT TRKQLXZKG\x0AKYXSGBCRWZACRVYL\x0D\x0Aoboqvwx\x09PNQPHOH"
+    "HCJIJRN  OYSRA EJRTCNRZNDPT\x0AKOT\x0D\x0A\x63\x63\x61jwvzqma\x09J  LPBASAQD XUHBRRKV"
+    "DWICDGO\x0A\x46\x46QSBM\x0D\x0A\x34\x32 eegnxhrhoqstd\x09UOJH  CODESESRQHA CR\x0AHYBLGLTPG\x0D"
+    "\x0Aokqjwipwjlmbbgkt\x09QDASGVJ  TBCNWIPZKTVSTE AWOEC\x0A\x42HYISHZTFONK\x0D\x0Ajx"
+    "u\x09QCTBXJZOFF  X ZPWAMATP\x0AZLIIZSLNCQOOWRJ\x0D\x0Ahbbuvz\x09RHBPOUCIHPENY  "
+    "ISQC QKOZHLMHOAI\x0AGX\x0D\x0Amwjaoxfhj\x09USMTAGLZFJKCXLVP  QLQGSMD ZXFFUGF"
+    "XYHEVML\x0AGIFRK\x0D\x0A\x62tqsibulxess\x09XMP  YRLSJRTHRA U\x0AORMBNAMV\x0D\x0Aoqfjnyzp"
+    "ockltwi\x09GCWZOE  VDQZODJUTBPAP ZMAD\x0AWJCKOBXQOSX\x0D\x0Aqp\x09\x43SAVSXQHZ  - "
+    "NTWHEBQPPCQBPWZL SSTXMKI\x0AWJGDAUMENKKPOF\x0D\x0Awdkfn\x09MANMRZNFAYHB  EHC"
+    " TGAIHHGKDM\x0AM\x0D\x0Aqhwkmgaw\x09RGIYSJBBWSMYJOD  PYSWIG HKLNBLDFJIRNH\x0A\x42\x43"
+    "ES\x0D\x0Ahjdmishjhcv\x09PC  SJVYPMYEL QJWOOMBLVHPKHGAM\x0APVIWMEZ\x0D\x0A\x61squgvju"
+    "erarmo\x09GWRAY  YEVLLPJYTTTW DOI\x0ASSTLGDJDAJ\x0D\x0Au\x09KXZCRJGK  WTDCBAMTQ"
+    "YBTDUC RHARPF\x0A\x41\x45LOIRTUQZSWD\x0D\x0Ahxrh\x09KQAGOSCHLKJ  WX DCSUAVWCH\x0AUUTG"
+    "JYWJFBCLVYGX\x0D\x0Azszrkxx\x09\x42\x45SWOZCLPNYKSE  YCBDF NSJASADPJQDJ\x0A\x65-mail "
+    "UTL\x0D\x0Axgvlukfprp\x09\x41  JJNRVOPQ UADTZRDYOAPLYMK\x0ARRCWHO\x0D\x0A\x65qnlzcbrfeeh"
+    "s\x09\x46\x45VI  OLODURHUMQA DK\x0ARFKTKZFVY\x0D\x0A\x61\x62ylrtalqccnzvyc\x09\x41RLWVEO  ZMJB"
+    "TIMJYAPCWD XMXKL\x0A\x41\x41\x44GEJDWHFNY\x0D\x0Amyu\x09TWQFBEMHJW  U DLVVTHGZ\x0ALFYKBS"
+    "LOXLCNFXK\x0D\x0Anngmqo\x09SMFJCCQDLARYL  DOBF AYMQJPLDJNM\x0AOM\x0D\x0A\x64\x61\x66vujbju\x09"
+    "JPYELNVUIKZTLPOH  TVIDUCM QDSTGWEDTNQDBX\x0A\x45IQLU\x0D\x0Awvmfblrqjzdt\x09TSG"
+    "  WXQCCWTMZU M\x0AUJYGGLQX\x0D\x0Aqtmtnsofcpaqabj\x09x2 VGFBVW  LCJDAOZWBJSY"
+    "F INLI\x0AOYAGSPWTXEG\x0D\x0Agc\x09GJJOKAJXA  ORMCMOZNMHKUAWVS PKQALNO\x0A\x41KSPU"
+    "QENJVBIYB\x0D\x0Amxxre\x09ZZLQATVOQZBB  RGH JSLPRFJOOL\x0A\x45\x0D\x0A\x63\x65mxshnk\x09YNOBVG"
+    "ZGBUXUDAX  NFTCOS GAIRDSXHXXBMC\x0AZGXE\x0D\x0Alsvlwrifzfz\x09YS  XFNRRJTJH "
+    "SVBQLOXZRYWGZRGF\x0A\x42ODVUSR\x0D\x0Azzcpmrjmjkdwgn\x09\x46TWZP  JFMNNNKOOEJT LMF"
+    "\x0A\x46\x45VCUUYKEA\x0D\x0A\x63\x09OYGZPCOP  OLWLLXYUQBXTIQU GWKMDP\x0AQYZZWWZQBGKBY\x0D\x0Ak"
+    "vys\x09ZFTYXCPHZBL  FI DON'T IJELAUGXI\x0AWMYOTXLUOXLNCDQV\x0D\x0Akjjfdyk\x09KY"
+    "HKXWQWZFMDYC  LETUA CHUPACVIKJLO\x0A\x46XO\x0D\x0Axaetdapgdh\x09X  VYPVMESN PKE"
+    "BWJLKGACFDOC\x0AXFBTDC\x0D\x0Ajqhbsaxhqhdvw\x09MUGU  TEDHZRGGWKB ZZ\x0A\x43\x45TSMXAX"
+    "N\x0D\x0A\x61xplvafjlpxkawny\x09JRHPQIW  DFXNETZCJLMUTR BHCGL\x0AZFFIBBXAYXFC\x0D\x0A"
+    "kdz\x09NTONAKARKG  G CAISQYAO\x0A\x42\x41NIOUYTCRQKDQP\x0D\x0Axeszms\x09\x44YPAJKGIRRVCC"
+    "  DKKM OXCRLTUUUVA\x0A\x43K\x0D\x0Aljmvcuqjr\x09MGPLCGHFZTHULOCB  PRHOKVM BTNIJ"
+    "VPNXEVETI\x0ALLQQX\x0D\x0A\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41\x41 sclcjgvmfdqx\x09QPR  SGVPHRCUUL "
+    "Q\x0AHPXBXWCN\x0D\x0Axtstmwmrbzjmwqo\x09\x45WPNDA  QZISRYFWHLNON JLID\x0AIKFZMVCIQ"
+    "AJ\x0D\x0Azn\x09WOFOEXXBI  JKSSJFTZUVAVCRRH PUUAQXW\x0AZELHTCKIGSCMSW\x0D\x0Ajspsy"
+    "\x09\x42PDWNRSBHIDB  MMW LJRUWIYXVS\x0AM\x0D\x0A\x63vcsyyfv\x09TDQIKFDKCPUHNOL  ISRIA"
+    "C QWUBSYBKPYETY\x0A\x41NTF\x0D\x0Auxxatlrvjkr\x09IE  QYROJRWPB PLBTFCUALSHRGQUZ"
+    "\x0AGVOUKAT\x0D\x0Andkewukouyekwh\x09\x42UUZO  FTGUZFMCAXAE CXW\x0A\x41WHDLEPJPE\x0D\x0Au\x09V"
+    "MVLYYYF  42 GQQWMNTPQICBXMF ZFEBAN\x0AIEQSOSLYQRZVB\x0D\x0A\x64zwl\x09VCUYILKWR"
+    "UM  GD TXWLOVQRM\x0ATZODXEOIXAZVEKYE\x0D\x0Aqmplvjj\x09PEEPVAEEADJCRN  ACSGP"
+    " VVCUJIOSSUZV\x0ATUO\x0D\x0Axohazjizes\x09S  LQRRNXUN LCCBEZWIHJLHULI\x0APGKJHJ"
+    "\x0D\x0Avykfpyqahehhg\x09\x46\x46TL  KHTRNBFLQXW TY\x0AJPQFMKTGT\x0D\x0A\x64grsfoukmsbinlhm"
+    "\x09IUKZDTH  HBHCNNEHCFWXCS WNTVO\x0AISQZMBHNSIXQ\x0D\x0Aimi\x09\x41LUGZNQFRJ  K E"
+    "JEDSEPJ\x0A\x41LSMHOCTYQXMACH\x0D\x0Agzlgsq\x09HNQBMYEAOCINH  KIOY NNTZPISSDPP\x0A"
+    "- AV\x0D\x0Ajuvukucdi\x09VQPJXUHROCTQUJBD  OMKPAFR NZYDHCGSRWNKSR\x0AVUWGQ\x0D\x0A"
+    "durxlywebhlk\x09SBO  BIFLQHPYLE W\x0ARRSVMTIB\x0D\x0A\x65mdsdmggvzuljuf\x09KXSRMB "
+    " WIEORRCLCWNBL EQLQ\x0AVESOPVTSJPE\x0D\x0Atm\x09\x45OBFSYEYW  WXHMJWQIXCWCTITL "
+    "ODLIGSH\x0AQCNVUTJLLMBYCY\x0D\x0Autqqo\x09YHVYMGLKWJZL  DHU NNWVZDOXIN\x0AL\x0D\x0Ant"
+    "xfbpor\x09\x45JAPBZVLCLMQKSR  KMTEDI UBCFIVXBQVVME\x0A\x42QPF\x0D\x0A\x66igfsvwslnt\x09\x45"
+    "J  OOUUVOTEQ BGQNSRAFEUWBFJZV\x0AXZRTGUL\x0D\x0Appuqfscuvjwhaj\x09\x65-mail OIP"
+    "FA  GLWZJULWMKRF PQY\x0AWWGTGZSFUN\x0D\x0Aw\x09XWXYLYAS  GONXFFHOFEGYHUA HEX"
+    "FFF\x0A\x41PLSVDRJBOEAH\x0D\x0Alzuq\x09PHAQBOQTOXK  TW VECLLTGCL\x0AJEUXZJZBVMQQSA"
+    "MB\x0D\x0A\x64oezujx\x09STSKDCKGUMNSKX  SSKHL NPYPJRMZNUGK\x0ASKS\x0D\x0Aqvadlhtzvy\x09O"
+    "  HHPRTMNS TVFIHTBTDIJOQBB\x0A\x43IQPDD\x0D\x0Akfsoeubejtluc\x09RUTO  GZCMKQDLI"
+    "LB FF\x0A\x45JGHEXMIZ\x0D\x0Alidxqsbgdretwzgb\x09HGRTQLR  JHPWDEBGUPEJVY NDTAD\x0A"
+    "WMBEGCYKWTZL\x0D\x0Aqiw\x09ITRLMNLNUL  T x2 ZHSVAUVY\x0AJJBHONFCXWJQGIT\x0D\x0Axan"
+    "uos\x09XFWJIQMTFPADY  JZAU TFCZPPCRTJC\x0A\x43P\x0D\x0Ajvjerrdgt\x09ZEFOEPQFZITMHP"
+    "CM  UYBZFVN KBAMXQDWOTCKJJ\x0AQGEUV\x0D\x0Arnfbksbpyqtc\x09\x44\x44U  HLQGEDICKF Q"
+    "\x0AJGRCUCZO\x0D\x0Amuyzwawhkusnoxo\x09QDZNIQ  YVBAKBFZDIEAO JIGP\x0A\x45OPXTCUZEX"
+    "C\x0D\x0A\x66q\x09WQNJOXOJN  SDFYULSMFLLFKBIY GFHORKM\x0AJYNYDHCFNWGQLZ\x0D\x0Akkefl\x09"
+    "XUJCFPTMCYEH  XPL POVIQGOQKQ\x0AG\x0D\x0Ahezctdbu\x09HFIOGONBNGUWCYK  DHDUAY"
+    " JVGNTPVHSIPIF\x0AVLAA\x0D\x0A\x44ON'T pcznlkmpfhw\x09TW  QREUVJQBJ SQOGYLFNJWM"
+    "UBUHF\x0A\x43\x42NWRMU\x0D\x0A\x62uvwzkztezjddk\x09\x43SYMX  VQPNLESYJJYI WIK\x0ASKOLFFGPDK"
+    "\x0D\x0Al\x09PEADBZUI  DQLKSFFYTSKVZCQ JUFQJG\x0AHBKOCTBQHYMDK\x0D\x0Anbfz\x09MZEBJZP"
+    "HNEQ  BT IVXSPCXQG\x0AVYHPWYQCBXIOFBFY\x0D\x0Auvrucdx\x09PYTPTQKGLNGHUA  IRI"
+    "CA WRNSYVMUCFSP\x0APAQ\x0D\x0A\x62nhpzrlhog\x09R  HBRWJPHC OPCVYLKVSOHNGCU\x0AKZPB"
+    "GD\x0D\x0Arniuuprrdoxho\x09KDGE  KLAPPIPBWYU MZ\x0ASFDXSQFJS\x0D\x0Avlenjgglrdsmlq"
+    "hk\x09SSSNCVE  AAAAAAAAAAAAAAAAA VLABBIFWXPUFNV NHUYO\x0AXHFVMQOAOCDO\x0D"
+    "\x0Attx\x09SJDVIYEPLX  Z XVXSCEDL\x0AKNZMKZISDBBYBRJ\x0D\x0Ajxvqty\x09TDFGQLQTGVLC"
+    "I  NVAR IEVABMRLXPE\x0AVJ\x0D\x0A\x66rbucyhaq\x09IDOBNMWBPUJZRRLN  EEDDVOE TAAW"
+    "RRQMTUKQEC\x0ARAZVA\x0D\x0Azdkclcypokdv\x09\x41LR  SECJXCEVWY A\x0AJYOKEORL\x0D\x0Apnbvs"
+    "mfsrhpggfq\x09JDXVLD  NHIBVDADVPBUE IJNR\x0AZAVYVMDFFMO\x0D\x0A\x65w\x09MRCKFPXYB "
+    " LDNHYRZMFJMEKVKS XIMKLVU\x0AOIQGQKRNKFUQED\x0D\x0A\x65hihu\x09ZUWPANOQGOQQ  VP"
+    "J KCGJAZVLUN\x0A\x34\x32 I\x0D\x0Axiarfzrx\x09NVOWLYTOKMOZMRP  XMASXQ WNOFLROZWCIN"
+    "P\x0AMZNY\x0D\x0Aihsupimibwq\x09XD  ZZZZZZZZZZZZZZZZZZZZZ";
+
+// FAT16 on the whole card, 4200 clusters of 2 blocks, the pack in clusters 3000, 5, 300, 6, 4100, 7
+static const CardRun card16Runs[] = {
+    {0, 0, 23, "\xEB\x3C\x90MSWIN4.1\x00\x02\x02\x01\x00\x02\x00\x02\x13\x21\xF8\x11"},
+    {0, 510, 2, "U\xAA"},
+    {1, 0, 16, "\xF8\xFF\xFF\xFF\x00\x00\x00\x00\x00\x00\x2C\x01\x04\x10\xFF\xFF"},
+    {2, 88, 1, "\x06"},
+    {12, 368, 1, "\x05"},
+    {17, 8, 1, "\x07"},
+    {18, 0, 16, "\xF8\xFF\xFF\xFF\x00\x00\x00\x00\x00\x00\x2C\x01\x04\x10\xFF\xFF"},
+    {19, 88, 1, "\x06"},
+    {29, 368, 1, "\x05"},
+    {34, 8, 1, "\x07"},
+    {35, 0, 12, "HANGMAN    \x08"},
+    {35, 32, 44, "AW\x00O\x00R\x00\x44\x00S\x00\x0F\x00\x3E.\x00T\x00X\x00T\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xE5ORDS   TXT "},
+    {35, 90, 18, "\x05\x00\xE7\x03\x00\x00WORDS      \x10"},
+    {35, 128, 12, "EMPTY   TXT "},
+    {35, 160, 12, "OTHER00 TXT "},
+    {35, 192, 12, "OTHER01 TXT "},
+    {35, 224, 12, "OTHER02 TXT "},
+    {35, 256, 12, "OTHER03 TXT "},
+    {35, 288, 12, "OTHER04 TXT "},
+    {35, 320, 12, "OTHER05 TXT "},
+    {35, 352, 12, "OTHER06 TXT "},
+    {35, 384, 12, "OTHER07 TXT "},
+    {35, 416, 12, "OTHER08 TXT "},
+    {35, 448, 12, "OTHER09 TXT "},
+    {35, 480, 12, "OTHER10 TXT "},
+    {36, 0, 12, "OTHER11 TXT "},
+    {36, 32, 12, "WORDS   TXT "},
+    {36, 58, 4, "\xB8\x0B\xAD\x17"},
+    {6063, 0, 512, cardText + 0},
+    {6064, 0, 512, cardText + 512},
+    {73, 0, 512, cardText + 1024},
+    {74, 0, 512, cardText + 1536},
+    {663, 0, 512, cardText + 2048},
+    {664, 0, 512, cardText + 2560},
+    {75, 0, 512, cardText + 3072},
+    {76, 0, 512, cardText + 3584},
+    {8263, 0, 512, cardText + 4096},
+    {8264, 0, 512, cardText + 4608},
+    {77, 0, 512, cardText + 5120},
+    {78, 0, 429, cardText + 5632},
+};
+
+// FAT16 in a partition from block 63, 4200 clusters of 2 blocks, the pack in clusters 6, 4100, 5, 3000, 2000, 7
+static const CardRun card16PartitionedRuns[] = {
+    {0, 0, 1, "\xFA"},
+    {0, 450, 10, "\x06\x00\x00\x00\x3F\x00\x00\x00\x16\x21"},
+    {0, 510, 2, "U\xAA"},
+    {63, 0, 23, "\xEB\x3C\x90MSWIN4.1\x00\x02\x02\x04\x00\x02\x00\x02\x16\x21\xF8\x11"},
+    {63, 510, 2, "U\xAA"},
+    {67, 0, 16, "\xF8\xFF\xFF\xFF\x00\x00\x00\x00\x00\x00\xB8\x0B\x04\x10\xFF\xFF"},
+    {74, 416, 1, "\x07"},
+    {78, 368, 2, "\xD0\x07"},
+    {83, 8, 1, "\x05"},
+    {84, 0, 16, "\xF8\xFF\xFF\xFF\x00\x00\x00\x00\x00\x00\xB8\x0B\x04\x10\xFF\xFF"},
+    {91, 416, 1, "\x07"},
+    {95, 368, 2, "\xD0\x07"},
+    {100, 8, 1, "\x05"},
+    {101, 0, 12, "HANGMAN    \x08"},
+    {101, 32, 44, "AW\x00O\x00R\x00\x44\x00S\x00\x0F\x00\x3E.\x00T\x00X\x00T\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xE5ORDS   TXT "},
+    {101, 90, 18, "\x05\x00\xE7\x03\x00\x00WORDS      \x10"},
+    {101, 128, 12, "EMPTY   TXT "},
+    {101, 160, 12, "OTHER00 TXT "},
+    {101, 192, 12, "OTHER01 TXT "},
+    {101, 224, 12, "OTHER02 TXT "},
+    {101, 256, 12, "OTHER03 TXT "},
+    {101, 288, 12, "OTHER04 TXT "},
+    {101, 320, 12, "OTHER05 TXT "},
+    {101, 352, 12, "OTHER06 TXT "},
+    {101, 384, 12, "OTHER07 TXT "},
+    {101, 416, 12, "OTHER08 TXT "},
+    {101, 448, 12, "OTHER09 TXT "},
+    {101, 480, 12, "OTHER10 TXT "},
+    {102, 0, 12, "OTHER11 TXT "},
+    {102, 32, 12, "WORDS   TXT "},
+    {102, 58, 4, "\x06\x00\xAD\x17"},
+    {141, 0, 512, cardText + 0},
+    {142, 0, 512, cardText + 512},
+    {8329, 0, 512, cardText + 1024},
+    {8330, 0, 512, cardText + 1536},
+    {139, 0, 512, cardText + 2048},
+    {140, 0, 512, cardText + 2560},
+    {6129, 0, 512, cardText + 3072},
+    {6130, 0, 512, cardText + 3584},
+    {4129, 0, 512, cardText + 4096},
+    {4130, 0, 512, cardText + 4608},
+    {143, 0, 512, cardText + 5120},
+    {144, 0, 429, cardText + 5632},
+};
+
+// FAT32 on the whole card, 66000 clusters of 1 blocks, the pack in clusters 3000, 5, 40000, 6, 7, 200, 65000, 129, 10, 11, 20000, 300
+static const CardRun card32Runs[] = {
+    {0, 0, 22, "\xEB\x3C\x90MSWIN4.1\x00\x02\x01 \x00\x02\x00\x00\x00\x00\xF8"},
+    {0, 32, 13, "\xF8\x05\x01\x00\x04\x02\x00\x00\x00\x00\x00\x00\x02"},
+    {0, 510, 2, "U\xAA"},
+    {32, 0, 10, "\xF8\xFF\xFF\x0F\xFF\xFF\xFF\x0F\xA0\x0F"},
+    {32, 20, 9, "\x40\x9C\x00\x00\x07\x00\x00\x00\xC8"},
+    {32, 40, 6, "\x0B\x00\x00\x00 N"},
+    {33, 4, 1, "\x0A"},
+    {33, 288, 2, "\xE8\xFD"},
+    {34, 176, 4, "\xFF\xFF\xFF\x0F"},
+    {55, 224, 1, "\x05"},
+    {63, 128, 4, "\xFF\xFF\xFF\x0F"},
+    {188, 128, 2, "\x2C\x01"},
+    {344, 256, 1, "\x06"},
+    {539, 416, 1, "\x81"},
+    {548, 0, 10, "\xF8\xFF\xFF\x0F\xFF\xFF\xFF\x0F\xA0\x0F"},
+    {548, 20, 9, "\x40\x9C\x00\x00\x07\x00\x00\x00\xC8"},
+    {548, 40, 6, "\x0B\x00\x00\x00 N"},
+    {549, 4, 1, "\x0A"},
+    {549, 288, 2, "\xE8\xFD"},
+    {550, 176, 4, "\xFF\xFF\xFF\x0F"},
+    {571, 224, 1, "\x05"},
+    {579, 128, 4, "\xFF\xFF\xFF\x0F"},
+    {704, 128, 2, "\x2C\x01"},
+    {860, 256, 1, "\x06"},
+    {1055, 416, 1, "\x81"},
+    {1064, 0, 12, "HANGMAN    \x08"},
+    {1064, 32, 44, "AW\x00O\x00R\x00\x44\x00S\x00\x0F\x00\x3E.\x00T\x00X\x00T\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xE5ORDS   TXT "},
+    {1064, 90, 18, "\x05\x00\xE7\x03\x00\x00WORDS      \x10"},
+    {1064, 128, 12, "EMPTY   TXT "},
+    {1064, 160, 12, "OTHER00 TXT "},
+    {1064, 192, 12, "OTHER01 TXT "},
+    {1064, 224, 12, "OTHER02 TXT "},
+    {1064, 256, 12, "OTHER03 TXT "},
+    {1064, 288, 12, "OTHER04 TXT "},
+    {1064, 320, 12, "OTHER05 TXT "},
+    {1064, 352, 12, "OTHER06 TXT "},
+    {1064, 384, 12, "OTHER07 TXT "},
+    {1064, 416, 12, "OTHER08 TXT "},
+    {1064, 448, 12, "OTHER09 TXT "},
+    {1064, 480, 12, "OTHER10 TXT "},
+    {5062, 0, 12, "OTHER11 TXT "},
+    {5062, 32, 12, "WORDS   TXT "},
+    {5062, 58, 4, "\xB8\x0B\xAD\x17"},
+    {4062, 0, 512, cardText + 0},
+    {1067, 0, 512, cardText + 512},
+    {41062, 0, 512, cardText + 1024},
+    {1068, 0, 512, cardText + 1536},
+    {1069, 0, 512, cardText + 2048},
+    {1262, 0, 512, cardText + 2560},
+    {66062, 0, 512, cardText + 3072},
+    {1191, 0, 512, cardText + 3584},
+    {1072, 0, 512, cardText + 4096},
+    {1073, 0, 512, cardText + 4608},
+    {21062, 0, 512, cardText + 5120},
+    {1362, 0, 429, cardText + 5632},
+};
+
+// FAT32 in a partition from block 2048, 66000 clusters of 1 blocks, the pack in clusters 300, 20000, 11, 10, 129, 65000, 200, 7, 6, 40000, 5, 3000
+static const CardRun card32PartitionedRuns[] = {
+    {0, 0, 1, "\xFA"},
+    {0, 450, 11, "\x0C\x00\x00\x00\x00\x08\x00\x00\xF8\x05\x01"},
+    {0, 510, 2, "U\xAA"},
+    {2048, 0, 22, "\xEB\x3C\x90MSWIN4.1\x00\x02\x01 \x00\x02\x00\x00\x00\x00\xF8"},
+    {2048, 32, 13, "\xF8\x05\x01\x00\x04\x02\x00\x00\x00\x00\x00\x00\x02"},
+    {2048, 510, 2, "U\xAA"},
+    {2080, 0, 10, "\xF8\xFF\xFF\x0F\xFF\xFF\xFF\x0F\xA0\x0F"},
+    {2080, 20, 9, "\xB8\x0B\x00\x00\x40\x9C\x00\x00\x06"},
+    {2080, 40, 5, "\x81\x00\x00\x00\x0A"},
+    {2081, 4, 2, "\xE8\xFD"},
+    {2081, 288, 1, "\x07"},
+    {2082, 176, 2, " N"},
+    {2103, 224, 4, "\xFF\xFF\xFF\x0F"},
+    {2111, 128, 4, "\xFF\xFF\xFF\x0F"},
+    {2236, 128, 1, "\x0B"},
+    {2392, 256, 1, "\x05"},
+    {2587, 416, 1, "\xC8"},
+    {2596, 0, 10, "\xF8\xFF\xFF\x0F\xFF\xFF\xFF\x0F\xA0\x0F"},
+    {2596, 20, 9, "\xB8\x0B\x00\x00\x40\x9C\x00\x00\x06"},
+    {2596, 40, 5, "\x81\x00\x00\x00\x0A"},
+    {2597, 4, 2, "\xE8\xFD"},
+    {2597, 288, 1, "\x07"},
+    {2598, 176, 2, " N"},
+    {2619, 224, 4, "\xFF\xFF\xFF\x0F"},
+    {2627, 128, 4, "\xFF\xFF\xFF\x0F"},
+    {2752, 128, 1, "\x0B"},
+    {2908, 256, 1, "\x05"},
+    {3103, 416, 1, "\xC8"},
+    {3112, 0, 12, "HANGMAN    \x08"},
+    {3112, 32, 44, "AW\x00O\x00R\x00\x44\x00S\x00\x0F\x00\x3E.\x00T\x00X\x00T\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xE5ORDS   TXT "},
+    {3112, 90, 18, "\x05\x00\xE7\x03\x00\x00WORDS      \x10"},
+    {3112, 128, 12, "EMPTY   TXT "},
+    {3112, 160, 12, "OTHER00 TXT "},
+    {3112, 192, 12, "OTHER01 TXT "},
+    {3112, 224, 12, "OTHER02 TXT "},
+    {3112, 256, 12, "OTHER03 TXT "},
+    {3112, 288, 12, "OTHER04 TXT "},
+    {3112, 320, 12, "OTHER05 TXT "},
+    {3112, 352, 12, "OTHER06 TXT "},
+    {3112, 384, 12, "OTHER07 TXT "},
+    {3112, 416, 12, "OTHER08 TXT "},
+    {3112, 448, 12, "OTHER09 TXT "},
+    {3112, 480, 12, "OTHER10 TXT "},
+    {7110, 0, 12, "OTHER11 TXT "},
+    {7110, 32, 12, "WORDS   TXT "},
+    {7110, 58, 4, "\x2C\x01\xAD\x17"},
+    {3410, 0, 512, cardText + 0},
+    {23110, 0, 512, cardText + 512},
+    {3121, 0, 512, cardText + 1024},
+    {3120, 0, 512, cardText + 1536},
+    {3239, 0, 512, cardText + 2048},
+    {68110, 0, 512, cardText + 2560},
+    {3310, 0, 512, cardText + 3072},
+    {3117, 0, 512, cardText + 3584},
+    {3116, 0, 512, cardText + 4096},
+    {43110, 0, 512, cardText + 4608},
+    {3115, 0, 512, cardText + 5120},
+    {6110, 0, 429, cardText + 5632},
+};
+
+static const Card cards[] = {
+    {"card16", card16Runs, sizeof(card16Runs) / sizeof(CardRun), 16, 0, 2},
+    {"card16Partitioned", card16PartitionedRuns, sizeof(card16PartitionedRuns) / sizeof(CardRun), 16, 63, 2},
+    {"card32", card32Runs, sizeof(card32Runs) / sizeof(CardRun), 32, 0, 1},
+    {"card32Partitioned", card32PartitionedRuns, sizeof(card32PartitionedRuns) / sizeof(CardRun), 32, 2048, 1},
+};
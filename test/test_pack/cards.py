@@ -0,0 +1,230 @@
+# Card images for test/test_pack: writes test/test_pack/cards.h, run by hand
+# with "python test/test_pack/cards.py" after changing it
+#
+# A card is a FAT16 or FAT32 volume, formatted as a whole or in the first
+# partition of an MBR, with a word pack WORDS.TXT in its root directory. Even
+# a small FAT32 volume is 32 MB, so only the bytes that are not 0 are kept:
+# runs of them, each at a block and an offset into it. The text of the pack is
+# kept once and the runs of its clusters point into it.
+#
+# The root directory starts with entries FatOpen() has to skip (a volume label,
+# a long name, a deleted WORDS.TXT, a directory named WORDS and a few other
+# files), so WORDS.TXT is in its second block. The pack's clusters are out of
+# order and far apart, so reading it walks the FAT back and forth over several
+# of its blocks. It has more words than there are marks, with some runs that
+# are not words in between, in upper and lower case and with every separator.
+
+import os
+import random
+import struct
+
+MAX_LENGTH = 16  # DICT_MAX_LENGTH
+WORDS = 600
+BLOCK = 512
+
+# Name, FAT type, blocks per cluster, clusters, reserved blocks, root entries (FAT16), partition start (0 for none),
+# and the clusters the pack is in, in the order of the file
+CARDS = [
+    ("card16", 16, 2, 4200, 1, 512, 0, [3000, 5, 300, 6, 4100, 7]),
+    ("card16Partitioned", 16, 2, 4200, 4, 512, 63, [6, 4100, 5, 3000, 2000, 7]),
+    ("card32", 32, 1, 66000, 32, 0, 0, [3000, 5, 40000, 6, 7, 200, 65000, 129, 10, 11, 20000, 300]),
+    ("card32Partitioned", 32, 1, 66000, 32, 0, 2048, [300, 20000, 11, 10, 129, 65000, 200, 7, 6, 40000, 5, 3000]),
+]
+ROOT32 = [2, 4000]  # The FAT32 root directory's clusters, one block each
+
+
+def make_words():
+    # The words, and the pack's text with them and the runs that are not words
+    rng = random.Random(198)
+    words = []
+    text = []
+    separators = [" ", "\n", "\r\n", "\t", "  "]
+    junk = ["x2", "DON'T", "A" * (MAX_LENGTH + 1), "42", "-", "e-mail"]
+    for i in range(WORDS):
+        word = "".join(rng.choice("ABCDEFGHIJKLMNOPQRSTUVWXYZ") for _ in range(1 + i * 7 % MAX_LENGTH))
+        words.append(word)
+        text.append(word.lower() if i % 5 == 3 else word)
+        text.append(separators[i % len(separators)])
+        if i % 37 == 36:
+            text.append(junk[i // 37 % len(junk)] + " ")
+    text.append("ZZZZZZZZZZZZZZZZZZZZZ")  # Too long, and no separator before the end of the file
+    return words, "".join(text).encode("ascii")
+
+
+def entry(name, attributes, first, size):
+    data = bytearray(32)
+    data[0:11] = name
+    data[11] = attributes
+    struct.pack_into("<H", data, 20, first >> 16)
+    struct.pack_into("<HI", data, 26, first & 0xFFFF, size)
+    return bytes(data)
+
+
+def make_card(card, text):
+    name, kind, cluster_blocks, clusters, reserved, root_entries, start, chain = card
+    blocks = {}  # Block number: bytearray, only for the blocks that are written
+
+    def write(block, offset, data):
+        block += offset // BLOCK
+        offset %= BLOCK
+        while data:
+            part = data[:BLOCK - offset]
+            blocks.setdefault(block, bytearray(BLOCK))[offset:offset + len(part)] = part
+            data = data[len(part):]
+            block += 1
+            offset = 0
+
+    entry_bytes = kind // 8
+    fat_blocks = ((clusters + 2) * entry_bytes + BLOCK - 1) // BLOCK
+    root_blocks = root_entries * 32 // BLOCK
+    data_start = reserved + 2 * fat_blocks + root_blocks
+    total = data_start + clusters * cluster_blocks
+
+    if start:
+        mbr = bytearray(BLOCK)
+        mbr[0] = 0xFA  # Code, not the jump a boot sector starts with
+        mbr[446 + 4] = 0x06 if kind == 16 else 0x0C
+        struct.pack_into("<II", mbr, 446 + 8, start, total)
+        struct.pack_into("<H", mbr, 510, 0xAA55)
+        write(0, 0, bytes(mbr))
+
+    boot = bytearray(BLOCK)
+    boot[0:3] = b"\xEB\x3C\x90"
+    boot[3:11] = b"MSWIN4.1"
+    struct.pack_into("<HBHBH", boot, 11, BLOCK, cluster_blocks, reserved, 2, root_entries)
+    if total < 0x10000:
+        struct.pack_into("<H", boot, 19, total)
+    else:
+        struct.pack_into("<I", boot, 32, total)
+    boot[21] = 0xF8
+    if kind == 16:
+        struct.pack_into("<H", boot, 22, fat_blocks)
+    else:
+        struct.pack_into("<II", boot, 36, fat_blocks, 0)
+        struct.pack_into("<I", boot, 44, ROOT32[0])
+    struct.pack_into("<H", boot, 510, 0xAA55)
+    write(start, 0, bytes(boot))
+
+    # The FAT: its first two entries, the root directory's chain on FAT32, and the pack's chain
+    end = 0xFFFF if kind == 16 else 0x0FFFFFFF
+    fat = {0: 0xFFF8 if kind == 16 else 0x0FFFFFF8, 1: end}
+    chains = [chain] + ([ROOT32] if kind == 32 else [])
+    for links in chains:
+        for cluster, following in zip(links, links[1:] + [end]):
+            fat[cluster] = following
+    for copy in range(2):
+        for cluster, value in fat.items():
+            write(start + reserved + copy * fat_blocks, cluster * entry_bytes,
+                  struct.pack("<H" if kind == 16 else "<I", value))
+
+    directory = [
+        entry(b"HANGMAN    ", 0x08, 0, 0),
+        b"\x41W\x00O\x00R\x00D\x00S\x00\x0F\x00\x3E.\x00T\x00X\x00T\x00\x00\x00\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF",
+        entry(b"\xE5ORDS   TXT", 0x20, 5, 999),
+        entry(b"WORDS      ", 0x10, 0, 0),
+        entry(b"EMPTY   TXT", 0x20, 0, 0),
+    ]
+    directory += [entry(b"OTHER%02d TXT" % i, 0x20, 0, 0) for i in range(12)]
+    directory.append(entry(b"WORDS   TXT", 0x20, chain[0], len(text)))
+
+    def cluster_block(cluster):
+        return start + data_start + (cluster - 2) * cluster_blocks
+
+    assert all(len(e) == 32 for e in directory)
+    listing = b"".join(directory)
+    if kind == 16:
+        write(start + reserved + 2 * fat_blocks, 0, listing)
+    else:
+        for i, cluster in enumerate(ROOT32):
+            write(cluster_block(cluster), 0, listing[i * BLOCK:(i + 1) * BLOCK])
+
+    # The pack's blocks are left out of blocks, they are runs of the text
+    assert len(chain) * cluster_blocks * BLOCK >= len(text) > (len(chain) - 1) * cluster_blocks * BLOCK, name
+    text_runs = []
+    for i, cluster in enumerate(chain):
+        for b in range(cluster_blocks):
+            at = (i * cluster_blocks + b) * BLOCK
+            if at < len(text):
+                text_runs.append((cluster_block(cluster) + b, at, min(BLOCK, len(text) - at)))
+    return blocks, text_runs
+
+
+def runs(block):
+    # The stretches of a block that are not 0, with gaps of a few 0 bytes kept in them
+    found = []
+    i = 0
+    while i < BLOCK:
+        if block[i] == 0:
+            i += 1
+            continue
+        first = last = i
+        while i < BLOCK and i - last <= 8:
+            if block[i] != 0:
+                last = i
+            i += 1
+        found.append((first, block[first:last + 1]))
+    return found
+
+
+def c_string(data):
+    out = []
+    hexed = False
+    for byte in data:
+        char = chr(byte)
+        if byte < 128 and char.isalnum() and not (hexed and char in "0123456789abcdefABCDEF"):
+            out.append(char)
+            hexed = False
+        elif char in " .-'":
+            out.append(char)
+            hexed = False
+        else:
+            out.append("\\x%02X" % byte)
+            hexed = True
+    return '"' + "".join(out) + '"'
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    words, text = make_words()
+    lines = [
+        "// Card images for test/test_pack, written by test/test_pack/cards.py: do not edit",
+        "",
+        "#define CARD_WORDS %d // Words in the pack" % len(words),
+        "",
+        "// The words of the pack, in upper case",
+        "static const char *const cardWords[CARD_WORDS] = {",
+    ]
+    for i in range(0, len(words), 8):
+        lines.append("    " + ", ".join('"%s"' % word for word in words[i:i + 8]) + ",")
+    lines += ["};", "", "// WORDS.TXT, the pack's text", "static const char cardText[%d] =" % len(text)]
+    for i in range(0, len(text), 64):
+        lines.append("    " + c_string(text[i:i + 64]) + (";" if i + 64 >= len(text) else ""))
+
+    for card in CARDS:
+        blocks, text_runs = make_card(card, text)
+        lines += ["", "// %s" % describe(card), "static const CardRun %sRuns[] = {" % card[0]]
+        for block in sorted(blocks):
+            for offset, data in runs(blocks[block]):
+                lines.append("    {%d, %d, %d, %s}," % (block, offset, len(data), c_string(data)))
+        for block, at, length in text_runs:
+            lines.append("    {%d, 0, %d, cardText + %d}," % (block, length, at))
+        lines.append("};")
+
+    lines += ["", "static const Card cards[] = {"]
+    for card in CARDS:
+        lines.append('    {"%s", %sRuns, sizeof(%sRuns) / sizeof(CardRun), %d, %d, %d},'
+                     % (card[0], card[0], card[0], card[1], card[6], card[2]))
+    lines.append("};")
+
+    with open(os.path.join(here, "cards.h"), "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def describe(card):
+    name, kind, cluster_blocks, clusters, reserved, root_entries, start, chain = card
+    layout = "in a partition from block %d" % start if start else "on the whole card"
+    return "FAT%d %s, %d clusters of %d blocks, the pack in clusters %s" % (
+        kind, layout, clusters, cluster_blocks, ", ".join(str(c) for c in chain))
+
+
+main()
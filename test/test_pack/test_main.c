@@ -0,0 +1,338 @@
+// Tests of the FAT reader, its block cache and the word pack, on card images kept in cards.h
+
+// The images are FAT16 and FAT32 volumes, on the whole card and in a
+// partition, with the same WORDS.TXT in clusters out of order (see cards.py).
+// Only their bytes that are not 0 are kept, so the cache reads its blocks
+// through a function that puts a block together from them. It counts the
+// blocks read, and the ones of the FAT, and can make the card fail.
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "pack.h"
+
+// length bytes of a card that are not 0, at offset in block
+typedef struct {
+    uint32_t block;
+    uint16_t offset;
+    uint16_t length;
+    const char *bytes;
+} CardRun;
+
+typedef struct {
+    const char *name;
+    const CardRun *runs;
+    uint32_t runCount;
+    uint8_t type;          // 16 or 32
+    uint32_t start;        // The partition's first block, 0 for a card formatted as a whole
+    uint8_t clusterBlocks;
+} Card;
+
+#include "cards.h"
+
+#define CARD_COUNT (sizeof(cards) / sizeof(cards[0]))
+
+static const Card *card; // The card in the slot, NULL for none
+static bool failing;     // The card stopped answering
+static uint32_t reads;   // Blocks read, and of them the ones of the FAT
+static uint32_t fatReads;
+static Cache cache;
+static Fat fat;
+static FatFile file;
+static WordPack pack;
+
+// Purpose: Puts together a block of the card in the slot
+static bool cardRead(uint32_t block, uint8_t *data){
+    if (card == NULL || failing){
+        return false;
+    }
+    reads++;
+    fatReads += block >= fat.fatStart && block < fat.dataStart;
+    memset(data, 0, CACHE_BLOCK);
+    for (uint32_t i = 0 ; i < card->runCount ; i++){
+        if (card->runs[i].block == block){
+            memcpy(data + card->runs[i].offset, card->runs[i].bytes, card->runs[i].length);
+        }
+    }
+    return true;
+}
+
+// Purpose: Puts a card in the slot and mounts it, with the cache empty
+static void insert(const Card *inserted){
+    card = inserted;
+    failing = false;
+    memset(&fat, 0, sizeof(fat));
+    CacheInit(&cache, cardRead);
+    reads = fatReads = 0;
+    TEST_ASSERT_TRUE_MESSAGE(FatMount(&fat, &cache), card->name);
+}
+
+// Purpose: Checks that the file reads as the pack's text from position on, for length bytes
+static void assertText(FatFile *from, uint32_t position, int length){
+    uint8_t data[64];
+
+    TEST_ASSERT_TRUE(length <= (int)sizeof(data));
+    TEST_ASSERT_EQUAL(length, FatRead(from, data, length));
+    TEST_ASSERT_EQUAL_MEMORY(cardText + position, data, length);
+}
+
+void setUp(void){
+    card = NULL;
+}
+
+void tearDown(void){
+}
+
+void test_every_card_mounts(void){
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        TEST_ASSERT_EQUAL(cards[c].type, fat.type);
+        TEST_ASSERT_EQUAL(cards[c].clusterBlocks, fat.clusterBlocks);
+        TEST_ASSERT_TRUE(fat.fatStart > cards[c].start);
+        TEST_ASSERT_TRUE(fat.dataStart > fat.fatStart);
+        TEST_ASSERT_EQUAL_UINT32(cards[c].type == 16 ? 4200 : 66000, fat.clusters);
+    }
+}
+
+void test_cards_without_a_volume_are_not_mounted(void){
+    static const CardRun mbrOnly[] = {{0, 510, 2, "\x55\xAA"}}; // A partition table whose partition starts at block 0
+    static Card unformatted[] = {
+        {"blank", mbrOnly, 0, 16, 0, 1},
+        {"mbr only", mbrOnly, 1, 16, 0, 1},
+        {"no boot sector", card16PartitionedRuns, 0, 16, 63, 2},
+    };
+
+    // Only the MBR of card16Partitioned, its partition is not formatted
+    while (card16PartitionedRuns[unformatted[2].runCount].block == 0){
+        unformatted[2].runCount++;
+    }
+    for (uint32_t c = 0 ; c < sizeof(unformatted) / sizeof(unformatted[0]) ; c++){
+        card = &unformatted[c];
+        CacheInit(&cache, cardRead);
+        TEST_ASSERT_FALSE_MESSAGE(FatMount(&fat, &cache), unformatted[c].name);
+    }
+    card = NULL;
+    CacheInit(&cache, cardRead);
+    TEST_ASSERT_FALSE(FatMount(&fat, &cache)); // No card
+}
+
+void test_files_are_found_by_their_short_name(void){
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        TEST_ASSERT_TRUE(FatOpen(&fat, &file, "WORDS.TXT"));
+        TEST_ASSERT_EQUAL_UINT32(sizeof(cardText), FatSize(&file));
+        TEST_ASSERT_TRUE(FatOpen(&fat, &file, "words.txt"));
+        TEST_ASSERT_TRUE(FatOpen(&fat, &file, "EMPTY.TXT"));
+        TEST_ASSERT_EQUAL_UINT32(0, FatSize(&file));
+        TEST_ASSERT_FALSE(FatOpen(&fat, &file, "NONE.TXT"));
+        TEST_ASSERT_FALSE(FatOpen(&fat, &file, "WORDS"));   // A directory
+        TEST_ASSERT_FALSE(FatOpen(&fat, &file, "HANGMAN")); // The volume label
+    }
+}
+
+void test_fragmented_file_reads_whole(void){
+    static const int sizes[] = {1, 7, 64, 512, 1000, 7000};
+    static uint8_t data[sizeof(cardText) + 1];
+
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        for (unsigned s = 0 ; s < sizeof(sizes) / sizeof(sizes[0]) ; s++){
+            uint32_t done = 0;
+            int count;
+
+            TEST_ASSERT_TRUE(FatOpen(&fat, &file, "WORDS.TXT"));
+            memset(data, 0, sizeof(data));
+            while ((count = FatRead(&file, data + done, sizes[s] < (int)(sizeof(data) - done) ? sizes[s] : (int)(sizeof(data) - done))) > 0){
+                done += count;
+            }
+            TEST_ASSERT_EQUAL(0, count);
+            TEST_ASSERT_EQUAL_UINT32(sizeof(cardText), done);
+            TEST_ASSERT_EQUAL_MEMORY(cardText, data, sizeof(cardText));
+        }
+    }
+}
+
+void test_seek_back_and_forth(void){
+    uint32_t state = 1;
+
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        TEST_ASSERT_TRUE(FatOpen(&fat, &file, "WORDS.TXT"));
+        for (int i = 0 ; i < 500 ; i++){
+            uint32_t position;
+
+            state = state * 1103515245UL + 12345;
+            position = (state >> 8) % (sizeof(cardText) - 16);
+            TEST_ASSERT_TRUE(FatSeek(&file, position));
+            TEST_ASSERT_EQUAL_UINT32(position, FatTell(&file));
+            assertText(&file, position, 16);
+        }
+
+        // Past the end is the end
+        TEST_ASSERT_TRUE(FatSeek(&file, sizeof(cardText) + 100));
+        TEST_ASSERT_EQUAL_UINT32(sizeof(cardText), FatTell(&file));
+        TEST_ASSERT_EQUAL(0, FatRead(&file, (uint8_t *)&state, 1));
+    }
+}
+
+void test_seek_from_a_kept_cluster_skips_the_fat(void){
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        uint32_t clusterBytes = cards[c].clusterBlocks * CACHE_BLOCK;
+
+        insert(&cards[c]);
+        TEST_ASSERT_TRUE(FatOpen(&fat, &file, "WORDS.TXT"));
+
+        // Into every cluster of the file, from the start of the one it is in and from one before it
+        for (uint32_t position = 5 ; position + 16 < sizeof(cardText) ; position += clusterBytes){
+            uint32_t cluster, clusterStart, before = 0, beforeStart = 0;
+
+            TEST_ASSERT_TRUE(FatSeek(&file, position));
+            cluster = FatCluster(&file);
+            clusterStart = FatClusterStart(&file);
+            TEST_ASSERT_EQUAL_UINT32(position - position % clusterBytes, clusterStart);
+            if (clusterStart > 0){
+                TEST_ASSERT_TRUE(FatSeek(&file, clusterStart - 1));
+                before = FatCluster(&file);
+                beforeStart = FatClusterStart(&file);
+            }
+
+            // Back to the start, and the FAT forgotten, so a walk from the first cluster would read it again
+            TEST_ASSERT_TRUE(FatSeek(&file, 0));
+            CacheFlush(&cache);
+            fatReads = 0;
+            TEST_ASSERT_TRUE(FatSeekFrom(&file, position, cluster, clusterStart));
+            TEST_ASSERT_EQUAL_UINT32(0, fatReads);
+            TEST_ASSERT_EQUAL_UINT32(cluster, FatCluster(&file));
+            assertText(&file, position, 16);
+
+            if (clusterStart > 0){
+                TEST_ASSERT_TRUE(FatSeekFrom(&file, position, before, beforeStart));
+                TEST_ASSERT_EQUAL_UINT32(cluster, FatCluster(&file));
+                assertText(&file, position, 16);
+            }
+
+            // A cluster kept for a later position is no help, it goes back to the first one
+            TEST_ASSERT_TRUE(FatSeekFrom(&file, 3, cluster, clusterStart + clusterBytes));
+            assertText(&file, 3, 16);
+        }
+    }
+}
+
+// Purpose: Checks that word index of the pack is the one cards.py wrote
+static void assertWord(uint32_t index){
+    const char *expected = cardWords[index];
+    WordView word;
+
+    TEST_ASSERT_TRUE(PackWord(&pack, index, &word));
+    TEST_ASSERT_EQUAL(strlen(expected), word.length);
+    for (uint8_t i = 0 ; i < word.length ; i++){
+        TEST_ASSERT_EQUAL(expected[i], WordLetter(word, i));
+    }
+}
+
+void test_card_failure_is_reported(void){
+    uint8_t data[600];
+
+    insert(&cards[2]);
+    TEST_ASSERT_TRUE(FatOpen(&fat, &file, "WORDS.TXT"));
+    TEST_ASSERT_TRUE(PackOpen(&pack, &fat, "WORDS.TXT"));
+    CacheFlush(&cache);
+    failing = true;
+    TEST_ASSERT_EQUAL(-1, FatRead(&file, data, sizeof(data)));
+    TEST_ASSERT_FALSE(FatOpen(&fat, &file, "WORDS.TXT"));
+
+    WordView word;
+
+    TEST_ASSERT_FALSE(PackWord(&pack, CARD_WORDS / 2, &word));
+
+    // The cache kept none of the blocks that failed, so the card reads again when it is back
+    failing = false;
+    TEST_ASSERT_TRUE(PackOpen(&pack, &fat, "WORDS.TXT"));
+    assertWord(CARD_WORDS / 2);
+}
+
+void test_empty_and_missing_packs_are_not_opened(void){
+    insert(&cards[0]);
+    TEST_ASSERT_FALSE(PackOpen(&pack, &fat, "EMPTY.TXT"));
+    TEST_ASSERT_FALSE(PackOpen(&pack, &fat, "NONE.TXT"));
+}
+
+void test_stride_doubles_until_the_marks_fit(void){
+    uint32_t stride = 1;
+
+    // The stride is the smallest power of 2 that fits every word in PACK_MARKS marks
+    while (CARD_WORDS > PACK_MARKS * stride){
+        stride *= 2;
+    }
+    TEST_ASSERT_TRUE(stride >= 4); // The marks filled up at least twice
+
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        TEST_ASSERT_TRUE(PackOpen(&pack, &fat, "WORDS.TXT"));
+        TEST_ASSERT_EQUAL_UINT32(CARD_WORDS, PackCount(&pack));
+        TEST_ASSERT_EQUAL_UINT32(stride, pack.stride);
+        TEST_ASSERT_EQUAL((CARD_WORDS + stride - 1) / stride, pack.markCount);
+
+        // Mark k is where word k * stride starts, in upper or lower case, and its cluster gets there
+        for (int k = 0 ; k < pack.markCount ; k++){
+            const PackMark *mark = &pack.marks[k];
+            const char *expected = cardWords[k * stride];
+            char letters[DICT_MAX_LENGTH];
+            int length = strlen(expected);
+
+            TEST_ASSERT_TRUE(mark->clusterStart <= mark->position);
+            TEST_ASSERT_TRUE(FatSeekFrom(&file, mark->position, mark->cluster, mark->clusterStart));
+            TEST_ASSERT_EQUAL(length, FatRead(&file, (uint8_t *)letters, length));
+            for (int i = 0 ; i < length ; i++){
+                TEST_ASSERT_EQUAL(expected[i], letters[i] & ~0x20);
+            }
+        }
+    }
+}
+
+void test_words_read_in_any_order(void){
+    char report[120];
+    uint32_t state = 7, randomReads = 0;
+
+    for (uint32_t c = 0 ; c < CARD_COUNT ; c++){
+        insert(&cards[c]);
+        TEST_ASSERT_TRUE(PackOpen(&pack, &fat, "WORDS.TXT"));
+        for (uint32_t i = 0 ; i < CARD_WORDS ; i++){
+            assertWord(i);
+        }
+        for (uint32_t i = CARD_WORDS ; i > 0 ; i--){
+            assertWord(i - 1);
+        }
+
+        // The way a game picks them, with the cache as cold as it can be between words
+        reads = 0;
+        for (int i = 0 ; i < 1000 ; i++){
+            state = state * 1103515245UL + 12345;
+            CacheFlush(&cache);
+            assertWord((state >> 8) % CARD_WORDS);
+        }
+        randomReads += reads;
+
+        WordView word;
+
+        TEST_ASSERT_FALSE(PackWord(&pack, CARD_WORDS, &word));
+    }
+    snprintf(report, sizeof(report), "%lu words, stride %lu: %.2f blocks read per word from a cold cache",
+             (unsigned long)CARD_WORDS, (unsigned long)pack.stride, (double)randomReads / CARD_COUNT / 1000);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_every_card_mounts);
+    RUN_TEST(test_cards_without_a_volume_are_not_mounted);
+    RUN_TEST(test_files_are_found_by_their_short_name);
+    RUN_TEST(test_fragmented_file_reads_whole);
+    RUN_TEST(test_seek_back_and_forth);
+    RUN_TEST(test_seek_from_a_kept_cluster_skips_the_fat);
+    RUN_TEST(test_card_failure_is_reported);
+    RUN_TEST(test_empty_and_missing_packs_are_not_opened);
+    RUN_TEST(test_stride_doubles_until_the_marks_fit);
+    RUN_TEST(test_words_read_in_any_order);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+// Tests of the letter prefix code, and the presses and time a guess takes with it, from replayed sessions
+
+// A session is a word played to the end by a player who always guesses the
+// most common English letter they have not tried yet, the way most people
+// play hangman. Every guess is entered both ways the station offers, with the
+// letter's prefix code and in 8 digit ascii. The digits are pressed through
+// the press decoder with the press lengths of a steady player, so the time
+// per guess is what the station would measure (inputTime in src/hangman.c):
+// from the first press of the guess to the release that decides its last digit.
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "prefix.h"
+#include "press.h"
+
+#define MS 1000UL // Microseconds in a millisecond
+#define ZERO_HELD (250 * MS) // How long the replayed player holds a 0
+#define ONE_HELD (900 * MS)  // and a 1
+#define BETWEEN (400 * MS)   // and waits between two presses
+#define LIVES 7
+
+// The words the sessions are played on, common words of 3 to 10 letters
+static const char *const words[] = {
+    "CAT", "HOUSE", "GARDEN", "WINDOW", "PLANET", "RIVER", "JUMPING", "QUIZ", "OXYGEN", "PUZZLE",
+    "MOUNTAIN", "BICYCLE", "KITCHEN", "LANTERN", "ZEBRA", "ORCHESTRA", "VOLCANO", "SHADOW", "ENGINEER", "ALPHABET",
+    "FREEDOM", "JOURNEY", "WHISPER", "CRYSTAL", "THUNDER", "HARVEST", "MARBLE", "SQUIRREL", "BLANKET", "DIAMOND"
+};
+#define WORDS (sizeof(words) / sizeof(words[0]))
+
+static PrefixCode code;
+static PressDecoder decoder;
+static uint32_t now; // The replay's clock, in microseconds
+
+void setUp(void){
+    PrefixBuild(&code, PrefixEnglish);
+    PressInit(&decoder, &(PressConfig)PRESS_DEFAULT_CONFIG);
+    now = 0;
+}
+
+void tearDown(void){
+}
+
+// Purpose: Presses one digit through the decoder, returns the digit it decoded
+static PressBit press(int digit){
+    PressBit bit;
+
+    now += BETWEEN;
+    PressFeed(&decoder, now, true);
+    now += digit ? ONE_HELD : ZERO_HELD;
+    PressFeed(&decoder, now, false);
+    bit = PressPoll(&decoder, now + decoder.config.debounce);
+    return bit;
+}
+
+// Purpose: Enters a letter with its prefix code, checks it comes out as the same letter,
+//          and returns how long it took in microseconds. presses gets the presses it took
+static uint32_t enterCoded(char letter, int *presses){
+    uint8_t node = PREFIX_ROOT;
+    uint32_t start = now + BETWEEN;
+    int symbol = -1;
+
+    PressClear(&decoder);
+    for (int i = 0 ; symbol < 0 ; i++){
+        PressBit bit = press((code.bits[letter - 'A'] >> i) & 1);
+
+        TEST_ASSERT_TRUE(bit == PRESS_ZERO || bit == PRESS_ONE);
+        symbol = PrefixStep(&code, &node, bit == PRESS_ONE);
+    }
+    TEST_ASSERT_EQUAL(letter - 'A', symbol);
+    *presses = PressBits(&decoder);
+    return decoder.rawTime - start;
+}
+
+// Purpose: Enters a letter in 8 digit ascii, the first digit the lowest, and returns how long it took
+static uint32_t enterAscii(char letter, int *presses){
+    uint32_t start = now + BETWEEN;
+
+    PressClear(&decoder);
+    for (int i = 0 ; i < 8 ; i++){
+        press((letter >> i) & 1);
+    }
+    TEST_ASSERT_EQUAL(letter, PressValue(&decoder));
+    *presses = PressBits(&decoder);
+    return decoder.rawTime - start;
+}
+
+// Purpose: The letters in order of how common they are in English, the order the replayed player guesses in
+static void byFrequency(char order[26]){
+    for (int i = 0 ; i < 26 ; i++){
+        order[i] = 'A' + i;
+    }
+    for (int i = 1 ; i < 26 ; i++){
+        for (int j = i ; j > 0 && PrefixEnglish[order[j] - 'A'] > PrefixEnglish[order[j - 1] - 'A'] ; j--){
+            char swap = order[j];
+
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+    }
+}
+
+// Purpose: Plays a word to the end, and writes the letters guessed in order. Returns how many there were
+static int session(const char *word, char *guesses){
+    char order[26];
+    int count = 0, lives = LIVES;
+    uint32_t left = 0;
+
+    byFrequency(order);
+    for (const char *c = word ; *c ; c++){
+        left |= 1UL << (*c - 'A');
+    }
+    for (int i = 0 ; i < 26 && left != 0 && lives > 0 ; i++){
+        guesses[count++] = order[i];
+        if (left & (1UL << (order[i] - 'A'))){
+            left &= ~(1UL << (order[i] - 'A'));
+        }
+        else{
+            lives--;
+        }
+    }
+    return count;
+}
+
+void test_every_code_decodes_to_its_symbol(void){
+    for (int symbol = 0 ; symbol < PREFIX_SYMBOLS ; symbol++){
+        uint8_t node = PREFIX_ROOT;
+        int found = -1;
+
+        for (int i = 0 ; i < code.length[symbol] ; i++){
+            TEST_ASSERT_EQUAL(-1, found); // No code is the start of another
+            found = PrefixStep(&code, &node, (code.bits[symbol] >> i) & 1);
+        }
+        TEST_ASSERT_EQUAL(symbol, found);
+    }
+}
+
+void test_common_letters_take_three_or_four_presses(void){
+    static const char common[] = "ETAOINSHR";
+
+    for (int i = 0 ; common[i] ; i++){
+        TEST_ASSERT_TRUE(code.length[common[i] - 'A'] >= 3);
+        TEST_ASSERT_TRUE(code.length[common[i] - 'A'] <= 4);
+    }
+    TEST_ASSERT_TRUE(PrefixAverage(&code, PrefixEnglish) < 450);
+}
+
+void test_code_follows_the_weights(void){
+    static uint16_t even[PREFIX_SYMBOLS];
+
+    // With every symbol as common as the others the code is as long for all of them as 29 symbols need
+    for (int i = 0 ; i < PREFIX_SYMBOLS ; i++){
+        even[i] = 1;
+    }
+    PrefixBuild(&code, even);
+    for (int i = 0 ; i < PREFIX_SYMBOLS ; i++){
+        TEST_ASSERT_TRUE(code.length[i] == 4 || code.length[i] == 5);
+    }
+}
+
+void test_replayed_sessions(void){
+    char guesses[26], report[160];
+    int sessions = 0, count = 0, presses;
+    uint32_t codedPresses = 0, asciiPresses = 0;
+    uint64_t codedTime = 0, asciiTime = 0;
+
+    for (unsigned w = 0 ; w < WORDS ; w++){
+        int n = session(words[w], guesses);
+
+        for (int i = 0 ; i < n ; i++){
+            codedTime += enterCoded(guesses[i], &presses);
+            codedPresses += presses;
+            asciiTime += enterAscii(guesses[i], &presses);
+            asciiPresses += presses;
+        }
+        sessions++;
+        count += n;
+    }
+
+    // Most guesses are common letters, which take 3 or 4 presses instead of 8
+    TEST_ASSERT_EQUAL_UINT32(8 * count, asciiPresses);
+    TEST_ASSERT_TRUE(codedPresses < 5UL * count);
+    TEST_ASSERT_TRUE(codedTime * 10 < asciiTime * 6);
+
+    snprintf(report, sizeof(report), "%d sessions, %d guesses: code %lu.%02lu presses in %lu ms per guess, ascii %lu presses in %lu ms",
+             sessions, count, (unsigned long)(codedPresses / count), (unsigned long)(codedPresses * 100 / count % 100),
+             (unsigned long)(codedTime / count / MS), (unsigned long)(asciiPresses / count), (unsigned long)(asciiTime / count / MS));
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_every_code_decodes_to_its_symbol);
+    RUN_TEST(test_common_letters_take_three_or_four_presses);
+    RUN_TEST(test_code_follows_the_weights);
+    RUN_TEST(test_replayed_sessions);
+    return UNITY_END();
+}
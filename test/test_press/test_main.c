@@ -0,0 +1,342 @@
+// Tests of the press decoder and its learner, fed recorded traces of button edges, and how long it takes per edge
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "press.h"
+
+#define MS 1000UL // Microseconds in a millisecond, the traces are written in milliseconds
+
+typedef struct {
+    uint32_t time; // microseconds
+    bool pressed;
+} Edge;
+
+static PressDecoder decoder;
+static PressLearner learner;
+static uint32_t traceTime; // Where the learner's traces are up to, in microseconds
+
+void setUp(void){
+    PressInit(&decoder, &(PressConfig)PRESS_DEFAULT_CONFIG);
+    PressLearnInit(&learner, &decoder.config);
+    traceTime = 0;
+}
+
+void tearDown(void){
+}
+
+// Purpose: Feeds a trace, then lets the time run on to end, and writes the digits it gave as "0", "1" and "D"
+static void replay(const Edge *edges, int count, uint32_t end, char *digits){
+    int n = 0;
+    PressBit bit;
+
+    for (int i = 0 ; i < count ; i++){
+        bit = PressFeed(&decoder, edges[i].time, edges[i].pressed);
+        if (bit != PRESS_NONE){
+            digits[n++] = "?01D"[bit];
+        }
+    }
+    bit = PressPoll(&decoder, end);
+    if (bit != PRESS_NONE){
+        digits[n++] = "?01D"[bit];
+    }
+    digits[n] = 0;
+}
+
+void test_short_medium_and_long_presses(void){
+    static const Edge trace[] = {
+        {1000 * MS, true}, {1100 * MS, false}, // 100 ms: 0
+        {2000 * MS, true}, {3000 * MS, false}, // 1 s: 1
+        {4000 * MS, true}, {7000 * MS, false}, // 3 s: redo
+        {8000 * MS, true}, {8499 * MS, false}, // just under 500 ms: 0
+        {9000 * MS, true}, {9500 * MS, false}  // exactly 500 ms: 1
+    };
+    char digits[16];
+
+    replay(trace, 10, 10000 * MS, digits);
+    TEST_ASSERT_EQUAL_STRING("01D01", digits);
+    TEST_ASSERT_EQUAL(4, PressBits(&decoder)); // The redo is not a digit
+    TEST_ASSERT_EQUAL_HEX32(0xA, PressValue(&decoder)); // 0, 1, 0, 1 with the first digit lowest
+}
+
+void test_release_is_settled_only_after_the_debounce_time(void){
+    PressFeed(&decoder, 1000 * MS, true);
+    PressFeed(&decoder, 1200 * MS, false);
+    TEST_ASSERT_EQUAL(PRESS_NONE, PressPoll(&decoder, 1200 * MS + 19 * MS));
+    TEST_ASSERT_TRUE(PressIsDown(&decoder));
+    TEST_ASSERT_EQUAL(PRESS_ZERO, PressPoll(&decoder, 1200 * MS + 20 * MS));
+    TEST_ASSERT_FALSE(PressIsDown(&decoder));
+    TEST_ASSERT_EQUAL(PRESS_NONE, PressPoll(&decoder, 1300 * MS)); // Only once
+}
+
+void test_bounces_add_no_digits(void){
+    // The contacts chatter for a few milliseconds on both edges of a 1 s press
+    static const Edge trace[] = {
+        {1000 * MS, true}, {1001 * MS, false}, {1002 * MS, true}, {1004 * MS, false}, {1005 * MS, true},
+        {2005 * MS, false}, {2006 * MS, true}, {2008 * MS, false}
+    };
+    char digits[16];
+
+    replay(trace, 8, 3000 * MS, digits);
+    TEST_ASSERT_EQUAL_STRING("1", digits);
+
+    // The press is timed from the last bounce of the press to the last bounce of the release
+    TEST_ASSERT_EQUAL_UINT32(1003 * MS, PressLastHeld(&decoder));
+}
+
+void test_glitch_shorter_than_debounce_is_ignored(void){
+    static const Edge trace[] = {{1000 * MS, true}, {1005 * MS, false}};
+    char digits[16];
+
+    replay(trace, 2, 2000 * MS, digits);
+    TEST_ASSERT_EQUAL_STRING("", digits);
+    TEST_ASSERT_EQUAL(0, PressBits(&decoder));
+}
+
+void test_held_press_is_classified_live(void){
+    PressFeed(&decoder, 1000 * MS, true);
+    PressPoll(&decoder, 1030 * MS);
+    TEST_ASSERT_TRUE(PressIsDown(&decoder));
+    TEST_ASSERT_EQUAL_UINT32(400 * MS, PressHeld(&decoder, 1400 * MS));
+    TEST_ASSERT_EQUAL(PRESS_ZERO, PressClassify(&decoder, PressHeld(&decoder, 1400 * MS)));
+    TEST_ASSERT_EQUAL(PRESS_ONE, PressClassify(&decoder, PressHeld(&decoder, 2000 * MS)));
+    TEST_ASSERT_EQUAL(PRESS_REDO, PressClassify(&decoder, PressHeld(&decoder, 4000 * MS)));
+}
+
+void test_clear_keeps_a_press_in_progress(void){
+    static const Edge trace[] = {{100 * MS, true}, {200 * MS, false}, {1000 * MS, true}};
+    char digits[16];
+
+    replay(trace, 3, 1100 * MS, digits);
+    TEST_ASSERT_EQUAL(1, PressBits(&decoder));
+
+    // The next input starts while the button is still down, the press counts for it
+    PressClear(&decoder);
+    TEST_ASSERT_EQUAL(0, PressBits(&decoder));
+    PressFeed(&decoder, 1800 * MS, false);
+    TEST_ASSERT_EQUAL(PRESS_ONE, PressPoll(&decoder, 1900 * MS));
+    TEST_ASSERT_EQUAL(1, PressBits(&decoder));
+    TEST_ASSERT_EQUAL_HEX32(1, PressValue(&decoder));
+}
+
+void test_clock_wrap_in_the_middle_of_a_press(void){
+    // TIM5 wraps every 2^32 us, about 71 minutes, a press across it is still timed right
+    static const Edge trace[] = {{0xFFFFFFFFUL - 300 * MS, true}, {700 * MS, false}};
+    char digits[16];
+
+    replay(trace, 2, 800 * MS, digits);
+    TEST_ASSERT_EQUAL_STRING("1", digits);
+    TEST_ASSERT_EQUAL_UINT32(1000 * MS + 1, PressLastHeld(&decoder));
+}
+
+void test_digits_stop_at_the_maximum(void){
+    uint32_t t = 0;
+
+    for (int i = 0 ; i < PRESS_MAX_BITS + 3 ; i++, t += 2000 * MS){
+        PressFeed(&decoder, t + 100 * MS, true);
+        PressFeed(&decoder, t + 900 * MS, false); // A 1 every time
+    }
+    PressPoll(&decoder, t);
+    TEST_ASSERT_EQUAL(PRESS_MAX_BITS, PressBits(&decoder));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFFUL, PressValue(&decoder));
+}
+
+void test_password_trace(void){
+    // A recorded entry of the default password, 1 0 1 0 0 1 0 1 (0xA5 read with the first digit lowest),
+    // with a slip taken back by a redo after the third digit
+    static const Edge trace[] = {
+        {310 * MS, true}, {1262 * MS, false}, {1266 * MS, true}, {1268 * MS, false},
+        {2113 * MS, true}, {2301 * MS, false},
+        {3020 * MS, true}, {3795 * MS, false},
+        {4502 * MS, true}, {7711 * MS, false},
+        {8450 * MS, true}, {8611 * MS, false},
+        {9120 * MS, true}, {9266 * MS, false},
+        {9820 * MS, true}, {10990 * MS, false},
+        {11500 * MS, true}, {11503 * MS, false}, {11505 * MS, true}, {11640 * MS, false},
+        {12210 * MS, true}, {13005 * MS, false}
+    };
+    char digits[16];
+
+    replay(trace, sizeof(trace) / sizeof(trace[0]), 14000 * MS, digits);
+    TEST_ASSERT_EQUAL_STRING("101D00101", digits);
+    TEST_ASSERT_EQUAL(8, PressBits(&decoder));
+    TEST_ASSERT_EQUAL_HEX32(0xA5, PressValue(&decoder));
+}
+
+// Purpose: Makes one clean press held this long, a second after the one before, and learns from
+//          the digit it gave the way the game does. Returns the digit
+static PressBit learnPress(uint32_t held){
+    PressBit bit;
+
+    traceTime += 1000 * MS;
+    PressFeed(&decoder, traceTime, true);
+    traceTime += held;
+    PressFeed(&decoder, traceTime, false);
+    bit = PressPoll(&decoder, traceTime + decoder.config.debounce);
+    PressLearn(&learner, &decoder, bit);
+    PressClear(&decoder);
+    return bit;
+}
+
+void test_learner_starts_at_the_thresholds_it_was_given(void){
+    TEST_ASSERT_EQUAL_UINT32(250 * MS, learner.shortMean);
+    TEST_ASSERT_EQUAL_UINT32(750 * MS, learner.longMean);
+
+    // Calibrating with those same averages changes nothing
+    PressLearnSet(&learner, &decoder, 250 * MS, 750 * MS);
+    TEST_ASSERT_EQUAL_UINT32(500 * MS, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(2500 * MS, decoder.config.redoAfter);
+}
+
+void test_calibration_moves_both_thresholds(void){
+    // The boundary goes halfway between the averages, the redo keeps its ratio of 5 to it
+    PressLearnSet(&learner, &decoder, 300 * MS, 1200 * MS);
+    TEST_ASSERT_EQUAL_UINT32(750 * MS, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(3750 * MS, decoder.config.redoAfter);
+}
+
+void test_slow_player_trace(void){
+    // A player who holds a 0 for about 420 ms and a 1 for about 1.4 s, alternating with some spread
+    static const uint32_t zeros[] = {430, 390, 455, 410, 400, 445, 380, 425};
+    static const uint32_t ones[] = {1350, 1480, 1390, 1420, 1300, 1460, 1410, 1390};
+
+    for (int round = 0 ; round < 6 ; round++){
+        for (int i = 0 ; i < 8 ; i++){
+            TEST_ASSERT_EQUAL(PRESS_ZERO, learnPress(zeros[i] * MS));
+            TEST_ASSERT_EQUAL(PRESS_ONE, learnPress(ones[i] * MS));
+        }
+    }
+
+    // The averages have come to the player's, and the boundary with them, about 900 ms
+    TEST_ASSERT_UINT32_WITHIN(20 * MS, 417 * MS, learner.shortMean);
+    TEST_ASSERT_UINT32_WITHIN(30 * MS, 1400 * MS, learner.longMean);
+    TEST_ASSERT_UINT32_WITHIN(30 * MS, 908 * MS, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(decoder.config.oneAfter / 16 * learner.redoRatio, decoder.config.redoAfter); // Still 5 times the boundary
+
+    // A 600 ms press was a 1 for the default thresholds, for this player it is a slow 0
+    TEST_ASSERT_EQUAL(PRESS_ZERO, learnPress(600 * MS));
+}
+
+void test_quick_player_trace(void){
+    static const uint32_t zeros[] = {110, 130, 95, 120, 140, 105};
+    static const uint32_t ones[] = {420, 380, 450, 400, 390, 430};
+
+    // This player's 1s are all under 500 ms, so they come out as 0s. The learner only learns from what was
+    // decoded, it never sees a 1 to move the boundary down with: that is what the timing check is for
+    for (int i = 0 ; i < 6 ; i++){
+        TEST_ASSERT_EQUAL(PRESS_ZERO, learnPress(ones[i] * MS));
+    }
+    TEST_ASSERT_TRUE(decoder.config.oneAfter > 450 * MS);
+
+    // The timing check measures 4 presses of each kind and sets the averages to them
+    PressLearnSet(&learner, &decoder, (110 + 130 + 95 + 120) * MS / 4, (420 + 380 + 450 + 400) * MS / 4);
+    TEST_ASSERT_UINT32_WITHIN(MS, 264 * MS, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(PRESS_MIN_REDO_AFTER, decoder.config.redoAfter);
+
+    // From then on every press is what the player meant, and the learning keeps it that way
+    for (int round = 0 ; round < 6 ; round++){
+        for (int i = 0 ; i < 6 ; i++){
+            TEST_ASSERT_EQUAL(PRESS_ZERO, learnPress(zeros[i] * MS));
+            TEST_ASSERT_EQUAL(PRESS_ONE, learnPress(ones[i] * MS));
+        }
+    }
+    TEST_ASSERT_UINT32_WITHIN(20 * MS, 264 * MS, decoder.config.oneAfter);
+}
+
+void test_redos_teach_nothing(void){
+    PressConfig before = decoder.config;
+    PressLearner was = learner;
+
+    for (int i = 0 ; i < 10 ; i++){
+        TEST_ASSERT_EQUAL(PRESS_REDO, learnPress(4000 * MS));
+    }
+    TEST_ASSERT_EQUAL_UINT32(was.shortMean, learner.shortMean);
+    TEST_ASSERT_EQUAL_UINT32(was.longMean, learner.longMean);
+    TEST_ASSERT_EQUAL_UINT32(before.oneAfter, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(before.redoAfter, decoder.config.redoAfter);
+}
+
+void test_thresholds_stay_inside_their_bounds(void){
+    // Calibration presses far outside what anyone aims for, both ways
+    PressLearnSet(&learner, &decoder, 20 * MS, 60 * MS);
+    TEST_ASSERT_EQUAL_UINT32(PRESS_MIN_ONE_AFTER, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(PRESS_MIN_REDO_AFTER, decoder.config.redoAfter);
+    PressLearnSet(&learner, &decoder, 3000 * MS, 9000 * MS);
+    TEST_ASSERT_EQUAL_UINT32(PRESS_MAX_ONE_AFTER, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(PRESS_MAX_REDO_AFTER, decoder.config.redoAfter);
+}
+
+void test_crossed_averages_keep_the_boundary(void){
+    // 0s as long as the 1s, e.g. a calibration done the wrong way round
+    PressLearnSet(&learner, &decoder, 900 * MS, 300 * MS);
+    TEST_ASSERT_EQUAL_UINT32(500 * MS, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(2500 * MS, decoder.config.redoAfter);
+}
+
+void test_same_trace_learns_the_same_thresholds(void){
+    static const uint32_t trace[] = {300, 1100, 280, 950, 340, 1240, 310, 1010, 290, 870};
+    uint32_t oneAfter, redoAfter;
+
+    for (int i = 0 ; i < 10 ; i++){
+        learnPress(trace[i] * MS);
+    }
+    oneAfter = decoder.config.oneAfter;
+    redoAfter = decoder.config.redoAfter;
+
+    setUp();
+    traceTime = 123456789; // Another time of day, only the press lengths matter
+    for (int i = 0 ; i < 10 ; i++){
+        learnPress(trace[i] * MS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(oneAfter, decoder.config.oneAfter);
+    TEST_ASSERT_EQUAL_UINT32(redoAfter, decoder.config.redoAfter);
+}
+
+void test_feed_speed(void){
+    enum { EDGES = 2000000 };
+    char report[80];
+    uint32_t t = 0, digits = 0;
+    clock_t start = clock();
+
+    // Presses of 100 to 1600 ms with a 2 ms bounce at each end, and a poll between edges like the main loop does
+    for (uint32_t i = 0 ; i < EDGES / 4 ; i++){
+        uint32_t held = (100 + (i * 7919) % 1500) * MS;
+
+        PressFeed(&decoder, t, true);
+        PressFeed(&decoder, t + 2 * MS, true);
+        PressPoll(&decoder, t + 30 * MS);
+        PressFeed(&decoder, t + held, false);
+        digits += PressPoll(&decoder, t + held + 30 * MS) != PRESS_NONE;
+        PressClear(&decoder);
+        t += held + 200 * MS;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_EQUAL_UINT32(EDGES / 4, digits);
+    snprintf(report, sizeof(report), "%.1f ns per edge or poll on this computer", seconds * 1e9 / (EDGES / 4 * 5));
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_short_medium_and_long_presses);
+    RUN_TEST(test_release_is_settled_only_after_the_debounce_time);
+    RUN_TEST(test_bounces_add_no_digits);
+    RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+    RUN_TEST(test_held_press_is_classified_live);
+    RUN_TEST(test_clear_keeps_a_press_in_progress);
+    RUN_TEST(test_clock_wrap_in_the_middle_of_a_press);
+    RUN_TEST(test_digits_stop_at_the_maximum);
+    RUN_TEST(test_password_trace);
+    RUN_TEST(test_learner_starts_at_the_thresholds_it_was_given);
+    RUN_TEST(test_calibration_moves_both_thresholds);
+    RUN_TEST(test_slow_player_trace);
+    RUN_TEST(test_quick_player_trace);
+    RUN_TEST(test_redos_teach_nothing);
+    RUN_TEST(test_thresholds_stay_inside_their_bounds);
+    RUN_TEST(test_crossed_averages_keep_the_boundary);
+    RUN_TEST(test_same_trace_learns_the_same_thresholds);
+    RUN_TEST(test_feed_speed);
+    return UNITY_END();
+}
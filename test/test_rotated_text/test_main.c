@@ -0,0 +1,241 @@
+// Tests of ST7789_WriteStringRotated, by decoding the commands it sends to the panel
+
+// The SPI calls are recorded with the level of the DC pin, so the bytes split
+// into commands (DC low) and their data (DC high), like the panel reads them.
+// Each test then looks for the MADCTL, CASET and RASET the text should give.
+
+#include <string.h>
+#include <unity.h>
+#include "st7789 drivers.h"
+
+#define LOG_SIZE 16384
+#define MAX_COMMANDS 256
+
+typedef struct {
+    uint8_t command;
+    uint16_t first;  // Where its data starts in data[]
+    uint16_t length; // Bytes of data after it
+} Command;
+
+GPIO_TypeDef HostGPIOA, HostGPIOB, HostGPIOC;
+SPI_HandleTypeDef hspi1;
+
+static bool dc; // Level of the DC pin, high for data
+static uint8_t data[LOG_SIZE];
+static uint16_t dataLength;
+static Command commands[MAX_COMMANDS];
+static int commandCount;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state){
+    if (port == ST7789_DC_PORT && pin == ST7789_DC_PIN){
+        dc = state == GPIO_PIN_SET;
+    }
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *spi, uint8_t *bytes, uint16_t size, uint32_t timeout){
+    for (int i = 0 ; i < size ; i++){
+        if (!dc){
+            TEST_ASSERT_LESS_THAN(MAX_COMMANDS, commandCount);
+            commands[commandCount].command = bytes[i];
+            commands[commandCount].first = dataLength;
+            commands[commandCount].length = 0;
+            commandCount++;
+        }
+        else if (commandCount > 0 && dataLength < LOG_SIZE){
+            data[dataLength++] = bytes[i];
+            commands[commandCount - 1].length++;
+        }
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *spi, uint8_t *bytes, uint16_t size){
+    return HAL_SPI_Transmit(spi, bytes, size, HAL_MAX_DELAY);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *spi){
+    return HAL_SPI_STATE_READY;
+}
+
+void HAL_Delay(uint32_t delay){
+}
+
+uint32_t HAL_GetTick(void){
+    return 0;
+}
+
+void setUp(void){
+    dataLength = 0;
+    commandCount = 0;
+    ST7789_ResetClip();
+}
+
+void tearDown(void){
+}
+
+// Purpose: Returns the index of the count-th (from 0) command of this kind, or -1 if there are not that many
+static int findCommand(uint8_t command, int count){
+    for (int i = 0 ; i < commandCount ; i++){
+        if (commands[i].command == command && count-- == 0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Purpose: Returns the count-th CASET or RASET as its first and last address
+static void window(uint8_t command, int count, uint16_t *start, uint16_t *end){
+    int i = findCommand(command, count);
+
+    TEST_ASSERT_TRUE(i >= 0);
+    TEST_ASSERT_EQUAL(4, commands[i].length);
+    *start = data[commands[i].first] << 8 | data[commands[i].first + 1];
+    *end = data[commands[i].first + 2] << 8 | data[commands[i].first + 3];
+}
+
+// Purpose: Returns the MADCTL value SetRotation gives a rotation
+static uint8_t madctl(int rotation){
+    static const uint8_t values[4] = {
+        ST7789_MADCTL_MX | ST7789_MADCTL_MY | ST7789_MADCTL_RGB,
+        ST7789_MADCTL_MY | ST7789_MADCTL_MV | ST7789_MADCTL_RGB,
+        ST7789_MADCTL_RGB,
+        ST7789_MADCTL_MX | ST7789_MADCTL_MV | ST7789_MADCTL_RGB
+    };
+    return values[rotation % 4];
+}
+
+// Purpose: Checks the text is drawn in the turned frame and the rotation is put back after it
+static void checkTurns(uint8_t dir){
+    int first = findCommand(ST7789_MADCTL, 0);
+    int last = findCommand(ST7789_MADCTL, 1);
+
+    TEST_ASSERT_EQUAL(0, first);
+    TEST_ASSERT_EQUAL(commandCount - 1, last);
+    TEST_ASSERT_EQUAL(-1, findCommand(ST7789_MADCTL, 2));
+    TEST_ASSERT_EQUAL(1, commands[first].length);
+    TEST_ASSERT_EQUAL_HEX8(madctl(ST7789_ROTATION + dir), data[commands[first].first]);
+    TEST_ASSERT_EQUAL_HEX8(madctl(ST7789_ROTATION), data[commands[last].first]);
+}
+
+void test_down_turns_the_panel_and_back(void){
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_DOWN);
+    checkTurns(ST7789_TEXT_DOWN);
+}
+
+void test_up_turns_the_panel_and_back(void){
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_UP);
+    checkTurns(ST7789_TEXT_UP);
+}
+
+void test_down_glyph_windows(void){
+    uint16_t start, end;
+
+    // Top to bottom: the screen's y runs along the turned frame's x, and its x runs backwards along y
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_DOWN);
+    for (int k = 0 ; k < 2 ; k++){
+        window(ST7789_CASET, k, &start, &end);
+        TEST_ASSERT_EQUAL(X_SHIFT + 20 + 7 * k, start);
+        TEST_ASSERT_EQUAL(X_SHIFT + 20 + 7 * k + 6, end);
+        window(ST7789_RASET, k, &start, &end);
+        TEST_ASSERT_EQUAL(Y_SHIFT + ST7789_WIDTH - 10 - 10, start);
+        TEST_ASSERT_EQUAL(Y_SHIFT + ST7789_WIDTH - 10 - 1, end);
+    }
+    TEST_ASSERT_EQUAL(-1, findCommand(ST7789_CASET, 2));
+}
+
+void test_up_glyph_windows(void){
+    uint16_t start, end;
+
+    // Bottom to top: the first letter is at the bottom, so the text ends at the turned frame's far end
+    ST7789_WriteStringRotated(10, 20, "ABC", Font_7x10, WHITE, BLACK, ST7789_TEXT_UP);
+    for (int k = 0 ; k < 3 ; k++){
+        window(ST7789_CASET, k, &start, &end);
+        TEST_ASSERT_EQUAL(X_SHIFT + ST7789_HEIGHT - 20 - 3 * 7 + 7 * k, start);
+        TEST_ASSERT_EQUAL(X_SHIFT + ST7789_HEIGHT - 20 - 3 * 7 + 7 * k + 6, end);
+        window(ST7789_RASET, k, &start, &end);
+        TEST_ASSERT_EQUAL(Y_SHIFT + 10, start);
+        TEST_ASSERT_EQUAL(Y_SHIFT + 10 + 9, end);
+    }
+}
+
+void test_every_glyph_pixel_is_sent(void){
+    int written = 0;
+
+    ST7789_WriteStringRotated(30, 40, "Hi!", Font_11x18, WHITE, BLACK, ST7789_TEXT_DOWN);
+    for (int i = 0 ; i < commandCount ; i++){
+        if (commands[i].command == ST7789_RAMWR){
+            // The pixels are sent as data right after RAMWR, with no command between
+            for (int j = i + 1 ; j < commandCount && commands[j].command != ST7789_CASET && commands[j].command != ST7789_MADCTL ; j++){
+                written += commands[j].length;
+            }
+            written += commands[i].length;
+        }
+    }
+    TEST_ASSERT_EQUAL(3 * 11 * 18 * 2, written);
+}
+
+void test_clip_is_turned_with_the_text(void){
+    uint16_t start, end;
+
+    // Only the screen rows 20 to 24 may be drawn: the first glyph (rows 20 to 26) is cut, the second is skipped
+    ST7789_PushClip(0, 0, ST7789_WIDTH, 25);
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_DOWN);
+    window(ST7789_CASET, 0, &start, &end);
+    TEST_ASSERT_EQUAL(X_SHIFT + 20, start);
+    TEST_ASSERT_EQUAL(X_SHIFT + 24, end);
+    TEST_ASSERT_EQUAL(-1, findCommand(ST7789_CASET, 1));
+}
+
+void test_clip_and_rotation_are_restored(void){
+    uint16_t start, end;
+
+    ST7789_PushClip(0, 0, ST7789_WIDTH, 25);
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_UP);
+    commandCount = dataLength = 0;
+
+    // Plain text after it is in the normal frame, and still cut by the rectangle pushed before
+    ST7789_WriteString(5, 20, "A", Font_7x10, WHITE, BLACK);
+    TEST_ASSERT_EQUAL(-1, findCommand(ST7789_MADCTL, 0));
+    window(ST7789_CASET, 0, &start, &end);
+    TEST_ASSERT_EQUAL(X_SHIFT + 5, start);
+    TEST_ASSERT_EQUAL(X_SHIFT + 11, end);
+    window(ST7789_RASET, 0, &start, &end);
+    TEST_ASSERT_EQUAL(Y_SHIFT + 20, start);
+    TEST_ASSERT_EQUAL(Y_SHIFT + 24, end);
+}
+
+void test_bad_direction_sends_nothing(void){
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, 2);
+    TEST_ASSERT_EQUAL(0, commandCount);
+}
+
+#ifdef ST7789_USE_FRAMEBUFFER
+void test_framebuffer_is_not_turned(void){
+    ST7789_FB_Begin(BLACK);
+    ST7789_FB_Flush();
+    commandCount = dataLength = 0;
+
+    // The framebuffer turns the text itself, the panel only ever sees rows in its own orientation
+    ST7789_WriteStringRotated(10, 20, "AB", Font_7x10, WHITE, BLACK, ST7789_TEXT_DOWN);
+    TEST_ASSERT_EQUAL(0, commandCount);
+    ST7789_FB_End();
+    TEST_ASSERT_EQUAL(-1, findCommand(ST7789_MADCTL, 0));
+    TEST_ASSERT_TRUE(findCommand(ST7789_CASET, 0) >= 0);
+}
+#endif
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_down_turns_the_panel_and_back);
+    RUN_TEST(test_up_turns_the_panel_and_back);
+    RUN_TEST(test_down_glyph_windows);
+    RUN_TEST(test_up_glyph_windows);
+    RUN_TEST(test_every_glyph_pixel_is_sent);
+    RUN_TEST(test_clip_is_turned_with_the_text);
+    RUN_TEST(test_clip_and_rotation_are_restored);
+    RUN_TEST(test_bad_direction_sends_nothing);
+#ifdef ST7789_USE_FRAMEBUFFER
+    RUN_TEST(test_framebuffer_is_not_turned);
+#endif
+    return UNITY_END();
+}
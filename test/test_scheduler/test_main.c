@@ -0,0 +1,284 @@
+// Tests of the scheduler, run on a virtual clock that the tests move by hand
+
+#include <stdio.h>
+#include <time.h>
+#include <unity.h>
+#include "scheduler.h"
+
+#define LOG_SIZE 64
+
+typedef struct {
+    uint16_t event;
+    uint32_t arg;
+    uint32_t time; // Virtual time it was handled at
+} Handled;
+
+static uint32_t clockTime;
+static Handled handled[LOG_SIZE];
+static int handledCount;
+static int pollCount;
+static int pollWork; // Passes the poller still reports work for
+
+// Purpose: The virtual clock given to the scheduler
+static uint32_t virtualClock(void){
+    return clockTime;
+}
+
+// Purpose: Records every event it gets with the time it got it
+static void record(uint16_t event, uint32_t arg){
+    if (handledCount < LOG_SIZE){
+        handled[handledCount].event = event;
+        handled[handledCount].arg = arg;
+        handled[handledCount].time = clockTime;
+        handledCount++;
+    }
+}
+
+// Purpose: Posts the next event from inside a handler, like a state that moves itself on
+static void chain(uint16_t event, uint32_t arg){
+    record(event, arg);
+    if (event < 3){
+        SchedPost(chain, event + 1, arg);
+    }
+}
+
+// Purpose: A hardware service that has work for pollWork passes
+static bool poller(void){
+    pollCount++;
+    if (pollWork > 0){
+        pollWork--;
+        return true;
+    }
+    return false;
+}
+
+// Purpose: Runs passes until the scheduler has nothing left to do, returns how many did something
+static int runAll(void){
+    int passes = 0;
+
+    while (SchedRunOnce()){
+        passes++;
+    }
+    return passes;
+}
+
+// Purpose: Moves the virtual clock on one step at a time up to end, running the scheduler at each step
+static void runUntil(uint32_t end, uint32_t step){
+    while ((int32_t)(end - clockTime) > 0){
+        clockTime += step;
+        runAll();
+    }
+}
+
+void setUp(void){
+    clockTime = 0;
+    handledCount = 0;
+    pollCount = 0;
+    pollWork = 0;
+    SchedInit(virtualClock);
+}
+
+void tearDown(void){
+}
+
+void test_idle_scheduler_has_nothing_to_do(void){
+    TEST_ASSERT_FALSE(SchedRunOnce());
+    TEST_ASSERT_EQUAL_UINT32(0, SchedNow());
+    clockTime = 1234;
+    TEST_ASSERT_EQUAL_UINT32(1234, SchedNow());
+}
+
+void test_events_are_handled_in_order_one_per_pass(void){
+    for (int i = 0 ; i < 5 ; i++){
+        TEST_ASSERT_TRUE(SchedPost(record, i, i * 10));
+    }
+    for (int i = 0 ; i < 5 ; i++){
+        TEST_ASSERT_TRUE(SchedRunOnce());
+        TEST_ASSERT_EQUAL(i + 1, handledCount);
+        TEST_ASSERT_EQUAL(i, handled[i].event);
+        TEST_ASSERT_EQUAL_UINT32(i * 10, handled[i].arg);
+    }
+    TEST_ASSERT_FALSE(SchedRunOnce());
+}
+
+void test_full_queue_refuses_events(void){
+    for (int i = 0 ; i < SCHED_QUEUE_SIZE ; i++){
+        TEST_ASSERT_TRUE(SchedPost(record, i, 0));
+    }
+    TEST_ASSERT_FALSE(SchedPost(record, 99, 0));
+    TEST_ASSERT_EQUAL(SCHED_QUEUE_SIZE, runAll());
+    TEST_ASSERT_EQUAL(SCHED_QUEUE_SIZE, handledCount);
+    TEST_ASSERT_EQUAL(SCHED_QUEUE_SIZE - 1, handled[SCHED_QUEUE_SIZE - 1].event);
+}
+
+void test_handlers_can_post_the_next_event(void){
+    SchedPost(chain, 0, 7);
+    TEST_ASSERT_EQUAL(4, runAll());
+    TEST_ASSERT_EQUAL(4, handledCount);
+    for (int i = 0 ; i < 4 ; i++){
+        TEST_ASSERT_EQUAL(i, handled[i].event);
+    }
+}
+
+void test_one_shot_timer_fires_once_when_due(void){
+    clockTime = 100;
+    int timer = SchedTimer(record, 5, 50, 0);
+
+    TEST_ASSERT_TRUE(timer >= 0);
+    clockTime = 149;
+    TEST_ASSERT_FALSE(SchedRunOnce());
+    clockTime = 150;
+    runAll();
+    TEST_ASSERT_EQUAL(1, handledCount);
+    TEST_ASSERT_EQUAL(5, handled[0].event);
+    TEST_ASSERT_EQUAL_UINT32(timer, handled[0].arg); // The timer is the argument
+    clockTime = 10000;
+    TEST_ASSERT_FALSE(SchedRunOnce());
+    TEST_ASSERT_EQUAL(1, handledCount);
+}
+
+void test_periodic_timer_keeps_its_pace(void){
+    SchedTimer(record, 1, 10, 10);
+    runUntil(100, 1);
+    TEST_ASSERT_EQUAL(10, handledCount);
+    for (int i = 0 ; i < 10 ; i++){
+        TEST_ASSERT_EQUAL_UINT32(10 * (i + 1), handled[i].time);
+    }
+}
+
+void test_periodic_timer_skips_missed_periods(void){
+    SchedTimer(record, 1, 10, 10);
+
+    // The main loop was held up for 55 periods: one event, not 55, and the pace starts again from now
+    clockTime = 555;
+    runAll();
+    TEST_ASSERT_EQUAL(1, handledCount);
+    clockTime = 564;
+    runAll();
+    TEST_ASSERT_EQUAL(1, handledCount);
+    clockTime = 565;
+    runAll();
+    TEST_ASSERT_EQUAL(2, handledCount);
+}
+
+void test_cancelled_timer_stays_quiet(void){
+    int timer = SchedTimer(record, 1, 10, 10);
+
+    runUntil(25, 5);
+    TEST_ASSERT_EQUAL(2, handledCount);
+    SchedCancel(timer);
+    SchedCancel(-1); // Nothing happens
+    runUntil(100, 5);
+    TEST_ASSERT_EQUAL(2, handledCount);
+}
+
+void test_all_timers_in_use(void){
+    for (int i = 0 ; i < SCHED_TIMERS ; i++){
+        TEST_ASSERT_EQUAL(i, SchedTimer(record, i, 10, 0));
+    }
+    TEST_ASSERT_EQUAL(-1, SchedTimer(record, 99, 10, 0));
+
+    // A timer that has fired is free again
+    clockTime = 10;
+    runAll();
+    TEST_ASSERT_EQUAL(SCHED_TIMERS, handledCount);
+    TEST_ASSERT_TRUE(SchedTimer(record, 99, 10, 0) >= 0);
+}
+
+void test_timer_waits_while_the_queue_is_full(void){
+    SchedTimer(record, 42, 10, 0);
+    for (int i = 0 ; i < SCHED_QUEUE_SIZE ; i++){
+        SchedPost(record, i, 0);
+    }
+
+    // The timer cannot post yet, it tries again on every pass and comes after the events already queued
+    clockTime = 10;
+    runAll();
+    TEST_ASSERT_EQUAL(SCHED_QUEUE_SIZE + 1, handledCount);
+    TEST_ASSERT_EQUAL(42, handled[SCHED_QUEUE_SIZE].event);
+}
+
+void test_timers_fire_across_the_clock_wrap(void){
+    // A millisecond tick wraps after 49 days, a timer set just before still fires on time
+    clockTime = 0xFFFFFFF0UL;
+    SchedTimer(record, 1, 0x20, 0);
+    SchedTimer(record, 2, 8, 8);
+    runUntil(0x30, 1);
+    TEST_ASSERT_EQUAL(9, handledCount); // Eight periods and the one-shot
+    for (int i = 0 ; i < 3 ; i++){
+        TEST_ASSERT_EQUAL(2, handled[i].event);
+        TEST_ASSERT_EQUAL_UINT32(0xFFFFFFF8UL + 8 * i, handled[i].time);
+    }
+    TEST_ASSERT_EQUAL(1, handled[3].event);
+    TEST_ASSERT_EQUAL_UINT32(0x10, handled[3].time);
+}
+
+void test_pollers_run_on_every_pass(void){
+    TEST_ASSERT_TRUE(SchedAddPoller(poller));
+
+    // A poller with work keeps the scheduler busy, so the main loop does not sleep
+    pollWork = 3;
+    TEST_ASSERT_EQUAL(3, runAll());
+    TEST_ASSERT_EQUAL(4, pollCount);
+    SchedPost(record, 1, 0);
+    TEST_ASSERT_TRUE(SchedRunOnce());
+    TEST_ASSERT_EQUAL(5, pollCount);
+
+    for (int i = 1 ; i < SCHED_POLLERS ; i++){
+        TEST_ASSERT_TRUE(SchedAddPoller(poller));
+    }
+    TEST_ASSERT_FALSE(SchedAddPoller(poller));
+}
+
+void test_init_forgets_everything(void){
+    SchedPost(record, 1, 0);
+    SchedTimer(record, 2, 1, 1);
+    SchedAddPoller(poller);
+    SchedInit(virtualClock);
+    clockTime = 1000;
+    TEST_ASSERT_FALSE(SchedRunOnce());
+    TEST_ASSERT_EQUAL(0, handledCount);
+    TEST_ASSERT_EQUAL(0, pollCount);
+}
+
+void test_pass_speed(void){
+    enum { PASSES = 2000000 };
+    char report[80];
+    clock_t start = clock();
+
+    // The busy case of the game: a frame timer, a poller, and an event on most passes
+    SchedAddPoller(poller);
+    SchedTimer(record, 1, 30, 30);
+    for (uint32_t i = 0 ; i < PASSES ; i++){
+        clockTime = i;
+        if (i % 4 != 0){
+            SchedPost(record, 0, i);
+        }
+        SchedRunOnce();
+        handledCount = 0;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_EQUAL(PASSES, pollCount);
+    snprintf(report, sizeof(report), "%.1f ns per pass on this computer", seconds * 1e9 / PASSES);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_scheduler_has_nothing_to_do);
+    RUN_TEST(test_events_are_handled_in_order_one_per_pass);
+    RUN_TEST(test_full_queue_refuses_events);
+    RUN_TEST(test_handlers_can_post_the_next_event);
+    RUN_TEST(test_one_shot_timer_fires_once_when_due);
+    RUN_TEST(test_periodic_timer_keeps_its_pace);
+    RUN_TEST(test_periodic_timer_skips_missed_periods);
+    RUN_TEST(test_cancelled_timer_stays_quiet);
+    RUN_TEST(test_all_timers_in_use);
+    RUN_TEST(test_timer_waits_while_the_queue_is_full);
+    RUN_TEST(test_timers_fire_across_the_clock_wrap);
+    RUN_TEST(test_pollers_run_on_every_pass);
+    RUN_TEST(test_init_forgets_everything);
+    RUN_TEST(test_pass_speed);
+    return UNITY_END();
+}
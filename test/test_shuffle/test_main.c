@@ -0,0 +1,191 @@
+// Tests of the word order: that it is a permutation, that it looks random, and how fast it is
+
+// The chi-square tests tally, over thousands of consecutive seeds, where the
+// order sends a word and which word follows which. Consecutive seeds are the
+// hard case: the game's seeds come from press timings, which differ in a few
+// low bits. Small counts are the other hard case, with only a few bits in each
+// half of the network. The limit each statistic is held to is the 0.1% tail of
+// its chi-square distribution: the seeds are fixed and the tests always pass,
+// but an order that favoured some words would not.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "shuffle.h"
+
+#define MAX_COUNT 1024 // Every count up to this one is checked to be a permutation
+#define SEEDS 20000    // Orders tallied by the chi-square tests
+
+static uint8_t seen[(1UL << 17) / 8]; // One bit for every index of the largest order checked
+static Shuffle shuffle;
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+// Purpose: Checks that the order for this count and seed gives every index below count exactly once
+static void checkPermutation(uint32_t count, uint32_t seed){
+    ShuffleInit(&shuffle, count, seed);
+    memset(seen, 0, (count + 7) / 8);
+    for (uint32_t i = 0 ; i < count ; i++){
+        uint32_t at = ShuffleAt(&shuffle, i);
+
+        TEST_ASSERT_TRUE(at < count);
+        TEST_ASSERT_FALSE(seen[at / 8] & (1 << (at % 8)));
+        seen[at / 8] |= 1 << (at % 8);
+    }
+}
+
+// The values chi-square statistics with 81, 55 and 63 degrees of freedom are over only 0.1% of the time
+#define CHI_SQUARE_81 126.1
+#define CHI_SQUARE_55 93.2
+#define CHI_SQUARE_63 103.5
+
+// Purpose: The chi-square statistic of tallies that should all be expected, leaving out the ones that cannot happen
+static double chiSquare(const uint32_t *tallies, int cells, double expected, int skip){
+    double sum = 0;
+
+    for (int i = 0 ; i < cells ; i++){
+        if (skip == 0 || i % skip != 0){
+            sum += (tallies[i] - expected) * (tallies[i] - expected) / expected;
+        }
+    }
+    return sum;
+}
+
+void test_every_count_is_a_permutation(void){
+    for (uint32_t count = 1 ; count <= MAX_COUNT ; count++){
+        checkPermutation(count, count * 2654435761UL);
+        checkPermutation(count, 0);
+    }
+}
+
+void test_large_counts_are_permutations(void){
+    // Around the sizes where the network grows a bit in each half, and the largest list there is
+    static const uint32_t counts[] = {4095, 4096, 4097, 65535, 65536, 65537, 100000, 1UL << 17};
+
+    for (unsigned i = 0 ; i < sizeof(counts) / sizeof(counts[0]) ; i++){
+        checkPermutation(counts[i], 12345);
+    }
+}
+
+void test_no_words_gives_index_0(void){
+    ShuffleInit(&shuffle, 0, 7);
+    TEST_ASSERT_EQUAL_UINT32(0, ShuffleAt(&shuffle, 0));
+}
+
+void test_seeds_give_different_orders(void){
+    uint32_t first[16], same = 0;
+
+    ShuffleInit(&shuffle, 1000, 1);
+    for (int i = 0 ; i < 16 ; i++){
+        first[i] = ShuffleAt(&shuffle, i);
+    }
+    ShuffleInit(&shuffle, 1000, 2);
+    for (int i = 0 ; i < 16 ; i++){
+        same += ShuffleAt(&shuffle, i) == first[i];
+    }
+    TEST_ASSERT_TRUE(same < 3);
+}
+
+void test_words_land_anywhere_evenly(void){
+    enum { COUNT = 10 };
+    static uint32_t tallies[COUNT][COUNT]; // How often word i of the order was dictionary index j
+    char report[100];
+    double sum;
+
+    for (uint32_t seed = 0 ; seed < SEEDS ; seed++){
+        ShuffleInit(&shuffle, COUNT, seed);
+        for (int i = 0 ; i < COUNT ; i++){
+            tallies[i][ShuffleAt(&shuffle, i)]++;
+        }
+    }
+    // Every order fills each row and each column once, which leaves (COUNT - 1)^2 degrees of freedom
+    sum = chiSquare(tallies[0], COUNT * COUNT, (double)SEEDS / COUNT, 0);
+    snprintf(report, sizeof(report), "place of each word: chi-square %.1f, limit %.1f", sum, CHI_SQUARE_81);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_TRUE(sum < CHI_SQUARE_81);
+}
+
+void test_next_word_is_unrelated(void){
+    enum { COUNT = 8 };
+    static uint32_t tallies[COUNT * COUNT]; // How often index i was followed by index j
+    char report[100];
+    double sum;
+
+    // One pair from each order, a different place in it for each seed, so the pairs are independent
+    for (uint32_t seed = 0 ; seed < SEEDS ; seed++){
+        int i = seed % (COUNT - 1);
+
+        ShuffleInit(&shuffle, COUNT, seed);
+        tallies[ShuffleAt(&shuffle, i) * COUNT + ShuffleAt(&shuffle, i + 1)]++;
+    }
+    // No word follows itself, so the diagonal is left out: COUNT * (COUNT - 1) pairs, one less degree of freedom
+    for (int i = 0 ; i < COUNT ; i++){
+        TEST_ASSERT_EQUAL_UINT32(0, tallies[i * COUNT + i]);
+    }
+    sum = chiSquare(tallies, COUNT * COUNT, (double)SEEDS / (COUNT * (COUNT - 1)), COUNT + 1);
+    snprintf(report, sizeof(report), "word after each word: chi-square %.1f, limit %.1f", sum, CHI_SQUARE_55);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_TRUE(sum < CHI_SQUARE_55);
+}
+
+void test_first_word_of_a_large_list_is_even(void){
+    enum { BINS = 64 };
+    static uint32_t tallies[BINS]; // Where the first word of a game lands, in 64 equal parts of the list
+    uint32_t count = 10007;
+    char report[100];
+    double sum;
+
+    for (uint32_t seed = 0 ; seed < SEEDS ; seed++){
+        ShuffleInit(&shuffle, count, seed);
+        tallies[(uint64_t)ShuffleAt(&shuffle, 0) * BINS / count]++;
+    }
+    // 10007 is not a multiple of 64, but the parts differ by one index in 156, well under what the test sees
+    sum = chiSquare(tallies, BINS, (double)SEEDS / BINS, 0);
+    snprintf(report, sizeof(report), "first word of %lu: chi-square %.1f, limit %.1f", (unsigned long)count, sum, CHI_SQUARE_63);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_TRUE(sum < CHI_SQUARE_63);
+}
+
+void test_time_per_word(void){
+    static const uint32_t counts[] = {5, 1000, 10000, 100000};
+    char report[160];
+    int length = 0;
+
+    for (unsigned c = 0 ; c < sizeof(counts) / sizeof(counts[0]) ; c++){
+        uint32_t sum = 0, words = 0;
+        clock_t start = clock();
+
+        // Whole orders, the way a game goes through one, until there are a million words
+        while (words < 1000000){
+            ShuffleInit(&shuffle, counts[c], words);
+            for (uint32_t i = 0 ; i < counts[c] ; i++){
+                sum += ShuffleAt(&shuffle, i);
+            }
+            words += counts[c];
+        }
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        TEST_ASSERT_TRUE(sum != 0);
+        length += snprintf(report + length, sizeof(report) - length, "%s%lu words %.0f ns", c ? ", " : "time per word: ",
+                           (unsigned long)counts[c], seconds * 1e9 / words);
+    }
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_every_count_is_a_permutation);
+    RUN_TEST(test_large_counts_are_permutations);
+    RUN_TEST(test_no_words_gives_index_0);
+    RUN_TEST(test_seeds_give_different_orders);
+    RUN_TEST(test_words_land_anywhere_evenly);
+    RUN_TEST(test_next_word_is_unrelated);
+    RUN_TEST(test_first_word_of_a_large_list_is_even);
+    RUN_TEST(test_time_per_word);
+    return UNITY_END();
+}
@@ -0,0 +1,293 @@
+// Tests of the game snapshot and its backup registers: packing, saves cut short, damaged words, and resuming
+
+// The backup registers are a struct in RAM here (see test/host). A save cut
+// short by a reset is made by hand, with the first writes BackupSave() does in
+// the order it does them: the check word cleared, then the words from the last
+// to the first, so the check word is written last. Resuming is timed from the
+// registers to the words that still fit the guesses, the way src/hangman.c
+// does it in resumeGame(), without the screen.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "backup.h"
+#include "candidates.h"
+#include "game.h"
+#include "shuffle.h"
+#include "stm32f4xx_hal.h"
+
+RTC_TypeDef HostRTC;
+
+void HAL_PWR_EnableBkUpAccess(void){
+}
+
+// Purpose: The registers of a slot
+static uint32_t *slot(int number){
+    return (uint32_t *)&HostRTC + number * SNAPSHOT_WORDS;
+}
+
+// Purpose: A snapshot with every field set, different for every n
+static Snapshot example(uint32_t n){
+    Snapshot snapshot = {
+        .seed = 0x9E3779B9UL * (n + 1),
+        .round = n % DictCount,
+        .word = (n * 7) % DictCount,
+        .guessed = (0x2AAAAAAUL >> (n % 26)) & 0x3FFFFFFUL,
+        .lives = 1 + n % 15,
+        .evil = n & 1,
+        .coded = (n >> 1) & 1,
+        .shortMean = 250 + n % 100,
+        .longMean = 900 + n % 300
+    };
+    return snapshot;
+}
+
+// Purpose: Checks that two snapshots hold the same game
+static void assertSame(const Snapshot *expected, const Snapshot *actual){
+    TEST_ASSERT_EQUAL_HEX32(expected->seed, actual->seed);
+    TEST_ASSERT_EQUAL_UINT32(expected->round, actual->round);
+    TEST_ASSERT_EQUAL_UINT32(expected->word, actual->word);
+    TEST_ASSERT_EQUAL_HEX32(expected->guessed, actual->guessed);
+    TEST_ASSERT_EQUAL(expected->lives, actual->lives);
+    TEST_ASSERT_EQUAL(expected->evil, actual->evil);
+    TEST_ASSERT_EQUAL(expected->coded, actual->coded);
+    TEST_ASSERT_EQUAL_UINT16(expected->shortMean, actual->shortMean);
+    TEST_ASSERT_EQUAL_UINT16(expected->longMean, actual->longMean);
+}
+
+void setUp(void){
+    memset(&HostRTC, 0, sizeof(HostRTC)); // As after power up on the Nucleo
+    BackupSetup();
+}
+
+void tearDown(void){
+}
+
+void test_round_trip(void){
+    uint32_t words[SNAPSHOT_WORDS];
+    uint16_t sequence;
+    Snapshot out;
+
+    for (uint32_t n = 0 ; n < 1000 ; n++){
+        Snapshot in = example(n);
+
+        SnapshotEncode(&in, n * 37, words);
+        TEST_ASSERT_TRUE(SnapshotDecode(&out, &sequence, words));
+        TEST_ASSERT_EQUAL_UINT16(n * 37, sequence);
+        assertSame(&in, &out);
+    }
+}
+
+void test_largest_values_round_trip(void){
+    Snapshot in = {0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0x3FFFFFFUL, 15, true, true, 0xFFFF, 0xFFFF}, out;
+    uint32_t words[SNAPSHOT_WORDS];
+    uint16_t sequence;
+
+    SnapshotEncode(&in, 0xFFFF, words);
+    TEST_ASSERT_TRUE(SnapshotDecode(&out, &sequence, words));
+    assertSame(&in, &out);
+}
+
+void test_blank_registers_are_no_snapshot(void){
+    static const uint32_t blank[] = {0, 0xFFFFFFFFUL};
+    uint32_t words[SNAPSHOT_WORDS];
+    uint16_t sequence;
+    Snapshot out;
+
+    for (int i = 0 ; i < 2 ; i++){
+        for (int w = 0 ; w < SNAPSHOT_WORDS ; w++){
+            words[w] = blank[i];
+        }
+        TEST_ASSERT_FALSE(SnapshotDecode(&out, &sequence, words));
+    }
+    TEST_ASSERT_FALSE(BackupLoad(&out)); // Nothing after power up
+}
+
+void test_every_bit_flip_is_caught(void){
+    uint32_t words[SNAPSHOT_WORDS];
+    uint16_t sequence;
+    Snapshot out;
+
+    for (uint32_t n = 0 ; n < 200 ; n++){
+        Snapshot in = example(n);
+
+        SnapshotEncode(&in, n, words);
+        for (int w = 0 ; w < SNAPSHOT_WORDS ; w++){
+            for (int bit = 0 ; bit < 32 ; bit++){
+                words[w] ^= 1UL << bit;
+                TEST_ASSERT_FALSE(SnapshotDecode(&out, &sequence, words));
+                words[w] ^= 1UL << bit;
+            }
+        }
+    }
+}
+
+void test_random_damage_passes_as_rarely_as_the_check_allows(void){
+    enum { TRIES = 2000000 };
+    uint32_t words[SNAPSHOT_WORDS], damaged[SNAPSHOT_WORDS], state = 1, passed = 0, tried = 0;
+    Snapshot in = example(3), out;
+    uint16_t sequence;
+    char report[100];
+
+    // One to four random bits flipped in random words. One bit is always caught (see above), of more a 16 bit
+    // check can at best catch all but one in 65536
+    SnapshotEncode(&in, 500, words);
+    for (uint32_t i = 0 ; i < TRIES ; i++){
+        memcpy(damaged, words, sizeof(words));
+        for (int flips = 1 + ShuffleRandom(&state) % 4 ; flips > 0 ; flips--){
+            uint32_t r = ShuffleRandom(&state);
+
+            damaged[r % SNAPSHOT_WORDS] ^= 1UL << ((r >> 8) % 32);
+        }
+        if (memcmp(damaged, words, sizeof(words)) != 0){
+            passed += SnapshotDecode(&out, &sequence, damaged);
+            tried++;
+        }
+    }
+    snprintf(report, sizeof(report), "%lu of %lu damaged snapshots passed, at most %lu expected",
+             (unsigned long)passed, (unsigned long)tried, (unsigned long)(tried / 65536));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_TRUE(passed < 2 * tried / 65536);
+}
+
+void test_sequence_numbers_wrap(void){
+    TEST_ASSERT_TRUE(SnapshotNewer(1, 0));
+    TEST_ASSERT_FALSE(SnapshotNewer(0, 1));
+    TEST_ASSERT_FALSE(SnapshotNewer(5, 5));
+    TEST_ASSERT_TRUE(SnapshotNewer(0, 0xFFFF));
+    TEST_ASSERT_FALSE(SnapshotNewer(0xFFFF, 0));
+    TEST_ASSERT_TRUE(SnapshotNewer(0x7FFF, 0));
+    TEST_ASSERT_FALSE(SnapshotNewer(0x8000, 0)); // Half way round, the older one
+}
+
+void test_newest_survives_the_wrap(void){
+    Snapshot old = example(1), young = example(2), next = example(3), out;
+
+    // Slot 0 has the last number before the wrap, slot 1 the first after it
+    SnapshotEncode(&old, 0xFFFF, slot(0));
+    SnapshotEncode(&young, 0, slot(1));
+    BackupSetup();
+    TEST_ASSERT_TRUE(BackupLoad(&out));
+    assertSame(&young, &out);
+
+    // The next save goes over the older one, slot 0, and is newer still
+    BackupSave(&next);
+    BackupSetup();
+    TEST_ASSERT_TRUE(BackupLoad(&out));
+    assertSame(&next, &out);
+    TEST_ASSERT_EQUAL_HEX32(1, slot(0)[0] & 0xFFFF);
+}
+
+void test_saves_take_turns(void){
+    uint16_t sequence;
+    Snapshot out;
+
+    // With no snapshot yet the first save goes to slot 0
+    for (uint32_t n = 0 ; n < 10 ; n++){
+        Snapshot in = example(n);
+
+        BackupSave(&in);
+        BackupSetup(); // As after a reset
+        TEST_ASSERT_TRUE(BackupLoad(&out));
+        assertSame(&in, &out);
+        TEST_ASSERT_TRUE(SnapshotDecode(&out, &sequence, slot(n % 2)));
+        assertSame(&in, &out);
+    }
+}
+
+void test_torn_save_leaves_the_one_before(void){
+    Snapshot older = example(10), newest = example(11), saving = example(12), out;
+    int target = 0; // The slot with the older one, which the next save goes over
+    RTC_TypeDef before, after;
+
+    BackupSave(&older);
+    BackupSave(&newest);
+    before = HostRTC;
+    BackupSave(&saving);
+    after = HostRTC;
+
+    // The reset comes after 0 to all of the writes of the save
+    for (int writes = 0 ; writes <= SNAPSHOT_WORDS + 1 ; writes++){
+        uint32_t *registers = slot(target), *done = (uint32_t *)&after + target * SNAPSHOT_WORDS;
+
+        HostRTC = before;
+        if (writes > 0){
+            registers[0] = 0;
+        }
+        for (int i = 0 ; i < writes - 1 ; i++){
+            registers[SNAPSHOT_WORDS - 1 - i] = done[SNAPSHOT_WORDS - 1 - i];
+        }
+
+        BackupSetup();
+        TEST_ASSERT_TRUE(BackupLoad(&out));
+        assertSame(writes == SNAPSHOT_WORDS + 1 ? &saving : &newest, &out);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(&after, &HostRTC, sizeof(HostRTC)); // The writes by hand are the ones BackupSave() does
+}
+
+void test_clear_forgets_both(void){
+    Snapshot in = example(4), out;
+
+    BackupSave(&in);
+    BackupSave(&in);
+    BackupClear();
+    TEST_ASSERT_FALSE(BackupLoad(&out));
+    BackupSetup();
+    TEST_ASSERT_FALSE(BackupLoad(&out));
+}
+
+void test_boot_to_resume_time(void){
+    enum { ROUNDS = 1000 };
+    Snapshot in = example(0), out;
+    static Candidates candidates;
+    static Shuffle order;
+    static Game game;
+    uint32_t words = 0;
+    char report[120];
+    clock_t start;
+
+    // A game well under way: its word and most of its letters guessed, with a few misses
+    in.word = DictCount / 2;
+    in.guessed = DictMask(in.word) | 0x0210001UL;
+    BackupSave(&in);
+
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        BackupSetup();
+        TEST_ASSERT_TRUE(BackupLoad(&out));
+        ShuffleInit(&order, DictCount, out.seed);
+        GameStart(&game, out.lives);
+        GameWord(&game, DictView(out.word), DictMask(out.word));
+        game.guessed = out.guessed;
+        CandAll(&candidates, GameLength(&game));
+        for (char letter = 'A' ; letter <= 'Z' ; letter++){
+            if (GameGuessed(&game, letter)){
+                CandKeep(&candidates, letter, GamePositions(&game, letter));
+            }
+        }
+        words += candidates.count;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_TRUE(CandHas(&candidates, in.word));
+    snprintf(report, sizeof(report), "%lu words: resumed in %.1f us, with %lu candidates left",
+             (unsigned long)DictCount, seconds * 1e6 / ROUNDS, (unsigned long)(words / ROUNDS));
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_largest_values_round_trip);
+    RUN_TEST(test_blank_registers_are_no_snapshot);
+    RUN_TEST(test_every_bit_flip_is_caught);
+    RUN_TEST(test_random_damage_passes_as_rarely_as_the_check_allows);
+    RUN_TEST(test_sequence_numbers_wrap);
+    RUN_TEST(test_newest_survives_the_wrap);
+    RUN_TEST(test_saves_take_turns);
+    RUN_TEST(test_torn_save_leaves_the_one_before);
+    RUN_TEST(test_clear_forgets_both);
+    RUN_TEST(test_boot_to_resume_time);
+    return UNITY_END();
+}
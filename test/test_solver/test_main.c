@@ -0,0 +1,137 @@
+// Tests of the hint solver, and how long a hint takes on a large list
+
+// The tests run on whatever list the build was given: the words of src/words.txt
+// in [env:native], or made-up words in [env:native_10k], [env:native_large] and
+// [env:native_100k] (see tools/dictionary.py). The counts are checked against
+// the letter masks of the words, one word at a time.
+
+#include <stdio.h>
+#include <time.h>
+#include <unity.h>
+#include "solver.h"
+
+static Candidates candidates;
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+// Purpose: Puts every word of the dictionary in the set, whatever its length
+static void allWords(Candidates *set){
+    for (int i = 0 ; i < DICT_SETS ; i++){
+        set->bits[i] = 0;
+    }
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        set->bits[i / 32] |= 1UL << (i % 32);
+    }
+    set->count = DictCount;
+}
+
+// Purpose: The length most words have, the set a game starts with most often
+static uint8_t commonLength(void){
+    uint32_t lengths[DICT_MAX_LENGTH + 1] = {0};
+    uint8_t common = 0;
+
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        lengths[DictLength(i)]++;
+    }
+    for (int length = 1 ; length <= DICT_MAX_LENGTH ; length++){
+        if (lengths[length] > lengths[common]){
+            common = length;
+        }
+    }
+    return common;
+}
+
+void test_counts_match_the_words(void){
+    uint32_t counts[26], expected[26] = {0};
+
+    CandAll(&candidates, commonLength());
+    CandRemove(&candidates, CandFirst(&candidates)); // A set that does not start on a whole 32 words
+    for (uint32_t i = 0 ; i < DictCount ; i++){
+        for (int letter = 0 ; letter < 26 && CandHas(&candidates, i) ; letter++){
+            expected[letter] += (DictMask(i) >> letter) & 1;
+        }
+    }
+    SolverCounts(&candidates, counts);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, counts, 26);
+}
+
+void test_hint_is_the_most_common_letter_not_guessed(void){
+    uint32_t counts[26], guessed = 0, count;
+
+    allWords(&candidates);
+    SolverCounts(&candidates, counts);
+
+    // Each hint, guessed, leaves the next most common letter for the following one
+    for (int hints = 0 ; hints < 26 ; hints++){
+        char hint = SolverHint(&candidates, guessed, &count);
+
+        if (hint == 0){
+            break;
+        }
+        TEST_ASSERT_FALSE(guessed & (1UL << (hint - 'A')));
+        TEST_ASSERT_EQUAL_UINT32(counts[hint - 'A'], count);
+        for (int letter = 0 ; letter < 26 ; letter++){
+            if (!(guessed & (1UL << letter))){
+                // Nothing not guessed is more common, and an equal one comes later in the alphabet
+                TEST_ASSERT_TRUE(counts[letter] < count || (counts[letter] == count && letter >= hint - 'A'));
+            }
+        }
+        guessed |= 1UL << (hint - 'A');
+    }
+}
+
+void test_no_hint_when_no_letter_helps(void){
+    uint32_t count = 1;
+
+    allWords(&candidates);
+    TEST_ASSERT_EQUAL(0, SolverHint(&candidates, 0x3FFFFFFUL, &count)); // Every letter guessed
+    TEST_ASSERT_EQUAL_UINT32(0, count);
+
+    CandAll(&candidates, DICT_MAX_LENGTH + 1); // No word is this long
+    TEST_ASSERT_EQUAL_UINT32(0, candidates.count);
+    TEST_ASSERT_EQUAL(0, SolverHint(&candidates, 0, &count));
+}
+
+void test_hint_time(void){
+    enum { ROUNDS = 200 };
+    uint32_t count, found = 0, words;
+    uint8_t length = commonLength();
+    double all, common;
+    char report[140];
+    clock_t start;
+
+    // The first hint of a game, when most words still fit: over the whole list, and over the words of one length
+    allWords(&candidates);
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        found += SolverHint(&candidates, 0, &count) != 0;
+    }
+    all = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    CandAll(&candidates, length);
+    words = candidates.count;
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        found += SolverHint(&candidates, 0, &count) != 0;
+    }
+    common = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_EQUAL_UINT32(2 * ROUNDS, found);
+    // Every bitmap is counted whatever is in the set, so both take about as long
+    snprintf(report, sizeof(report), "%lu words: %.1f us per hint over all of them, %.1f us over the %lu of %u letters",
+             (unsigned long)DictCount, all * 1e6 / ROUNDS, common * 1e6 / ROUNDS, (unsigned long)words, length);
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_counts_match_the_words);
+    RUN_TEST(test_hint_is_the_most_common_letter_not_guessed);
+    RUN_TEST(test_no_hint_when_no_letter_helps);
+    RUN_TEST(test_hint_time);
+    return UNITY_END();
+}
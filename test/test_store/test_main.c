@@ -0,0 +1,308 @@
+// Tests of the store on flash kept in RAM: restarts, compaction, a power cut at every write, and what it costs
+
+// The two sectors are arrays here, and programming one only clears bits, like
+// the flash does. The power can be cut at any program or erase: that one is
+// left half done (the low half of the word programmed, or the first half of
+// the sector erased) and nothing after it reaches the flash. The store is
+// then started again on what is left, as the board would be after a reset.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "store.h"
+
+#define SECTOR_BYTES (128UL * 1024) // As big as sectors 6 and 7
+
+static uint32_t sectors[2][SECTOR_BYTES / 4];
+static uint32_t steps;  // Programs and erases so far
+static uint32_t cutAt;  // The step the power is cut at, 0 for never
+static bool off;        // The power is cut, nothing reaches the flash any more
+static Store store;
+
+// Purpose: Clears the 0 bits of word into the flash, unless the power is cut
+static bool ramProgram(int sector, uint32_t offset, uint32_t word){
+    TEST_ASSERT_EQUAL_UINT32(0, offset % 4);
+    if (off){
+        return false;
+    }
+    if (++steps == cutAt){
+        sectors[sector][offset / 4] &= word | 0xFFFF0000UL;
+        off = true;
+        return false;
+    }
+    sectors[sector][offset / 4] &= word;
+    return true;
+}
+
+static bool ramErase(int sector);
+
+static StoreFlash flash = {
+    {(const uint8_t *)sectors[0], (const uint8_t *)sectors[1]},
+    SECTOR_BYTES,
+    ramProgram,
+    ramErase
+};
+
+// Purpose: Sets the sector back to all 1, unless the power is cut
+static bool ramErase(int sector){
+    if (off){
+        return false;
+    }
+    if (++steps == cutAt){
+        memset(sectors[sector], 0xFF, flash.size / 2);
+        off = true;
+        return false;
+    }
+    memset(sectors[sector], 0xFF, flash.size);
+    return true;
+}
+
+// Purpose: Starts on flash that was never written, with sectors of this many bytes
+static void blank(uint32_t size){
+    memset(sectors, 0xFF, sizeof(sectors));
+    flash.size = size;
+    steps = cutAt = 0;
+    off = false;
+}
+
+void setUp(void){
+    blank(SECTOR_BYTES);
+}
+
+void tearDown(void){
+}
+
+void test_first_start_formats_the_flash(void){
+    TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+    TEST_ASSERT_EQUAL_UINT32(1, store.erases);
+    TEST_ASSERT_EQUAL_UINT32(STORE_HEADER, StoreUsed(&store));
+    for (uint8_t key = 0 ; key < STORE_KEYS ; key++){
+        uint8_t length;
+
+        TEST_ASSERT_NULL(StoreGet(&store, key, &length));
+    }
+}
+
+void test_values_survive_a_restart(void){
+    uint32_t password = 10110110, read = 0;
+    uint8_t lives = 7, readLives = 0;
+
+    StoreInit(&store, &flash);
+    TEST_ASSERT_TRUE(StorePut(&store, 0, &password, sizeof(password)));
+    TEST_ASSERT_TRUE(StorePut(&store, 1, &lives, sizeof(lives)));
+    lives = 5;
+    TEST_ASSERT_TRUE(StorePut(&store, 1, &lives, sizeof(lives)));
+
+    TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+    TEST_ASSERT_TRUE(StoreRead(&store, 0, &read, sizeof(read)));
+    TEST_ASSERT_EQUAL_UINT32(password, read);
+    TEST_ASSERT_TRUE(StoreRead(&store, 1, &readLives, sizeof(readLives)));
+    TEST_ASSERT_EQUAL(5, readLives);
+    TEST_ASSERT_FALSE(StoreRead(&store, 1, &read, sizeof(read))); // Stored with another length
+}
+
+void test_same_value_is_not_written_again(void){
+    uint16_t score = 12;
+
+    StoreInit(&store, &flash);
+    StorePut(&store, 2, &score, sizeof(score));
+    uint32_t programmed = store.programmed;
+
+    TEST_ASSERT_TRUE(StorePut(&store, 2, &score, sizeof(score)));
+    TEST_ASSERT_EQUAL_UINT32(programmed, store.programmed);
+}
+
+void test_bad_keys_and_lengths_are_refused(void){
+    uint8_t value[STORE_MAX_VALUE + 1] = {0};
+
+    StoreInit(&store, &flash);
+    TEST_ASSERT_FALSE(StorePut(&store, STORE_KEYS, value, 1));
+    TEST_ASSERT_FALSE(StorePut(&store, 0, value, STORE_MAX_VALUE + 1));
+    TEST_ASSERT_EQUAL_UINT32(STORE_HEADER, StoreUsed(&store));
+}
+
+void test_compaction_keeps_the_latest_values(void){
+    uint32_t value, read;
+
+    // 256 byte sectors fill up every few dozen values, so they swap many times
+    blank(256);
+    StoreInit(&store, &flash);
+    for (uint32_t i = 0 ; i < 1000 ; i++){
+        value = i;
+        TEST_ASSERT_TRUE(StorePut(&store, i % 5, &value, sizeof(value)));
+    }
+    TEST_ASSERT_TRUE(store.erases > 20);
+
+    TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+    for (uint32_t key = 0 ; key < 5 ; key++){
+        TEST_ASSERT_TRUE(StoreRead(&store, key, &read, sizeof(read)));
+        TEST_ASSERT_EQUAL_UINT32(995 + key, read);
+    }
+}
+
+void test_cut_record_is_skipped(void){
+    uint32_t value = 1, read;
+
+    StoreInit(&store, &flash);
+    StorePut(&store, 0, &value, sizeof(value));
+    value = 2;
+    cutAt = steps + 2; // The header is programmed, the value only half
+    TEST_ASSERT_FALSE(StorePut(&store, 0, &value, sizeof(value)));
+
+    off = false;
+    TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+    TEST_ASSERT_TRUE(StoreRead(&store, 0, &read, sizeof(read)));
+    TEST_ASSERT_EQUAL_UINT32(1, read);
+
+    // The log goes on after the record that was cut short
+    value = 3;
+    TEST_ASSERT_TRUE(StorePut(&store, 0, &value, sizeof(value)));
+    TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+    TEST_ASSERT_TRUE(StoreRead(&store, 0, &read, sizeof(read)));
+    TEST_ASSERT_EQUAL_UINT32(3, read);
+}
+
+// Purpose: The value of put i of the power cut test, as long as its key takes: 4, 2 or 12 bytes
+static uint8_t putValue(uint32_t i, uint8_t *value){
+    static const uint8_t lengths[] = {4, 2, 12};
+    uint8_t length = lengths[i % 3];
+
+    for (int b = 0 ; b < length ; b++){
+        value[b] = i + b;
+    }
+    return length;
+}
+
+void test_power_cut_at_every_program(void){
+    enum { PUTS = 40 };
+    uint8_t value[STORE_MAX_VALUE];
+    uint32_t total, cuts = 0;
+
+    // Without a cut first, to know how many steps there are: 40 values in 96 byte sectors compact several times
+    blank(96);
+    StoreInit(&store, &flash);
+    for (uint32_t i = 0 ; i < PUTS ; i++){
+        TEST_ASSERT_TRUE(StorePut(&store, i % 3, value, putValue(i, value)));
+    }
+    total = steps;
+    TEST_ASSERT_TRUE(store.erases > 3);
+
+    for (uint32_t cut = 1 ; cut <= total ; cut++){
+        int32_t last[3] = {-1, -1, -1}; // The put whose value each key has, -1 for none
+        int32_t pending = -1;           // The put the power was cut in
+        uint8_t length, expected[STORE_MAX_VALUE];
+        const uint8_t *data;
+
+        blank(96);
+        cutAt = cut;
+        if (StoreInit(&store, &flash)){
+            for (uint32_t i = 0 ; i < PUTS && pending < 0 ; i++){
+                if (StorePut(&store, i % 3, value, putValue(i, value))){
+                    last[i % 3] = i;
+                }
+                else{
+                    pending = i;
+                }
+            }
+        }
+        TEST_ASSERT_TRUE(off);
+
+        // After the reset every key has the value of its last put, or of the one that was cut short
+        off = false;
+        cutAt = 0;
+        TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+        for (uint32_t key = 0 ; key < 3 ; key++){
+            data = StoreGet(&store, key, &length);
+            if (pending >= 0 && pending % 3 == (int32_t)key && data != NULL
+                    && length == putValue(pending, expected) && memcmp(data, expected, length) == 0){
+                continue;
+            }
+            if (last[key] < 0){
+                TEST_ASSERT_NULL(data);
+            }
+            else{
+                TEST_ASSERT_NOT_NULL(data);
+                TEST_ASSERT_EQUAL(putValue(last[key], expected), length);
+                TEST_ASSERT_EQUAL_MEMORY(expected, data, length);
+            }
+        }
+
+        // And it goes on working
+        TEST_ASSERT_TRUE(StorePut(&store, 0, "KSV1", 4));
+        TEST_ASSERT_TRUE(StoreInit(&store, &flash));
+        TEST_ASSERT_NOT_NULL(data = StoreGet(&store, 0, &length));
+        TEST_ASSERT_EQUAL_MEMORY("KSV1", data, 4);
+        cuts++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(total, cuts);
+}
+
+void test_boot_index_rebuild_time(void){
+    enum { ROUNDS = 50 };
+    uint16_t score;
+    uint32_t records = 0;
+    char report[120];
+    clock_t start;
+
+    // A full sector of the game's 2 byte values, the longest log StoreInit() can have to walk
+    StoreInit(&store, &flash);
+    while (StoreFree(&store) >= 8){
+        score = records;
+        StorePut(&store, records % 3, &score, sizeof(score));
+        records++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, store.erases); // Only the format, it never compacted
+
+    start = clock();
+    for (int round = 0 ; round < ROUNDS ; round++){
+        StoreInit(&store, &flash);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT_TRUE(StoreRead(&store, (records - 1) % 3, &score, sizeof(score)));
+    TEST_ASSERT_EQUAL_UINT16(records - 1, score);
+    snprintf(report, sizeof(report), "boot: %lu bytes, %lu records indexed in %.0f us",
+             (unsigned long)StoreUsed(&store), (unsigned long)records, seconds * 1e6 / ROUNDS);
+    TEST_MESSAGE(report);
+}
+
+void test_write_amplification(void){
+    static const uint8_t lengths[] = {1, 2, 4, 32};
+    uint8_t value[STORE_MAX_VALUE];
+    char report[200];
+    int used = 0;
+
+    used += snprintf(report, sizeof(report), "bytes programmed per byte written:");
+    for (unsigned l = 0 ; l < sizeof(lengths) ; l++){
+        blank(SECTOR_BYTES);
+        StoreInit(&store, &flash);
+
+        // A new value of the same key every time, like the high score, with two other keys kept alongside
+        StorePut(&store, 1, value, 1);
+        StorePut(&store, 0, value, 4);
+        store.written = store.programmed = 0;
+        for (uint32_t i = 0 ; i < 100000 ; i++){
+            memcpy(value, &i, sizeof(i));
+            TEST_ASSERT_TRUE(StorePut(&store, 2, value, lengths[l]));
+        }
+        TEST_ASSERT_TRUE(store.programmed >= store.written);
+        used += snprintf(report + used, sizeof(report) - used, " %u byte values %.2f (%lu erases)", lengths[l],
+                         (double)store.programmed / store.written, (unsigned long)store.erases);
+    }
+    TEST_MESSAGE(report);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_first_start_formats_the_flash);
+    RUN_TEST(test_values_survive_a_restart);
+    RUN_TEST(test_same_value_is_not_written_again);
+    RUN_TEST(test_bad_keys_and_lengths_are_refused);
+    RUN_TEST(test_compaction_keeps_the_latest_values);
+    RUN_TEST(test_cut_record_is_skipped);
+    RUN_TEST(test_power_cut_at_every_program);
+    RUN_TEST(test_boot_index_rebuild_time);
+    RUN_TEST(test_write_amplification);
+    return UNITY_END();
+}
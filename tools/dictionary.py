@@ -0,0 +1,345 @@
+# Dictionary compiler: packs src/words.txt into lib/Dictionary/dictionary_words.c
+# and lib/Dictionary/dictionary_dawg.c
+#
+# Every letter is stored in 5 bits (A = 1 ... Z = 26), one word after the other,
+# with the offset of each word (in letters) and the mask of the letters it has,
+# so the game can fetch any word by its index without scanning the list.
+# For every letter there is also a bitmap of the words that have it, so sets of
+# words can be narrowed down 32 at a time.
+#
+# A perfect hash finds a word's index from its letters: the word's hash picks a
+# bucket, and the bucket's seed was searched for here so that the words of every
+# bucket land on free slots, one word per slot. A bucket of a single word is
+# given its slot in the seed instead, so there are exactly as many slots as
+# words. The words are written in the order of their slots, so a slot is the
+# word's index and no table maps one to the other; the play order is shuffled
+# anyway. Looking a word up is two hashes and a compare, with no tables in RAM.
+#
+# The same words are also stored as a DAWG: a trie in which equal endings are
+# shared, walked in place, see lib/Dictionary/dawg.h for the layout. The game
+# does not use it, so it is only linked into test/test_dictionary, which
+# compares it with the flat tables.
+#
+# Runs before every build as a PlatformIO extra script, and can be run by hand
+# with "python tools/dictionary.py". The file is only rewritten when it changes.
+#
+# An environment with "custom_dictionary_words = N" in platformio.ini gets N
+# made-up words instead, for the benchmarks on large lists under test/. They
+# are built into the environment's build directory and replace the words of
+# lib/Dictionary in that build only, the files in lib/Dictionary stay as they
+# are. "python tools/dictionary.py N DIR" writes the same files into DIR.
+
+import os
+import random
+import sys
+
+MAX_LENGTH = 16  # DICT_MAX_LENGTH, the letter positions of a word fit in 16 bits
+BITS = 5
+
+
+def read_words(path):
+    words = []
+    seen = set()
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            word = line.strip().upper()
+            if not word:
+                continue
+            if not word.isalpha() or not word.isascii():
+                sys.exit("%s:%d: %r is not made of letters A-Z" % (path, number, word))
+            if len(word) > MAX_LENGTH:
+                sys.exit("%s:%d: %s is longer than %d letters" % (path, number, word, MAX_LENGTH))
+            if word in seen:
+                sys.exit("%s:%d: %s is in the list twice" % (path, number, word))
+            seen.add(word)
+            words.append(word)
+    if not words:
+        sys.exit("%s: no words" % path)
+    return words
+
+
+def pack(words):
+    value = 0
+    bits = 0
+    for word in words:
+        for letter in word:
+            value |= (ord(letter) - ord("A") + 1) << bits
+            bits += BITS
+    # One byte more than needed, so every letter can be read as two whole bytes
+    return value.to_bytes((bits + 7) // 8 + 1, "little")
+
+
+def mask(word):
+    letters = 0
+    for letter in word:
+        letters |= 1 << (ord(letter) - ord("A"))
+    return letters
+
+
+def hash_word(word, seed):
+    # Same as DictHash() in lib/Dictionary/dictionary.c: FNV-1a from a seeded start, then mixed
+    value = 2166136261 ^ seed
+    for letter in word:
+        value = ((value ^ ord(letter)) * 16777619) & 0xFFFFFFFF
+    value ^= value >> 16
+    value = (value * 0x45D9F3B) & 0xFFFFFFFF
+    value ^= value >> 16
+    return value
+
+
+def seed_direct(count):
+    # DICT_DIRECT in lib/Dictionary/dictionary.h: the top bit of a seed, 16 bits wide up to 32768 words
+    return 0x8000 if count <= 0x8000 else 0x80000000
+
+
+def perfect_hash(words):
+    # Places every word in a slot of its own, one slot per word. The biggest buckets go first,
+    # while most slots are still free. A bucket of one word is given a free slot outright,
+    # with DICT_DIRECT set in its seed: the last few free slots are too few to hit by hash.
+    # Returns the seeds, and the index of the word in each slot
+    count = len(words)
+    direct = seed_direct(count)
+    buckets = [[] for _ in range((count + 3) // 4)]
+    for index, word in enumerate(words):
+        buckets[hash_word(word, 0) % len(buckets)].append(index)
+
+    seeds = [0] * len(buckets)
+    slots = [None] * count
+    free = None
+    for bucket in sorted(range(len(buckets)), key=lambda b: -len(buckets[b])):
+        members = buckets[bucket]
+        if len(members) == 1:
+            if free is None:
+                free = iter([slot for slot in range(count) if slots[slot] is None])
+            slot = next(free)
+            seeds[bucket] = direct | slot
+            slots[slot] = members[0]
+            continue
+        for seed in range(1, min(direct, 0x100000)):
+            taken = []
+            for index in members:
+                slot = hash_word(words[index], seed) % count
+                if slots[slot] is not None or slot in taken:
+                    break
+                taken.append(slot)
+            if len(taken) == len(members):
+                break
+        else:
+            sys.exit("words.txt: no seed places every word of a bucket, the hash needs changing")
+        seeds[bucket] = seed
+        for index, slot in zip(members, taken):
+            slots[slot] = index
+    return seeds, slots
+
+
+def array(ctype, name, values, per_line, form):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(form % v for v in values[i:i + per_line]) + ",")
+    return "const %s %s[] = {\n%s\n};\n" % (ctype, name, "\n".join(lines))
+
+
+def synthetic_words(count):
+    # Stems of letters as common as in English, each with a few of the usual endings, so that
+    # like real words many of them share their endings. Always the same words for a count
+    weights = [817, 129, 278, 425, 1270, 223, 202, 609, 697, 15, 77, 403, 241,
+               675, 751, 193, 10, 599, 633, 906, 276, 98, 236, 15, 197, 7]
+    vowels = [chr(ord("A") + i) for i in range(26) if chr(ord("A") + i) in "AEIOU"]
+    consonants = [chr(ord("A") + i) for i in range(26) if chr(ord("A") + i) not in "AEIOU"]
+    endings = ["", "S", "ED", "ING", "ER", "ERS", "LY", "NESS", "ION", "IONS", "ABLE", "MENT"]
+    rng = random.Random(count)
+    words = []
+    seen = set()
+    while len(words) < count:
+        stem = ""
+        for i in range(rng.randint(2, 9)):
+            group = vowels if i % 2 == 1 else consonants
+            stem += rng.choices(group, [weights[ord(letter) - ord("A")] for letter in group])[0]
+        for ending in rng.sample(endings, rng.randint(1, 4)):
+            word = stem + ending
+            if 3 <= len(word) <= MAX_LENGTH and word not in seen and len(words) < count:
+                seen.add(word)
+                words.append(word)
+    return words
+
+
+def generate(words, source="src/words.txt"):
+    # The words are stored in the order of their slots, so the slot the hash gives is the word's index
+    seeds, slots = perfect_hash(words)
+    words = [words[index] for index in slots]
+    offsets = [0]
+    for word in words:
+        offsets.append(offsets[-1] + len(word))
+    blob = pack(words)
+    sets = (len(words) + 31) // 32
+    letter_sets = [[0] * sets for _ in range(26)]
+    for index, word in enumerate(words):
+        for letter in set(word):
+            letter_sets[ord(letter) - ord("A")][index // 32] |= 1 << (index % 32)
+    seed_bytes = 2 if seed_direct(len(words)) == 0x8000 else 4  # DictSeed
+    flash = len(blob) + 4 * len(offsets) + 4 * len(words) + seed_bytes * len(seeds) + 4 * 26 * sets
+
+    text = "// Generated by tools/dictionary.py from %s, do not edit\n\n" % source
+    text += '#include "dictionary.h"\n\n'
+    text += "// %d words, %d letters: %d bytes of flash (%d letters, %d offsets, %d masks, %d hash, %d letter sets)\n\n" % (
+        len(words), offsets[-1], flash, len(blob), 4 * len(offsets), 4 * len(words), seed_bytes * len(seeds), 4 * 26 * sets)
+    text += "const uint32_t DictCount = %d;\n" % len(words)
+    text += "const uint32_t DictBuckets = %d;\n\n" % len(seeds)
+    text += array("uint8_t", "DictLetters", list(blob), 16, "0x%02X") + "\n"
+    text += array("uint32_t", "DictOffsets", offsets, 12, "%d") + "\n"
+    text += array("uint32_t", "DictMasks", [mask(w) for w in words], 6, "0x%07X") + "\n"
+    text += array("DictSeed", "DictSeeds", seeds, 12, "0x%X") + "\n"
+    text += "const uint32_t DictLetterSets[26][DICT_SETS] = {\n"
+    for letter, bits in enumerate(letter_sets):
+        text += "    {%s}, // %s\n" % (", ".join("0x%08X" % b for b in bits), chr(ord("A") + letter))
+    text += "};\n"
+    return text, flash
+
+
+def generate_sizes(words):
+    # Sizes the firmware needs at compile time, e.g. for bitmaps of the words in RAM.
+    # A build on another list defines them itself, see build_elsewhere()
+    text = "// Generated by tools/dictionary.py from src/words.txt, do not edit\n\n"
+    text += "#ifndef __DICTIONARY_WORDS_H\n#define __DICTIONARY_WORDS_H\n\n"
+    text += "#ifndef DICT_WORDS\n"
+    text += "#define DICT_WORDS %d // How many words there are\n" % len(words)
+    text += "#define DICT_SETS %d // 32-bit words in a bitmap of all of them\n" % ((len(words) + 31) // 32)
+    text += "#endif\n"
+    text += "\n#endif\n"
+    return text, 0
+
+
+def minimize(words):
+    # Builds the trie as nested {letter: [end, children]} and merges every node with an
+    # equal one already seen, from the leaves up. Two nodes are equal when their edges
+    # have the same letters, end flags and (already merged) children
+    trie = {}
+    for word in words:
+        node = trie
+        for i, letter in enumerate(word):
+            edge = node.setdefault(letter, [False, {}])
+            if i == len(word) - 1:
+                edge[0] = True
+            node = edge[1]
+
+    unique = {}  # signature: node id
+    nodes = []  # id: [(letter, end, child id)], id 0 is the empty node
+
+    def merge(node):
+        edges = tuple((letter, node[letter][0], merge(node[letter][1])) for letter in sorted(node))
+        if not edges:
+            return 0
+        if edges not in unique:
+            unique[edges] = len(nodes) + 1
+            nodes.append(edges)
+        return unique[edges]
+
+    return merge(trie), nodes
+
+
+def generate_dawg(words, source="src/words.txt"):
+    words = sorted(set(words))
+    root, nodes = minimize(words)
+
+    # Words that can be reached from every node, for finding the word at an index
+    below = {0: 0}
+    for number, edges in enumerate(nodes, 1):  # Children always come before their parents
+        below[number] = sum(end + below[child] for letter, end, child in edges)
+
+    # The root goes first, then the other nodes in the order they are reached
+    first = {}
+    order = [root]
+    queued = {root}
+    position = 0
+    for number in order:
+        first[number] = position
+        position += len(nodes[number - 1])
+        for letter, end, child in nodes[number - 1]:
+            if child != 0 and child not in queued:
+                order.append(child)
+                queued.add(child)
+    if position >= 1 << 25:
+        sys.exit("words.txt: %d DAWG edges, the child index only goes up to %d" % (position, (1 << 25) - 1))
+
+    edges = []
+    counts = []
+    for number in order:
+        node = nodes[number - 1]
+        for i, (letter, end, child) in enumerate(node):
+            edge = ord(letter) - ord("A") + 1
+            edge |= 0x20 if end else 0
+            edge |= 0x40 if i == len(node) - 1 else 0
+            edge |= (first[child] if child != 0 else 0) << 7
+            edges.append(edge)
+            counts.append(end + below[child])
+
+    lengths = [0] * (MAX_LENGTH + 1)
+    for word in words:
+        lengths[len(word)] += 1
+    tally = 2 if len(words) < 0x10000 else 4  # DawgTally in lib/Dictionary/dawg.h
+    flash = 4 * len(edges) + tally * len(counts) + 4 * len(lengths) + 4
+
+    text = "// Generated by tools/dictionary.py from %s, do not edit\n\n" % source
+    text += '#include "dawg.h"\n\n'
+    text += "// %d words, %d nodes, %d edges: %d bytes of flash\n\n" % (len(words), len(nodes), len(edges), flash)
+    text += "const uint32_t DawgTotal = %d;\n\n" % len(words)
+    text += array("uint32_t", "DawgEdges", edges, 6, "0x%08X") + "\n"
+    text += array("DawgTally", "DawgCounts", counts, 12, "%d") + "\n"
+    text += array("uint32_t", "DawgLengths", lengths, 17, "%d")
+    return text, flash
+
+
+def write(directory, name, text, flash):
+    target = os.path.join(directory, name)
+    old = None
+    if os.path.exists(target):
+        with open(target) as f:
+            old = f.read()
+    if text != old:
+        with open(target, "w") as f:
+            f.write(text)
+    if flash:
+        print("dictionary: %s, %d bytes of flash" % (os.path.relpath(target), flash))
+
+
+def build(root):
+    words = read_words(os.path.join(root, "src", "words.txt"))
+    directory = os.path.join(root, "lib", "Dictionary")
+    write(directory, "dictionary_words.h", *generate_sizes(words))
+    write(directory, "dictionary_words.c", *generate(words))
+    write(directory, "dictionary_dawg.c", *generate_dawg(words))
+
+
+def build_elsewhere(root, count, directory):
+    # The tables of count made-up words, without the sizes header: the build defines DICT_WORDS
+    # and DICT_SETS itself, and the tables are linked instead of the ones in lib/Dictionary.
+    # The words only depend on count, so tables that are already there are kept unless this
+    # script changed since: placing 100000 words with the perfect hash takes about a minute
+    source = "%d made-up words" % count
+    made = os.path.join(directory, "dictionary_dawg.c")
+    script = os.path.join(root, "tools", "dictionary.py")
+    if (not os.path.exists(made) or source not in open(made).readline()
+            or os.path.getmtime(made) < os.path.getmtime(script)):
+        words = synthetic_words(count)
+        os.makedirs(directory, exist_ok=True)
+        write(directory, "dictionary_words.c", *generate(words, source))
+        write(directory, "dictionary_dawg.c", *generate_dawg(words, source))
+        os.utime(made)  # Made now, even if it came out the same
+    return [("DICT_WORDS", count), ("DICT_SETS", (count + 31) // 32)]
+
+
+try:
+    Import("env")  # noqa: F821, only defined when PlatformIO runs the script
+    count = env.GetProjectOption("custom_dictionary_words", "")  # noqa: F821
+    if count:
+        directory = os.path.join(env.subst("$BUILD_DIR"), "dictionary")  # noqa: F821
+        env.Append(CPPDEFINES=build_elsewhere(env["PROJECT_DIR"], int(count), directory))  # noqa: F821
+        env.BuildSources(os.path.join("$BUILD_DIR", "dictionary_objects"), directory)  # noqa: F821
+    else:
+        build(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    if len(sys.argv) == 3:
+        build_elsewhere(root, int(sys.argv[1]), sys.argv[2])
+    else:
+        build(root)